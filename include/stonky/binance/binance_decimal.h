@@ -0,0 +1,242 @@
+/**
+Binance Fixed-Point Decimal
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_DECIMAL_H
+#define INCLUDE_STONKY_BINANCE_DECIMAL_H
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace stonky::binance {
+/**
+ * Exact decimal number stored as 64-bit integer scaled by 10^scale, e.g. 37012.45 with scale 2 is 3701245.
+ * Intended for prices and quantities, the scale is usually Symbol::pricePrecision or Symbol::quantityPrecision.
+ * Arithmetic and comparisons of mixed scales align the operands to the bigger scale, the result has to fit
+ * into int64, which leaves 10 integer digits with scale 8. Overflows throw std::out_of_range.
+ */
+class Decimal final {
+public:
+    static constexpr std::int32_t MAX_SCALE = 18;
+
+    /// Decimal places of prices, quantities and filter steps sent by Binance
+    static constexpr std::int32_t BINANCE_SCALE = 8;
+
+    /// 10^scale indexed by scale
+    static constexpr std::array<std::int64_t, MAX_SCALE + 1> POW10{
+        1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL,
+        10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL, 100000000000000LL,
+        1000000000000000LL, 10000000000000000LL, 100000000000000000LL, 1000000000000000000LL};
+
+private:
+    std::int64_t m_value{0};
+    std::int32_t m_scale{0};
+
+    /**
+     * @throws std::out_of_range if the product does not fit into int64
+     */
+    static constexpr std::int64_t multiplyChecked(const std::int64_t a, const std::int64_t b) {
+#if defined(__GNUC__) || defined(__clang__)
+        if (std::int64_t retVal = 0; !__builtin_mul_overflow(a, b, &retVal)) {
+            return retVal;
+        }
+#else
+        constexpr auto max = std::numeric_limits<std::int64_t>::max();
+        constexpr auto min = std::numeric_limits<std::int64_t>::min();
+
+        if (!(a > 0 ? (b > 0 ? a > max / b : b < min / a) : (b > 0 ? a < min / b : a != 0 && b < max / a))) {
+            return a * b;
+        }
+#endif
+        throw std::out_of_range("Decimal overflow");
+    }
+
+    /**
+     * @throws std::out_of_range if the sum does not fit into int64
+     */
+    static constexpr std::int64_t addChecked(const std::int64_t a, const std::int64_t b) {
+#if defined(__GNUC__) || defined(__clang__)
+        if (std::int64_t retVal = 0; !__builtin_add_overflow(a, b, &retVal)) {
+            return retVal;
+        }
+#else
+        if (b > 0 ? a <= std::numeric_limits<std::int64_t>::max() - b
+                  : a >= std::numeric_limits<std::int64_t>::min() - b) {
+            return a + b;
+        }
+#endif
+        throw std::out_of_range("Decimal overflow");
+    }
+
+    /**
+     * @throws std::out_of_range if the difference does not fit into int64
+     */
+    static constexpr std::int64_t subtractChecked(const std::int64_t a, const std::int64_t b) {
+#if defined(__GNUC__) || defined(__clang__)
+        if (std::int64_t retVal = 0; !__builtin_sub_overflow(a, b, &retVal)) {
+            return retVal;
+        }
+#else
+        if (b < 0 ? a <= std::numeric_limits<std::int64_t>::max() + b
+                  : a >= std::numeric_limits<std::int64_t>::min() + b) {
+            return a - b;
+        }
+#endif
+        throw std::out_of_range("Decimal overflow");
+    }
+
+    /**
+     * @param scale not lower than scale()
+     * @throws std::out_of_range if the scale is out of range or the value does not fit into it
+     */
+    [[nodiscard]] constexpr std::int64_t valueAt(const std::int32_t scale) const {
+        if (scale == m_scale) {
+            return m_value;
+        }
+
+        if (scale < m_scale || scale > MAX_SCALE) {
+            throw std::out_of_range("Decimal scale out of range");
+        }
+
+        return multiplyChecked(m_value, POW10[scale - m_scale]);
+    }
+
+public:
+    constexpr Decimal() = default;
+
+    /**
+     * @param value scaled value, e.g. 3701245
+     * @param scale number of decimal places, e.g. 2, has to be 0 - MAX_SCALE
+     * @throws std::invalid_argument if the scale is out of range
+     */
+    constexpr Decimal(const std::int64_t value, const std::int32_t scale) : m_value(value), m_scale(scale) {
+        if (scale < 0 || scale > MAX_SCALE) {
+            throw std::invalid_argument("Decimal scale out of range");
+        }
+    }
+
+    /**
+     * Parse decimal string as Binance sends it, digits behind the scale are rounded half away from zero
+     * @param str e.g. -37012.45000000, exponent notation is not supported
+     * @param scale number of decimal places of the result
+     * @return parsed number
+     * @throws std::invalid_argument if str is not a decimal number or the scale is out of range
+     * @throws std::out_of_range if the number does not fit into the scale
+     */
+    static Decimal fromString(std::string_view str, std::int32_t scale);
+
+    /**
+     * Parse decimal string keeping all its decimal places, e.g. 0.00100 has scale 5
+     * @throws std::invalid_argument, std::out_of_range
+     */
+    static Decimal fromString(std::string_view str);
+
+    /**
+     * Convert double rounded half away from zero to the scale, bridge for the double-based models
+     * @throws std::invalid_argument if the scale is out of range
+     * @throws std::out_of_range if the number does not fit into the scale
+     */
+    static Decimal fromDouble(double value, std::int32_t scale);
+
+    [[nodiscard]] constexpr std::int64_t value() const {
+        return m_value;
+    }
+
+    [[nodiscard]] constexpr std::int32_t scale() const {
+        return m_scale;
+    }
+
+    [[nodiscard]] double toDouble() const;
+
+    /**
+     * @return number with exactly scale() decimal places, e.g. 37012.45, no float formatting involved
+     */
+    [[nodiscard]] std::string toString() const;
+
+    /**
+     * Append toString() representation without a temporary string, e.g. when building a query
+     */
+    void appendTo(std::string &out) const;
+
+    /**
+     * Change the scale, dropped decimal places are rounded half away from zero
+     * @throws std::invalid_argument if the scale is out of range
+     */
+    [[nodiscard]] Decimal rescale(std::int32_t scale) const;
+
+    /**
+     * Round towards zero to a multiple of step, e.g. quantity to Filter::stepSize
+     * @param step positive step
+     * @throws std::invalid_argument if the step is not positive
+     */
+    [[nodiscard]] Decimal truncateToStep(const Decimal &step) const;
+
+    /**
+     * Round half away from zero to a multiple of step, e.g. price to Filter::tickSize
+     * @param step positive step
+     * @throws std::invalid_argument if the step is not positive
+     */
+    [[nodiscard]] Decimal roundToStep(const Decimal &step) const;
+
+    [[nodiscard]] constexpr Decimal operator-() const {
+        return {subtractChecked(0, m_value), m_scale};
+    }
+
+    [[nodiscard]] constexpr Decimal operator+(const Decimal &other) const {
+        const auto scale = std::max(m_scale, other.m_scale);
+        return {addChecked(valueAt(scale), other.valueAt(scale)), scale};
+    }
+
+    [[nodiscard]] constexpr Decimal operator-(const Decimal &other) const {
+        const auto scale = std::max(m_scale, other.m_scale);
+        return {subtractChecked(valueAt(scale), other.valueAt(scale)), scale};
+    }
+
+    /**
+     * Product has the sum of scales, e.g. price * quantity gives exact notional. A sum above MAX_SCALE is capped,
+     * dropped decimal places are rounded half away from zero.
+     * @throws std::out_of_range if the product does not fit into int64, without 128-bit integers (MSVC) also if the
+     * product before the rounding does not fit
+     */
+    [[nodiscard]] Decimal operator*(const Decimal &other) const;
+
+    /**
+     * @throws std::out_of_range if the product does not fit into int64
+     */
+    [[nodiscard]] constexpr Decimal operator*(const std::int64_t multiplier) const {
+        return {multiplyChecked(m_value, multiplier), m_scale};
+    }
+
+    constexpr Decimal &operator+=(const Decimal &other) {
+        return *this = *this + other;
+    }
+
+    constexpr Decimal &operator-=(const Decimal &other) {
+        return *this = *this - other;
+    }
+
+    /**
+     * Numeric equality, 1.50 equals 1.5
+     */
+    [[nodiscard]] constexpr bool operator==(const Decimal &other) const {
+        const auto scale = std::max(m_scale, other.m_scale);
+        return valueAt(scale) == other.valueAt(scale);
+    }
+
+    [[nodiscard]] constexpr std::strong_ordering operator<=>(const Decimal &other) const {
+        const auto scale = std::max(m_scale, other.m_scale);
+        return valueAt(scale) <=> other.valueAt(scale);
+    }
+};
+}
+#endif //INCLUDE_STONKY_BINANCE_DECIMAL_H
@@ -0,0 +1,69 @@
+/**
+Binance Enum Parser
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_ENUM_PARSER_H
+#define INCLUDE_STONKY_BINANCE_ENUM_PARSER_H
+
+#include "binance_perfect_hash.h"
+#include "stonky/utils/magic_enum_wrapper.hpp"
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string_view>
+
+namespace stonky::binance {
+/**
+ * Name to value table of an enum generated at compile time from magic_enum names.
+ * Lookup is one hash and one string compare, magic_enum::enum_cast compares the name with all enum names.
+ */
+template<typename T> requires std::is_enum_v<T>
+class EnumIndex {
+    static constexpr auto NAMES = magic_enum::enum_names<T>();
+    static constexpr auto VALUES = magic_enum::enum_values<T>();
+    static constexpr PerfectHashIndex<NAMES.size()> INDEX{NAMES};
+
+public:
+    /**
+     * @param name case-sensitive enum name, e.g. TRAILING_STOP_MARKET
+     * @return enum value, nullopt if the name is unknown
+     */
+    static constexpr std::optional<T> find(const std::string_view name) {
+        if (const auto index = INDEX.find(name); index < NAMES.size()) {
+            return VALUES[index];
+        }
+
+        return std::nullopt;
+    }
+};
+
+/**
+ * Counterpart of magic_enum::enum_cast(name) through the EnumIndex perfect hash
+ * @param name case-sensitive enum name
+ * @return enum value, nullopt if the name is unknown
+ */
+template<typename T> requires std::is_enum_v<T>
+constexpr std::optional<T> parseEnum(const std::string_view name) {
+    return EnumIndex<T>::find(name);
+}
+
+/**
+ * Counterpart of readMagicEnum(), the value is unchanged when the field is missing, null or an unknown name
+ * @param json JSON object
+ * @param key field name
+ * @param value read value
+ * @throws nlohmann::json::exception if the field is not a string
+ */
+template<typename T> requires std::is_enum_v<T>
+void readEnum(const nlohmann::json &json, const std::string_view key, T &value) {
+    if (const auto it = json.find(key); it != json.end() && !it->is_null()) {
+        if (const auto enumValue = parseEnum<T>(it->template get_ref<const std::string &>()); enumValue.has_value()) {
+            value = enumValue.value();
+        }
+    }
+}
+}
+#endif //INCLUDE_STONKY_BINANCE_ENUM_PARSER_H
@@ -12,6 +12,8 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 #include "stonky/interface/i_json.h"
 #include "binance_models.h"
 #include <nlohmann/json.hpp>
+#include <array>
+#include <functional>
 #include <variant>
 
 namespace stonky::binance::futures {
@@ -27,7 +29,10 @@ enum class EventType : std::int32_t {
     listenKeyExpired,
     bookTicker,
     aggTrade,
-    kline
+    kline,
+    depthUpdate,
+    markPriceUpdate,
+    _24hrMiniTicker /// 24hrMiniTicker, the name cannot start with a digit
 };
 
 struct Event : IJson {
@@ -59,13 +64,99 @@ struct EventTickPrice final : Event {
     void fromJson(const nlohmann::json &json) override;
 };
 
+/**
+ * Balance change of one asset, pushed within ACCOUNT_UPDATE. Event type and time are those of the ACCOUNT_UPDATE.
+ */
+struct EventBalanceUpdate final : Event {
+    std::string a{}; /// Asset
+    double wb{}; /// Wallet Balance
+    double cw{}; /// Cross Wallet Balance
+    double bc{}; /// Balance Change except PnL and Commission
+
+    EventBalanceUpdate() {
+        e = EventType::ACCOUNT_UPDATE;
+    }
+
+    [[nodiscard]] nlohmann::json toJson() const override;
+
+    void fromJson(const nlohmann::json &json) override;
+};
+
 struct EventAccountUpdate final : Event {
+    /**
+     * Position change of one symbol and side
+     */
+    struct Position final : IJson {
+        std::string s{}; /// Symbol
+        double pa{}; /// Position Amount
+        double ep{}; /// Entry Price
+        double bep{}; /// Breakeven Price
+        double cr{}; /// (Pre-fee) Accumulated Realized
+        double up{}; /// Unrealized PnL
+        std::string mt{}; /// Margin Type, isolated or cross
+        double iw{}; /// Isolated Wallet (if isolated position)
+        PositionSide ps{PositionSide::BOTH}; /// Position Side
+
+        [[nodiscard]] nlohmann::json toJson() const override;
+
+        void fromJson(const nlohmann::json &json) override;
+    };
+
+    std::int64_t T{}; /// Transaction Time
+    std::string m{}; /// Event reason type e.g. ORDER, FUNDING_FEE, DEPOSIT
+    std::vector<EventBalanceUpdate> B{}; /// Changed balances
+    std::vector<Position> P{}; /// Changed positions, only symbols of the event reason are pushed for FUNDING_FEE
+
+    EventAccountUpdate() {
+        e = EventType::ACCOUNT_UPDATE;
+    }
+
     [[nodiscard]] nlohmann::json toJson() const override;
 
     void fromJson(const nlohmann::json &json) override;
 };
 
-struct EventBalanceUpdate final : Event {
+struct EventMarginCall final : Event {
+    struct Position final : IJson {
+        std::string s{}; /// Symbol
+        PositionSide ps{PositionSide::BOTH}; /// Position Side
+        double pa{}; /// Position Amount
+        std::string mt{}; /// Margin Type, CROSSED or ISOLATED
+        double iw{}; /// Isolated Wallet (if isolated position)
+        double mp{}; /// Mark Price
+        double up{}; /// Unrealized PnL
+        double mm{}; /// Maintenance Margin Required
+
+        [[nodiscard]] nlohmann::json toJson() const override;
+
+        void fromJson(const nlohmann::json &json) override;
+    };
+
+    double cw{}; /// Cross Wallet Balance, only pushed with crossed position margin call
+    std::vector<Position> p{}; /// Positions at risk
+
+    EventMarginCall() {
+        e = EventType::MARGIN_CALL;
+    }
+
+    [[nodiscard]] nlohmann::json toJson() const override;
+
+    void fromJson(const nlohmann::json &json) override;
+};
+
+/**
+ * Change of the symbol leverage or of the Multi-Assets Mode
+ */
+struct EventAccountConfigUpdate final : Event {
+    std::int64_t T{}; /// Transaction Time
+    std::string s{}; /// Symbol, empty if the Multi-Assets Mode was changed
+    int l{}; /// Leverage
+    bool j{false}; /// Multi-Assets Mode
+
+    EventAccountConfigUpdate() {
+        e = EventType::ACCOUNT_CONFIG_UPDATE;
+    }
+
     [[nodiscard]] nlohmann::json toJson() const override;
 
     void fromJson(const nlohmann::json &json) override;
@@ -106,8 +197,13 @@ struct EventOrderUpdate final : Event {
     void fromJson(const nlohmann::json &json) override;
 };
 
+/**
+ * Event of the User Data Stream. Event is held for listenKeyExpired and unknown events, EventBalanceUpdate is not
+ * pushed on its own - balances come within EventAccountUpdate.
+ */
 struct EventUserData final : IJson {
-    std::variant<EventAccountUpdate, EventBalanceUpdate, EventOrderUpdate, Event> eventData;
+    std::variant<EventAccountUpdate, EventBalanceUpdate, EventOrderUpdate, Event, EventMarginCall,
+        EventAccountConfigUpdate> eventData;
 
     [[nodiscard]] nlohmann::json toJson() const override;
 
@@ -160,5 +256,109 @@ struct EventCandlestick final : Event {
 
     void fromJson(const nlohmann::json &json) override;
 };
+
+/**
+ * Diff. Book Depth Stream event. Quantities are absolute, zero quantity removes the level.
+ */
+struct EventDepthUpdate final : Event {
+    std::int64_t T{}; /// transaction time
+    std::string s{}; /// symbol
+    std::int64_t U{}; /// first update id in event
+    std::int64_t u{}; /// final update id in event
+    std::int64_t pu{}; /// final update id in the previous event of the stream
+    std::vector<OrderBookLevel> b{}; /// bids to be updated
+    std::vector<OrderBookLevel> a{}; /// asks to be updated
+
+    EventDepthUpdate() {
+        e = EventType::depthUpdate;
+    }
+
+    [[nodiscard]] nlohmann::json toJson() const override;
+
+    void fromJson(const nlohmann::json &json) override;
+};
+
+/**
+ * Partial Book Depth Stream event. Levels are stored inline, bids and asks are ordered from the best price and only
+ * the first bidCount and askCount levels are valid.
+ */
+struct EventDepth final : Event {
+    static constexpr std::size_t MAX_LEVELS = 20;
+
+    std::int64_t T{}; /// transaction time
+    std::string s{}; /// symbol
+    std::int64_t U{}; /// first update id in event
+    std::int64_t u{}; /// final update id in event
+    std::int64_t pu{}; /// final update id in the previous event of the stream
+    std::array<OrderBookLevel, MAX_LEVELS> b{}; /// bids
+    std::array<OrderBookLevel, MAX_LEVELS> a{}; /// asks
+    std::size_t bidCount{};
+    std::size_t askCount{};
+
+    EventDepth() {
+        e = EventType::depthUpdate;
+    }
+
+    [[nodiscard]] nlohmann::json toJson() const override;
+
+    void fromJson(const nlohmann::json &json) override;
+};
+
+/**
+ * Mark Price Stream event, also an element of the All Market Mark Price Stream
+ */
+struct EventMarkPrice final : Event {
+    std::string s{}; /// symbol
+    double p{}; /// mark price
+    double i{}; /// index price
+    double P{}; /// estimated settle price, only useful in the last hour before the settlement starts
+    double r{}; /// funding rate
+    std::int64_t T{}; /// next funding time
+
+    EventMarkPrice() {
+        e = EventType::markPriceUpdate;
+    }
+
+    [[nodiscard]] nlohmann::json toJson() const override;
+
+    void fromJson(const nlohmann::json &json) override;
+};
+
+/**
+ * Individual Symbol Mini Ticker Stream event, also an element of the All Market Mini Tickers Stream. Statistics are
+ * of the rolling 24 hours window.
+ */
+struct EventMiniTicker final : Event {
+    std::string s{}; /// symbol
+    double c{}; /// close price
+    double o{}; /// open price
+    double h{}; /// high price
+    double l{}; /// low price
+    double v{}; /// total traded base asset volume
+    double q{}; /// total traded quote asset volume
+
+    EventMiniTicker() {
+        e = EventType::_24hrMiniTicker;
+    }
+
+    [[nodiscard]] nlohmann::json toJson() const override;
+
+    void fromJson(const nlohmann::json &json) override;
+};
+
+/**
+ * Interruption of a stream reported when its connection is restored, not part of Binance API
+ */
+struct EventStreamGap final {
+    std::string stream{}; /// Stream name e.g. btcusdt@bookTicker
+    std::int64_t disconnectTime{}; /// Time of the connection failure in ms
+    std::int64_t reconnectTime{}; /// Time of the restored connection in ms
+    std::int64_t lastUpdateId{-1}; /// Last update id received before the failure, -1 if unknown
+    std::int64_t firstUpdateId{-1}; /// First update id received after the reconnect, -1 if unknown
+};
+
+using onStreamGap = std::function<void(const EventStreamGap &gap)>;
+
+using onUserData = std::function<void(const EventUserData &event)>;
 }
 #endif //INCLUDE_STONKY_BINANCE_EVENT_MODELS_H
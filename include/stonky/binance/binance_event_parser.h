@@ -0,0 +1,125 @@
+/**
+Binance WebSocket Event Parser
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_EVENT_PARSER_H
+#define INCLUDE_STONKY_BINANCE_EVENT_PARSER_H
+
+#include "binance_event_models.h"
+#include "binance_json_parser.h"
+#include "binance_pod_events.h"
+#include <functional>
+#include <string_view>
+
+/**
+ * Parsers reading WebSocket frames straight into the event structures, without building JSON DOM. Unknown fields are
+ * skipped, missing fields keep their previous value. Nothing is allocated as long as strings fit into the std::string
+ * small buffer or into the capacity left by the previous frame - reuse one event structure for the whole stream.
+ * Escape sequences in strings are not decoded, Binance does not use them in the event fields.
+ */
+namespace stonky::binance::futures {
+/**
+ * Parse bookTicker stream frame
+ * @param frame WebSocket frame payload
+ * @param event filled structure
+ * @throws JsonParseError
+ */
+void parseEvent(std::string_view frame, EventTickPrice &event);
+
+/**
+ * Parse kline stream frame
+ * @param frame WebSocket frame payload
+ * @param event filled structure
+ * @throws JsonParseError
+ */
+void parseEvent(std::string_view frame, EventCandlestick &event);
+
+/**
+ * Parse aggTrade stream frame
+ * @param frame WebSocket frame payload
+ * @param event filled structure
+ * @throws JsonParseError
+ */
+void parseEvent(std::string_view frame, EventAggregatedTrade &event);
+
+/**
+ * Parse Diff. Book Depth Stream frame, levels reuse the capacity of the previous frame
+ * @param frame WebSocket frame payload
+ * @param event filled structure
+ * @throws JsonParseError
+ */
+void parseEvent(std::string_view frame, EventDepthUpdate &event);
+
+/**
+ * Parse Partial Book Depth Stream frame, nothing is allocated as long as the symbol fits into the std::string small
+ * buffer. Levels behind EventDepth::MAX_LEVELS are skipped.
+ * @param frame WebSocket frame payload
+ * @param event filled structure
+ * @throws JsonParseError
+ */
+void parseEvent(std::string_view frame, EventDepth &event);
+
+/**
+ * Parse markPrice stream frame
+ * @param frame WebSocket frame payload
+ * @param event filled structure
+ * @throws JsonParseError
+ */
+void parseEvent(std::string_view frame, EventMarkPrice &event);
+
+/**
+ * Parse miniTicker stream frame
+ * @param frame WebSocket frame payload
+ * @param event filled structure
+ * @throws JsonParseError
+ */
+void parseEvent(std::string_view frame, EventMiniTicker &event);
+
+/**
+ * Parse All Market Mark Price Stream frame, an array of the events of all symbols
+ * @param frame WebSocket frame payload
+ * @param event refilled by every element of the array
+ * @param cb called with every element
+ * @throws JsonParseError, elements before the malformed one are already passed to the callback
+ */
+void parseEvents(std::string_view frame, EventMarkPrice &event, const std::function<void(const EventMarkPrice &)> &cb);
+
+/**
+ * Parse All Market Mini Tickers Stream frame, an array of the events of the symbols changed since the previous frame
+ * @param frame WebSocket frame payload
+ * @param event refilled by every element of the array
+ * @param cb called with every element
+ * @throws JsonParseError, elements before the malformed one are already passed to the callback
+ */
+void parseEvents(std::string_view frame, EventMiniTicker &event,
+                 const std::function<void(const EventMiniTicker &)> &cb);
+
+/**
+ * Parse bookTicker stream frame into the compact event, nothing is allocated
+ * @param frame WebSocket frame payload
+ * @param event filled structure
+ * @throws JsonParseError, also if the symbol is longer than FixedSymbol::CAPACITY
+ */
+void parseEvent(std::string_view frame, PodEventTickPrice &event);
+
+/**
+ * Parse kline stream frame into the compact event, nothing is allocated
+ * @param frame WebSocket frame payload
+ * @param event filled structure
+ * @throws JsonParseError, also if the symbol is longer than FixedSymbol::CAPACITY
+ */
+void parseEvent(std::string_view frame, PodEventCandlestick &event);
+
+/**
+ * Parse aggTrade stream frame into the compact event, nothing is allocated
+ * @param frame WebSocket frame payload
+ * @param event filled structure
+ * @throws JsonParseError, also if the symbol is longer than FixedSymbol::CAPACITY
+ */
+void parseEvent(std::string_view frame, PodEventAggregatedTrade &event);
+}
+#endif //INCLUDE_STONKY_BINANCE_EVENT_PARSER_H
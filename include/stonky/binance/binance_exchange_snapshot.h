@@ -0,0 +1,65 @@
+/**
+Binance Futures Exchange Info Snapshot
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_EXCHANGE_SNAPSHOT_H
+#define INCLUDE_STONKY_BINANCE_EXCHANGE_SNAPSHOT_H
+
+#include "binance_lazy_exchange.h"
+#include "binance_models.h"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace stonky::binance::futures {
+/// Layout version of the snapshot, increment on every change of serialised fields
+static constexpr std::uint32_t EXCHANGE_SNAPSHOT_VERSION = 3;
+
+/**
+ * Exchange info stored in the snapshot
+ */
+struct ExchangeSnapshot {
+    std::shared_ptr<const LazyExchange> exchange{};
+    /// Time of the Exchange info download in s
+    std::int64_t lastUpdateTime{-1};
+};
+
+/**
+ * Serialise Exchange info into the binary snapshot. Exchange info downloaded as exchangeInfo response is stored as
+ * the raw response, so neither saving nor loading decodes it. Decoded Exchange is stored field by field, numbers in
+ * the native byte order - the snapshot serves as a local cache and is not portable between architectures.
+ * @param snapshot exchange info and its update time
+ * @return snapshot data
+ */
+std::string serializeExchange(const ExchangeSnapshot &snapshot);
+
+/**
+ * @param data snapshot data
+ * @return exchange info and its update time, a stored response is only indexed
+ * @throws std::runtime_error if the data are not a snapshot of EXCHANGE_SNAPSHOT_VERSION or are truncated,
+ * JsonParseError if the stored response is corrupted
+ */
+ExchangeSnapshot deserializeExchange(std::string_view data);
+
+/**
+ * Write the snapshot to a temporary file and rename it over path, so readers never see a partially written snapshot
+ * @param snapshot exchange info and its update time
+ * @param path snapshot file, parent directories are created if they do not exist
+ * @throws std::runtime_error, std::filesystem::filesystem_error
+ */
+void saveExchangeSnapshot(const ExchangeSnapshot &snapshot, const std::filesystem::path &path);
+
+/**
+ * @param path snapshot file
+ * @return exchange info, nullopt if the file does not exist, is corrupted or was written by a different version
+ */
+std::optional<ExchangeSnapshot> loadExchangeSnapshot(const std::filesystem::path &path);
+}
+#endif //INCLUDE_STONKY_BINANCE_EXCHANGE_SNAPSHOT_H
@@ -0,0 +1,305 @@
+/**
+Binance JSON Frame Reader
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_FRAME_READER_H
+#define INCLUDE_STONKY_BINANCE_FRAME_READER_H
+
+#include "binance_enum_parser.h"
+#include "binance_json_parser.h"
+#include "binance_pod_events.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <string>
+#include <string_view>
+
+namespace stonky::binance::futures {
+/**
+ * Forward-only reader of a JSON frame. Read methods expect the value at the current position and move behind it.
+ */
+class FrameReader {
+    const char *m_begin;
+    const char *m_pos;
+    const char *m_end;
+
+    [[noreturn]] void fail(const std::string_view what) const {
+        throw JsonParseError(
+            "Invalid JSON frame, " + std::string(what) + " at offset " + std::to_string(m_pos - m_begin));
+    }
+
+    void skipWhitespace() {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\r' || *m_pos == '\n')) {
+            ++m_pos;
+        }
+    }
+
+    char peek() {
+        skipWhitespace();
+
+        if (m_pos == m_end) {
+            fail("unexpected end");
+        }
+
+        return *m_pos;
+    }
+
+    bool consume(const char c) {
+        if (peek() == c) {
+            ++m_pos;
+            return true;
+        }
+
+        return false;
+    }
+
+    void expect(const char c) {
+        if (!consume(c)) {
+            fail(std::string("expected '") + c + '\'');
+        }
+    }
+
+    /**
+     * Number or literal (true, false, null)
+     */
+    std::string_view readToken() {
+        skipWhitespace();
+        const auto *start = m_pos;
+
+        while (m_pos < m_end && *m_pos != ',' && *m_pos != '}' && *m_pos != ']' && *m_pos != ' ' && *m_pos != '\t'
+               && *m_pos != '\r' && *m_pos != '\n') {
+            ++m_pos;
+        }
+
+        if (start == m_pos) {
+            fail("expected value");
+        }
+
+        return {start, static_cast<std::size_t>(m_pos - start)};
+    }
+
+    /**
+     * @return true if the whole token is an integer
+     */
+    static bool parseInteger(const std::string_view token, std::int64_t &value) {
+        const auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+        return ec == std::errc() && ptr == token.data() + token.size();
+    }
+
+    /**
+     * @return true if the value is null, the null is consumed
+     */
+    bool consumeNull() {
+        if (peek() != 'n') {
+            return false;
+        }
+
+        if (readToken() != "null") {
+            fail("invalid literal");
+        }
+
+        return true;
+    }
+
+public:
+    explicit FrameReader(const std::string_view frame) : m_begin(frame.data()), m_pos(frame.data()),
+                                                         m_end(frame.data() + frame.size()) {
+    }
+
+    /**
+     * Read the object, onField is called with every key and has to read or skip its value
+     */
+    template<typename Fn>
+    void readObject(Fn &&onField) {
+        expect('{');
+
+        if (consume('}')) {
+            return;
+        }
+
+        do {
+            const auto key = readString();
+            expect(':');
+            onField(key);
+        } while (consume(','));
+
+        expect('}');
+    }
+
+    /**
+     * Read the array, onElement is called for every element and has to read or skip it
+     */
+    template<typename Fn>
+    void readArray(Fn &&onElement) {
+        expect('[');
+
+        if (consume(']')) {
+            return;
+        }
+
+        do {
+            onElement();
+        } while (consume(','));
+
+        expect(']');
+    }
+
+    /**
+     * Skip the value
+     * @return the whole value as it is in the frame
+     */
+    std::string_view readRaw() {
+        skipWhitespace();
+        const auto *start = m_pos;
+        skipValue();
+        return {start, static_cast<std::size_t>(m_pos - start)};
+    }
+    /**
+     * @return content between quotes, escape sequences are kept as they are
+     */
+    std::string_view readString() {
+        expect('"');
+        const auto *start = m_pos;
+
+        while (m_pos < m_end && *m_pos != '"') {
+            m_pos += *m_pos == '\\' ? 2 : 1;
+        }
+
+        if (m_pos >= m_end) {
+            fail("unterminated string");
+        }
+
+        return {start, static_cast<std::size_t>(m_pos++ - start)};
+    }
+
+    void skipValue() {
+        switch (peek()) {
+            case '"':
+                readString();
+                break;
+            case '{':
+            case '[': {
+                std::size_t depth = 0;
+
+                do {
+                    if (*m_pos == '"') {
+                        readString();
+                        continue;
+                    }
+
+                    if (*m_pos == '{' || *m_pos == '[') {
+                        depth++;
+                    } else if (*m_pos == '}' || *m_pos == ']') {
+                        depth--;
+                    }
+
+                    ++m_pos;
+                } while (depth > 0 && m_pos < m_end);
+
+                if (depth > 0) {
+                    fail("unterminated value");
+                }
+                break;
+            }
+            default:
+                readToken();
+                break;
+        }
+    }
+
+    void read(std::string &value) {
+        if (!consumeNull()) {
+            value.assign(readString());
+        }
+    }
+
+    void read(FixedSymbol &value) {
+        if (consumeNull()) {
+            return;
+        }
+
+        const auto symbol = readString();
+
+        if (symbol.size() > FixedSymbol::CAPACITY) {
+            fail("symbol too long");
+        }
+
+        value.chars.fill('\0');
+        std::ranges::copy(symbol, value.chars.begin());
+    }
+
+    void read(bool &value) {
+        if (consumeNull()) {
+            return;
+        }
+
+        if (const auto token = readToken(); token == "true") {
+            value = true;
+        } else if (token == "false") {
+            value = false;
+        } else {
+            fail("expected boolean");
+        }
+    }
+
+    void read(std::int64_t &value) {
+        if (consumeNull()) {
+            return;
+        }
+
+        if (const auto token = readToken(); !parseInteger(token, value)) {
+            fail("expected integer");
+        }
+    }
+
+    /**
+     * Binance sends decimals as strings, plain numbers are accepted too
+     */
+    void read(double &value) {
+        if (consumeNull()) {
+            return;
+        }
+
+        const auto token = peek() == '"' ? readString() : readToken();
+
+        if (!token.empty() && !parseDouble(token, value)) {
+            fail("expected decimal");
+        }
+    }
+
+    template<typename T> requires std::is_enum_v<T>
+    void read(T &value) {
+        if (consumeNull()) {
+            return;
+        }
+
+        if (const auto enumValue = parseEnum<T>(readString()); enumValue.has_value()) {
+            value = enumValue.value();
+        }
+    }
+
+    /**
+     * Interval is sent without the leading underscore of CandleInterval names, e.g. 1m
+     */
+    void read(CandleInterval &value) {
+        const auto interval = readString();
+        std::array<char, 8> name{'_'};
+
+        if (interval.size() >= name.size()) {
+            fail("invalid interval");
+        }
+
+        std::ranges::copy(interval, name.begin() + 1);
+
+        if (const auto enumValue = parseEnum<CandleInterval>(std::string_view(name.data(), interval.size() + 1));
+            enumValue.has_value()) {
+            value = enumValue.value();
+        }
+    }
+};
+}
+#endif //INCLUDE_STONKY_BINANCE_FRAME_READER_H
@@ -0,0 +1,81 @@
+/**
+Binance Futures Funding Rate Store
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_FUNDING_RATE_STORE_H
+#define INCLUDE_STONKY_BINANCE_FUNDING_RATE_STORE_H
+
+#include "binance_models.h"
+#include <filesystem>
+#include <memory>
+
+namespace stonky::binance::futures {
+class RESTClient;
+
+/**
+ * Funding rate history of multiple symbols kept in memory and persisted to disk, one CSV file per symbol and a small
+ * CSV file with the covered time range of the symbol. Records of every symbol are ordered by fundingTime.
+ */
+class FundingRateStore {
+    struct P;
+    std::unique_ptr<P> m_p{};
+
+public:
+    /**
+     * @param restClient client used for downloading missing records
+     * @param directory directory where the symbol files are stored, created if it does not exist
+     */
+    FundingRateStore(const std::weak_ptr<RESTClient> &restClient, const std::filesystem::path &directory);
+
+    ~FundingRateStore();
+
+    /**
+     * Bring the history of given symbols up to date. Symbols are processed in parallel on a bounded number of
+     * threads. Stored symbols are refreshed incrementally - only records newer than the last stored fundingTime are
+     * requested, older records are requested only when startTime precedes the stored history.
+     * @param symbols e.g. BTCUSDT, ETHUSDT
+     * @param startTime timestamp in ms of the oldest required record
+     * @param maxParallelRequests maximal number of symbols downloaded at the same time
+     * @return error record for every symbol that failed
+     */
+    std::vector<FetchError>
+    update(const std::vector<std::string> &symbols, std::int64_t startTime, std::size_t maxParallelRequests = 8) const;
+
+    /**
+     * Return stored funding rates, no request is sent
+     * @param symbol e.g. BTCUSDT
+     * @param startTime timestamp in ms INCLUSIVE
+     * @param endTime timestamp in ms INCLUSIVE
+     * @return vector of FundingRate structures ordered by fundingTime
+     */
+    [[nodiscard]] std::vector<FundingRate>
+    getFundingRates(const std::string &symbol, std::int64_t startTime, std::int64_t endTime) const;
+
+    /**
+     * Return the oldest timestamp the stored history of a symbol is complete from
+     * @param symbol e.g. BTCUSDT
+     * @return timestamp in ms, -1 if nothing is stored for the symbol
+     */
+    [[nodiscard]] std::int64_t coveredFrom(const std::string &symbol) const;
+
+    /**
+     * Return the newest timestamp the stored history of a symbol is complete to, i.e. time of its last update or
+     * fundingTime of the newest record loaded from disk
+     * @param symbol e.g. BTCUSDT
+     * @return timestamp in ms, -1 if nothing is stored for the symbol
+     */
+    [[nodiscard]] std::int64_t coveredUntil(const std::string &symbol) const;
+
+    /**
+     * Return fundingTime of the newest stored record
+     * @param symbol e.g. BTCUSDT
+     * @return timestamp in ms, -1 if nothing is stored for the symbol
+     */
+    [[nodiscard]] std::int64_t lastFundingTime(const std::string &symbol) const;
+};
+}
+#endif //INCLUDE_STONKY_BINANCE_FUNDING_RATE_STORE_H
@@ -12,6 +12,7 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 
 #include "stonky/interface/i_exchange_connector.h"
 #include "stonky/common/module_factory.h"
+#include <filesystem>
 #include <memory>
 #include "stonky/utils/magic_enum_wrapper.hpp"
 
@@ -21,8 +22,16 @@ class BinanceFuturesExchangeConnector final : public IExchangeConnector {
     std::unique_ptr<P> m_p{};
 
 public:
+    /**
+     * Funding rate history and Exchange snapshot are stored in the system temporary directory
+     */
     BinanceFuturesExchangeConnector();
 
+    /**
+     * @param dataDirectory directory where the funding rate history and Exchange snapshot are stored
+     */
+    explicit BinanceFuturesExchangeConnector(const std::filesystem::path &dataDirectory);
+
     ~BinanceFuturesExchangeConnector() override;
 
     [[nodiscard]] std::string exchangeId() const override;
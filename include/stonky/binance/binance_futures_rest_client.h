@@ -12,8 +12,13 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 #include <string>
 #include <memory>
 #include "binance_models.h"
+#include "binance_symbol_registry.h"
+#include <optional>
+#include <utility>
 
 namespace stonky::binance::futures {
+class LazyExchange;
+
 class RESTClient {
     struct P;
     std::unique_ptr<P> m_p{};
@@ -72,6 +77,20 @@ public:
      */
     [[nodiscard]] BookTickerPrice getBookTickerPrice(const std::string &symbol) const;
 
+    /**
+     * Returns Ticker prices for all symbols in a single request
+     * @return map of filled TickerPrice structures, map keys are symbols
+     * @throws nlohmann::json::exception, std::exception
+     */
+    [[nodiscard]] std::unordered_map<std::string, TickerPrice> getTickerPrices() const;
+
+    /**
+     * Returns Book Ticker prices for all symbols in a single request
+     * @return map of filled BookTickerPrice structures, map keys are symbols
+     * @throws nlohmann::json::exception, std::exception
+     */
+    [[nodiscard]] std::unordered_map<std::string, BookTickerPrice> getBookTickerPrices() const;
+
     /**
      * Returns Mark Price and Funding Rate for Binance futures symbols
      * @return vector of MarkPrice structure
@@ -201,6 +220,14 @@ public:
      */
     void updateExchangeInfo(bool force = false) const;
 
+    /**
+     * Get Exchange info without decoding it
+     * @param force Reload Exchange info if true
+     * @return cached Exchange info and the time of its update in s
+     * @throws nlohmann::json::exception, std::exception
+     */
+    [[nodiscard]] std::pair<std::shared_ptr<const LazyExchange>, std::int64_t> getLazyExchangeInfo(bool force = false) const;
+
     /**
      * Returns AccountBalance information
      * @return vector of filled AccountBalance structures
@@ -257,12 +284,14 @@ public:
      * @param startTime timestamp in ms, must be smaller then "endTime"
      * @param endTime timestamp in ms, must be greater then "startTime"
      * @param incomeType see IncomeType
+     * @param limit max number of records, default 100; max 1000, if set to -1 then it is ignored
+     * @param page page of the records matching the other parameters, starting at 1, if set to -1 then it is ignored
      * @return vector of filled Income structures
      * @throws nlohmann::json::exception, std::exception
      */
     [[nodiscard]] std::vector<Income>
     getIncome(const std::string &symbol = "", std::int64_t startTime = -1, std::int64_t endTime = -1,
-              IncomeType incomeType = IncomeType::ALL) const;
+              IncomeType incomeType = IncomeType::ALL, std::int32_t limit = -1, std::int32_t page = -1) const;
 
     /**
      * Download historical candles for multiple symbols at once using parallel execution
@@ -280,7 +309,7 @@ public:
 
     /**
      * Get Position risk
-     * @param symbol e.g. BTCUSDT
+     * @param symbol e.g. BTCUSDT, if empty then position risks of all symbols are returned.
      * @return vector of filled PositionRisk structures (two structures for Hedge mode, one for One-way)
      */
     [[nodiscard]] std::vector<PositionRisk> getPositionRisk(const std::string &symbol) const;
@@ -305,6 +334,29 @@ public:
      */
     void setExchangeInfo(const Exchange &exchange) const;
 
+    /**
+     * Set exchange info without decoding it, e.g. loaded from a snapshot
+     * @param exchange
+     * @param updateTime time of the Exchange info download in s
+     */
+    void setExchangeInfo(std::shared_ptr<const LazyExchange> exchange, std::int64_t updateTime) const;
+
+    /**
+     * Get symbol info from the cached Exchange info without copying the whole Exchange
+     * @param symbolId id from SymbolRegistry, all symbols of Exchange info are interned when it is loaded
+     * @return Symbol structure, nullopt if the symbol is not in Exchange info
+     * @throws nlohmann::json::exception, std::exception if Exchange info has to be loaded
+     */
+    [[nodiscard]] std::optional<Symbol> getSymbol(SymbolId symbolId) const;
+
+    /**
+     * Get symbol info from the cached Exchange info without copying the whole Exchange
+     * @param symbol e.g. BTCUSDT
+     * @return Symbol structure, nullopt if the symbol is not in Exchange info
+     * @throws nlohmann::json::exception, std::exception if Exchange info has to be loaded
+     */
+    [[nodiscard]] std::optional<Symbol> getSymbol(const std::string &symbol) const;
+
     /**
      * Change user's initial leverage of specific symbol market
      * @param symbol e.g. BTCUSDT
@@ -314,6 +366,27 @@ public:
      */
     [[nodiscard]] std::pair<int, double> changeInitialLeverage(const std::string &symbol, int leverage) const;
 
+    /**
+     * Change user's margin type of specific symbol market, the symbol already having the margin type is not an error
+     * @param symbol e.g. BTCUSDT
+     * @param marginType
+     * @see https://binance-docs.github.io/apidocs/futures/en/#change-margin-type-trade
+     * @throws nlohmann::json::exception, std::exception
+     */
+    void changeMarginType(const std::string &symbol, MarginType marginType) const;
+
+    /**
+     * Apply leverage and margin type settings to multiple symbols at once. Current settings of all symbols are read
+     * by a single Position risk request and only symbols that differ are changed, in parallel on a bounded number
+     * of threads.
+     * @param configurations required settings per symbol
+     * @param maxParallelRequests maximal number of symbols changed at the same time
+     * @return error record for every symbol that failed
+     * @throws nlohmann::json::exception, std::exception when Position risk cannot be read
+     */
+    std::vector<FetchError>
+    configureSymbols(const std::vector<SymbolConfiguration> &configurations, std::size_t maxParallelRequests = 8) const;
+
     /**
      * Get present open interest of a specific symbol.
      * @param symbol e.g. BTCUSDT
@@ -321,6 +394,15 @@ public:
      */
     [[nodiscard]] OpenInterest getOpenInterest(const std::string &symbol) const;
 
+    /**
+     * Get order book depth of a specific symbol. Request weight grows with the limit, 20 for 1000 levels.
+     * @param symbol e.g. BTCUSDT
+     * @param limit number of levels of each side, 5, 10, 20, 50, 100, 500 or 1000
+     * @return filled OrderBookSnapshot structure
+     * @throws nlohmann::json::exception, std::exception
+     */
+    [[nodiscard]] OrderBookSnapshot getOrderBook(const std::string &symbol, int limit = 1000) const;
+
     /**
      * Get open interest statistics. Only the data of the latest 30 days is available.
      * @param symbol  e.g. BTCUSDT
@@ -350,6 +432,45 @@ public:
      */
     [[nodiscard]] std::vector<BuySellVolume>
     getBuySellVolume(const std::string &symbol, StatisticsPeriod period, std::int64_t startTime) const;
+
+    /**
+     * Get open interest statistics for multiple symbols at once, symbols are downloaded in parallel on a bounded
+     * number of threads. Only the data of the latest 30 days is available.
+     * @param symbols e.g. BTCUSDT, ETHUSDT
+     * @param period
+     * @param startTime timestamp in ms (returned values are older than that date)
+     * @param maxParallelRequests maximal number of symbols downloaded at the same time
+     * @return column-oriented series per symbol and an error record for every symbol that failed
+     */
+    [[nodiscard]] MultiSymbolSeries<OpenInterestStatisticsSeries>
+    getOpenInterestStatistics(const std::vector<std::string> &symbols, StatisticsPeriod period, std::int64_t startTime,
+                              std::size_t maxParallelRequests = 8) const;
+
+    /**
+     * Get Long/Short Ratio for multiple symbols at once, symbols are downloaded in parallel on a bounded number of
+     * threads. Only the data of the latest 30 days is available.
+     * @param symbols e.g. BTCUSDT, ETHUSDT
+     * @param period
+     * @param startTime timestamp in ms (returned values are older than that date)
+     * @param maxParallelRequests maximal number of symbols downloaded at the same time
+     * @return column-oriented series per symbol and an error record for every symbol that failed
+     */
+    [[nodiscard]] MultiSymbolSeries<LongShortRatioSeries>
+    getLongShortRatio(const std::vector<std::string> &symbols, StatisticsPeriod period, std::int64_t startTime,
+                      std::size_t maxParallelRequests = 8) const;
+
+    /**
+     * Get Taker Buy/Sell Volume for multiple symbols at once, symbols are downloaded in parallel on a bounded number
+     * of threads. Only the data of the latest 30 days is available.
+     * @param symbols e.g. BTCUSDT, ETHUSDT
+     * @param period
+     * @param startTime timestamp in ms (returned values are older than that date)
+     * @param maxParallelRequests maximal number of symbols downloaded at the same time
+     * @return column-oriented series per symbol and an error record for every symbol that failed
+     */
+    [[nodiscard]] MultiSymbolSeries<BuySellVolumeSeries>
+    getBuySellVolume(const std::vector<std::string> &symbols, StatisticsPeriod period, std::int64_t startTime,
+                     std::size_t maxParallelRequests = 8) const;
 };
 }
 #endif //INCLUDE_STONKY_BINANCE_FUTURES_REST_CLIENT_H
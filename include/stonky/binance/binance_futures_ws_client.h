@@ -11,10 +11,29 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 
 #include <stonky/utils/log_utils.h>
 #include "binance_models.h"
+#include "binance_event_models.h"
 #include "binance_futures_ws_session.h"
+#include "binance_pod_events.h"
 #include <string>
 
 namespace stonky::binance::futures {
+using onBookTicker = std::function<void(const EventTickPrice &event)>;
+using onCandlestick = std::function<void(const EventCandlestick &event)>;
+using onDepthUpdate = std::function<void(const EventDepthUpdate &event)>;
+using onDepth = std::function<void(const EventDepth &event)>;
+using onAggregatedTrade = std::function<void(const EventAggregatedTrade &event)>;
+using onPodAggregatedTrade = std::function<void(const PodEventAggregatedTrade &event)>;
+using onMarkPrice = std::function<void(const EventMarkPrice &event)>;
+using onMiniTicker = std::function<void(const EventMiniTicker &event)>;
+
+/// Binance limit of streams subscribed on one connection
+static constexpr std::size_t MAX_STREAMS_PER_CONNECTION = 200;
+
+/// All-market stream names, events of all symbols share one stream
+static constexpr auto ALL_BOOK_TICKERS_STREAM = "!bookTicker";
+static constexpr auto ALL_MARK_PRICES_STREAM = "!markPrice@arr@1s";
+static constexpr auto ALL_MINI_TICKERS_STREAM = "!miniTicker@arr";
+
 class WebSocketClient {
     struct P;
     std::unique_ptr<P> m_p{};
@@ -30,6 +49,13 @@ public:
 
     WebSocketClient();
 
+    /**
+     * @param numThreads number of IO threads, each runs its own io_context and sessions are sharded among them -
+     * dedicated stream connections by symbol, combined stream connections evenly
+     * @param pinThreads if true then IO thread i is pinned to CPU i (Linux only)
+     */
+    explicit WebSocketClient(std::size_t numThreads, bool pinThreads = false);
+
     ~WebSocketClient();
 
     /**
@@ -41,7 +67,7 @@ public:
     static std::string composeStreamName(const std::string &pair, const std::string &channel);
 
     /**
-     * Run the WebSocket IO Context asynchronously and returns immediately without blocking the thread execution
+     * Run the WebSocket IO Contexts asynchronously and returns immediately without blocking the thread execution
      */
     void run() const;
 
@@ -51,8 +77,31 @@ public:
      */
     void setLoggerCallback(const onLogMessage &onLogMessageCB) const;
 
+    /**
+     * Multiplex subsequently subscribed streams over shared connections. The first stream of a connection opens
+     * /stream?streams=<stream>, further streams are added by SUBSCRIBE requests until maxStreamsPerConnection is
+     * reached, then a new connection is opened. Frames are routed to the stream handlers by the "stream" field of the
+     * combined stream envelope.
+     * @param maxStreamsPerConnection 0 disables multiplexing, each stream then has its own connection
+     */
+    void setCombinedStreams(std::size_t maxStreamsPerConnection = MAX_STREAMS_PER_CONNECTION) const;
+
+    /**
+     * Set callback of stream interruptions. Failed connections are re-established with backoff and their streams
+     * resubscribed, then the callback is called for every stream of the connection - update ids are not known here.
+     * Must be set before subscribing.
+     * @param onStreamGapCB called from the IO thread of the connection
+     */
+    void setStreamGapCallback(const onStreamGap &onStreamGapCB) const;
+
     [[nodiscard]] bool findStream(const std::string &streamName) const;
 
+    /**
+     * Stop receiving the stream, UNSUBSCRIBE request is sent for a multiplexed stream, own connection is closed
+     * @param streamName full stream name, see composeStreamName()
+     */
+    void unsubscribe(const std::string &streamName) const;
+
     /**
      * Subscribe WebSocket to the bookTicker data stream
      * @param pair currency pair e.g. BTCUSDT
@@ -60,6 +109,13 @@ public:
      */
     void bookTicker(const std::string &pair, const onJSONMessage &cb) const;
 
+    /**
+     * Subscribe WebSocket to the bookTicker data stream, frames are parsed directly into EventTickPrice without JSON DOM
+     * @param pair currency pair e.g. BTCUSDT
+     * @param cb handle to process the incoming events, the event instance is reused for subsequent frames
+     */
+    void bookTicker(const std::string &pair, const onBookTicker &cb) const;
+
     /**
     * Subscribe WebSocket to the kline/candlestick data stream
     * @param pair currency pair e.g. BTCUSDT
@@ -68,6 +124,38 @@ public:
     */
     void candlestick(const std::string &pair, CandleInterval interval, const onJSONMessage &cb) const;
 
+    /**
+     * Subscribe WebSocket to the kline/candlestick data stream, frames are parsed directly into EventCandlestick
+     * without JSON DOM
+     * @param pair currency pair e.g. BTCUSDT
+     * @param interval
+     * @param cb handle to process the incoming events, the event instance is reused for subsequent frames
+     */
+    void candlestick(const std::string &pair, CandleInterval interval, const onCandlestick &cb) const;
+
+    /**
+     * Subscribe WebSocket to the aggTrade data stream
+     * @param pair currency pair e.g. BTCUSDT
+     * @param cb handle to process the incoming data
+     */
+    void aggTrade(const std::string &pair, const onJSONMessage &cb) const;
+
+    /**
+     * Subscribe WebSocket to the aggTrade data stream, frames are parsed directly into EventAggregatedTrade without
+     * JSON DOM
+     * @param pair currency pair e.g. BTCUSDT
+     * @param cb handle to process the incoming events, the event instance is reused for subsequent frames
+     */
+    void aggTrade(const std::string &pair, const onAggregatedTrade &cb) const;
+
+    /**
+     * Subscribe WebSocket to the aggTrade data stream, frames are parsed directly into the compact event, nothing is
+     * allocated
+     * @param pair currency pair e.g. BTCUSDT
+     * @param cb handle to process the incoming events
+     */
+    void aggTrade(const std::string &pair, const onPodAggregatedTrade &cb) const;
+
     /**
      * Subscribe to Partial Book Depth Stream
      * @param pair currency pair e.g. BTCUSDT
@@ -75,6 +163,53 @@ public:
      * @param cb handle to process the incoming data
      */
     void partialBookDepthStream(const std::string &pair, int depth, const onJSONMessage &cb) const;
+
+    /**
+     * Subscribe to Partial Book Depth Stream, frames are parsed directly into EventDepth without JSON DOM
+     * @param pair currency pair e.g. BTCUSDT
+     * @param depth stream depth 5, 10 or 20
+     * @param cb handle to process the incoming events, the event instance is reused for subsequent frames
+     */
+    void partialBookDepthStream(const std::string &pair, int depth, const onDepth &cb) const;
+
+    /**
+     * Subscribe to Diff. Book Depth Stream with 100ms updates, frames are parsed directly into EventDepthUpdate
+     * without JSON DOM. See OrderBook for keeping a local order book from it.
+     * @param pair currency pair e.g. BTCUSDT
+     * @param cb handle to process the incoming events, the event instance is reused for subsequent frames
+     */
+    void diffBookDepthStream(const std::string &pair, const onDepthUpdate &cb) const;
+
+    /**
+     * Subscribe to All Book Tickers Stream (ALL_BOOK_TICKERS_STREAM), book ticker updates of all symbols are parsed
+     * directly into EventTickPrice without JSON DOM
+     * @param cb handle to process the incoming events, the event instance is reused for subsequent frames
+     */
+    void allBookTickers(const onBookTicker &cb) const;
+
+    /**
+     * Subscribe to All Market Mark Price Stream with 1s updates (ALL_MARK_PRICES_STREAM). Every frame carries mark
+     * prices and funding rates of all symbols.
+     * @param cb called for every symbol of the frame, the event instance is reused for subsequent symbols
+     */
+    void allMarkPrices(const onMarkPrice &cb) const;
+
+    /**
+     * Subscribe to All Market Mini Tickers Stream (ALL_MINI_TICKERS_STREAM). Every frame carries the symbols changed
+     * since the previous one.
+     * @param cb called for every symbol of the frame, the event instance is reused for subsequent symbols
+     */
+    void allMiniTickers(const onMiniTicker &cb) const;
+
+    /**
+     * Connect to the User Data Stream, it always has its own connection. A failed connection is restored and reported
+     * by the stream gap callback with the listenKey as the stream name - events pushed during the outage are lost,
+     * re-read account and positions by REST. The connection is not rolled over, close it and connect again with a
+     * fresh listenKey instead. Keeping the listenKey alive is up to the caller, see WSStreamManager.
+     * @param listenKey key from RESTClient::startUserDataStream()
+     * @param cb handle to process the incoming events
+     */
+    void userDataStream(const std::string &listenKey, const onUserData &cb) const;
 };
 }
 
@@ -12,12 +12,24 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 #include "stonky/utils/log_utils.h"
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ssl/context.hpp>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <nlohmann/json_fwd.hpp>
+#include <string_view>
 
 namespace stonky::binance::futures {
 using onJSONMessage = std::function<void(const nlohmann::json &msg)>;
 
+/// Frame payload, valid only during the callback
+using onRawMessage = std::function<void(std::string_view msg)>;
+
+/// Connection restored after an outage, times in ms
+using onReconnected = std::function<void(std::int64_t disconnectTime, std::int64_t reconnectTime)>;
+
+/// Replacement connection established, the old one is still read until the overlap ends
+using onRolledOver = std::function<void()>;
+
 class WebSocketSession final : public std::enable_shared_from_this<WebSocketSession> {
     struct P;
     std::unique_ptr<P> m_p;
@@ -29,6 +41,54 @@ public:
 
     void run(const std::string &host, const std::string &port, const std::string &target, const onJSONMessage &onJsonMsg);
 
+    /**
+     * Same as run() but frames are passed to the callback as they are, without JSON parsing and without copying
+     * @param host
+     * @param port
+     * @param target stream path
+     * @param onRawMsg called with every received frame
+     */
+    void runRaw(const std::string &host, const std::string &port, const std::string &target, const onRawMessage &onRawMsg);
+
+    /**
+     * Send text frame, e.g. SUBSCRIBE request. Frames sent before the handshake completes are queued.
+     * @param message frame payload
+     */
+    void send(std::string message);
+
+    /**
+     * Same as send(std::string) but the frame is not sent if the flag is set before the frame is written, e.g. when
+     * the request has already been given up on. Also applies to frames queued across a reconnect.
+     * @param message frame payload
+     * @param cancelled cancellation flag, may be null
+     */
+    void send(std::string message, std::shared_ptr<const std::atomic<bool> > cancelled);
+
+    /**
+     * Reconnect to the same target when the connection fails, after exponential backoff with jitter. Must be set
+     * before run().
+     * @param onReconnectedCB called when a new connection is established, before its first frame is read
+     */
+    void setAutoReconnect(const onReconnected &onReconnectedCB);
+
+    /**
+     * Replace the connection before the server drops it (Binance closes connections after 24h). A second connection to
+     * the same target is opened when the active one reaches the age, both are read for a short overlap and events
+     * received by both connections are delivered once. Must be set before run().
+     * @param onRolledOverCB called when the replacement is established, frames sent from it go to the replacement,
+     * e.g. SUBSCRIBE requests of combined streams
+     * @param age connection age that triggers the rollover
+     */
+    void setRollover(const onRolledOver &onRolledOverCB, std::chrono::seconds age = std::chrono::hours(23));
+
+    /**
+     * @return age of the active connection, 0 when not connected
+     */
+    [[nodiscard]] std::chrono::milliseconds connectionAge() const;
+
+    /**
+     * Close the connection, a closed session is not reconnected
+     */
     void close() const;
 
     [[nodiscard]] std::string target() const;
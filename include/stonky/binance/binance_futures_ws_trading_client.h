@@ -0,0 +1,98 @@
+/**
+Binance Futures WebSocket Trading API Client
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_FUTURES_WS_TRADING_CLIENT_H
+#define INCLUDE_STONKY_BINANCE_FUTURES_WS_TRADING_CLIENT_H
+
+#include <stonky/utils/log_utils.h>
+#include "binance_models.h"
+#include <memory>
+#include <string>
+
+namespace stonky::binance::futures {
+/**
+ * Orders over the WebSocket API - one persistent authenticated connection, every request is a single signed frame and
+ * its response is matched by the request id. Requests do not queue behind each other like HTTP requests on one
+ * connection, any number of them may be in flight. The connection is restored after a failure, requests in flight are
+ * failed then - their outcome is unknown, query the order.
+ * Methods are thread-safe and block until the response arrives or the timeout expires. A timed out request has an
+ * unknown outcome as well: its frame is dropped if it is still queued, but once sent the server may execute it up to
+ * recvWindow (5 s for order.place, order.modify and order.cancel) after it was signed. Query the order by its
+ * newClientOrderId before retrying.
+ */
+class WSTradingClient {
+    struct P;
+    std::unique_ptr<P> m_p{};
+
+public:
+    WSTradingClient(const WSTradingClient &) = delete;
+
+    WSTradingClient &operator=(const WSTradingClient &) = delete;
+
+    /**
+     * Connect to the WebSocket API, requests sent before the connection is established are queued
+     * @param apiKey same key material as RESTClient
+     * @param apiSecret HMAC SHA256 secret
+     */
+    WSTradingClient(const std::string &apiKey, const std::string &apiSecret);
+
+    ~WSTradingClient();
+
+    /**
+     * Set logger callback, if no set then all errors are writen to the stderr stream only
+     * @param onLogMessageCB
+     */
+    void setLoggerCallback(const onLogMessage &onLogMessageCB) const;
+
+    /**
+     * Set time to wait for a response, the outcome of a request that times out is unknown
+     * @param seconds
+     */
+    void setTimeout(int seconds) const;
+
+    /**
+     * Send order, method order.place. Prices and quantities are formatted by Order::pricePrecision and
+     * Order::quantityPrecision, set them from the Symbol.
+     * @param order
+     * @return Filled OrderResponse structure
+     * @throws nlohmann::json::exception, std::exception
+     */
+    [[nodiscard]] OrderResponse sendOrder(const Order &order) const;
+
+    /**
+     * Modify price and quantity of a LIMIT order, method order.modify
+     * @param order symbol, side, quantity, price and orderId or newClientOrderId of the order to modify
+     * @return Filled OrderResponse structure
+     * @throws nlohmann::json::exception, std::exception
+     */
+    [[nodiscard]] OrderResponse modifyOrder(const Order &order) const;
+
+    /**
+     * Cancel order, method order.cancel
+     * @param symbol e.g. BTCUSDT
+     * @param clientId
+     * @param orderId
+     * @return OrderResponse structure
+     * @throws nlohmann::json::exception, std::exception
+     */
+    [[nodiscard]] OrderResponse
+    cancelOrder(const std::string &symbol, const std::string &clientId, std::int64_t orderId = 0) const;
+
+    /**
+     * Query order, method order.status
+     * @param symbol e.g. BTCUSDT
+     * @param clientId
+     * @param orderId
+     * @return Filled OrderResponse structure
+     * @throws nlohmann::json::exception, std::exception
+     */
+    [[nodiscard]] OrderResponse
+    queryOrder(const std::string &symbol, const std::string &clientId, std::int64_t orderId = 0) const;
+};
+}
+#endif //INCLUDE_STONKY_BINANCE_FUTURES_WS_TRADING_CLIENT_H
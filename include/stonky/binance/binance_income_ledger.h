@@ -0,0 +1,70 @@
+/**
+Binance Futures Income Ledger
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_INCOME_LEDGER_H
+#define INCLUDE_STONKY_BINANCE_INCOME_LEDGER_H
+
+#include "binance_models.h"
+#include <filesystem>
+#include <memory>
+
+namespace stonky::binance::futures {
+class RESTClient;
+
+/**
+ * Local copy of the account Income history. Records are kept in memory ordered by time and persisted to an
+ * append-only file, one JSON object per line.
+ */
+class IncomeLedger {
+    struct P;
+    std::unique_ptr<P> m_p{};
+
+public:
+    /**
+     * @param restClient authenticated client used for downloading new records
+     * @param filePath ledger file, existing records are loaded from it
+     */
+    IncomeLedger(const std::weak_ptr<RESTClient> &restClient, const std::filesystem::path &filePath);
+
+    ~IncomeLedger();
+
+    /**
+     * Download all records newer than the last stored one (or than startTime if the ledger is empty), paging forward
+     * by time, a timestamp with more records than one page holds is read by pages. Records already present in the
+     * ledger are skipped.
+     * @param startTime timestamp in ms, used only when the ledger is empty
+     * @return number of new records
+     * @throws nlohmann::json::exception, std::exception
+     */
+    std::size_t sync(std::int64_t startTime) const;
+
+    /**
+     * Return stored records, no request is sent
+     * @param startTime timestamp in ms INCLUSIVE
+     * @param endTime timestamp in ms INCLUSIVE
+     * @return vector of Income structures ordered by time
+     */
+    [[nodiscard]] std::vector<Income> getIncome(std::int64_t startTime, std::int64_t endTime) const;
+
+    /**
+     * Sum stored income by symbol and IncomeType, no request is sent
+     * @param startTime timestamp in ms INCLUSIVE
+     * @param endTime timestamp in ms INCLUSIVE
+     * @param asset only records in this asset are summed, e.g. USDT
+     * @return map of sums by IncomeType, map keys are symbols (empty for records not related to a symbol)
+     */
+    [[nodiscard]] std::map<std::string, std::map<IncomeType, double> >
+    aggregate(std::int64_t startTime, std::int64_t endTime, const std::string &asset = "USDT") const;
+
+    /**
+     * @return time of the newest stored record in ms, -1 if the ledger is empty
+     */
+    [[nodiscard]] std::int64_t lastTime() const;
+};
+}
+#endif //INCLUDE_STONKY_BINANCE_INCOME_LEDGER_H
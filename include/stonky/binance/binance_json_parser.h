@@ -0,0 +1,135 @@
+/**
+Binance JSON Response Parser
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_JSON_PARSER_H
+#define INCLUDE_STONKY_BINANCE_JSON_PARSER_H
+
+#include "binance_models.h"
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace stonky::binance {
+/**
+ * Parsing backends of high-volume REST responses.
+ * Nlohmann builds nlohmann::json DOM and fills the model by its fromJson(), Simdjson reads the payload by simdjson
+ * On-Demand API directly into the model. Simdjson is available only when built with BINANCE_API_USE_SIMDJSON.
+ */
+enum class JsonBackend : std::int32_t {
+    Nlohmann,
+    Simdjson
+};
+
+/**
+ * Spare capacity behind the payload which lets Simdjson parse it without a padded copy, equal to SIMDJSON_PADDING.
+ * Reserve it when reading the response body, see HTTPSession.
+ */
+static constexpr std::size_t JSON_PAYLOAD_PADDING = 64;
+
+/**
+ * Thrown when a payload is not a valid JSON or a value does not match the model
+ */
+struct JsonParseError final : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * Convert decimal string to double without allocation
+ * @param str e.g. 0.01634790, the whole string has to be a number
+ * @param value result, unchanged on failure
+ * @return false if str is not a number
+ */
+bool parseDouble(std::string_view str, double &value);
+
+/**
+ * Allocation-free counterpart of stod(json.get<std::string>()), Binance sends decimals as strings
+ * @param value string or number JSON value
+ * @return converted number, 0 for an empty string
+ * @throws JsonParseError if the value is not a decimal string nor a number
+ */
+double readDecimal(const nlohmann::json &value);
+
+/**
+ * Allocation-free counterpart of readStringAsDouble()
+ * @param json JSON object
+ * @param key field name
+ * @param def returned when the field is missing, null or empty
+ * @return converted number
+ * @throws JsonParseError if the field is not a decimal string nor a number
+ */
+double readDecimal(const nlohmann::json &json, std::string_view key, double def = 0.0);
+
+/**
+ * Read price levels sent as [["price","quantity"],...], e.g. bids of the depth response
+ * @param json JSON object
+ * @param key field name
+ * @param levels levels in the order of the payload, previous content is cleared, no levels if the field is missing
+ * @throws JsonParseError if a level is not a pair of decimals
+ */
+void readOrderBookLevels(const nlohmann::json &json, std::string_view key,
+                         std::vector<futures::OrderBookLevel> &levels);
+
+/**
+ * @return backend selected at build time, Simdjson if built with BINANCE_API_USE_SIMDJSON, Nlohmann otherwise
+ */
+JsonBackend defaultJsonBackend();
+
+/**
+ * @return true if the backend is compiled in
+ */
+bool isJsonBackendAvailable(JsonBackend backend);
+
+/**
+ * Parse klines response
+ * @param payload response body, see JSON_PAYLOAD_PADDING
+ * @param candlesResponse filled model, previous content is cleared
+ * @param backend parsing backend
+ * @throws nlohmann::json::exception, JsonParseError, std::runtime_error if the backend is not available
+ */
+void parseResponse(const std::string &payload, CandlesResponse &candlesResponse,
+                   JsonBackend backend = defaultJsonBackend());
+}
+
+namespace stonky::binance::futures {
+/**
+ * Parse all-symbol premiumIndex response
+ * @param payload response body, see JSON_PAYLOAD_PADDING
+ * @param markPrices filled model, previous content is cleared
+ * @param backend parsing backend
+ * @throws nlohmann::json::exception, JsonParseError, std::runtime_error if the backend is not available
+ */
+void parseResponse(const std::string &payload, MarkPrices &markPrices, JsonBackend backend = defaultJsonBackend());
+
+/**
+ * Parse fundingRate response
+ * @param payload response body, see JSON_PAYLOAD_PADDING
+ * @param fundingRates filled model, previous content is cleared
+ * @param backend parsing backend
+ * @throws nlohmann::json::exception, JsonParseError, std::runtime_error if the backend is not available
+ */
+void parseResponse(const std::string &payload, FundingRates &fundingRates, JsonBackend backend = defaultJsonBackend());
+
+/**
+ * Parse exchangeInfo response
+ * @param payload response body, see JSON_PAYLOAD_PADDING
+ * @param exchange filled model, previous content is cleared
+ * @param backend parsing backend
+ * @throws nlohmann::json::exception, JsonParseError, std::runtime_error if the backend is not available
+ */
+void parseResponse(const std::string &payload, Exchange &exchange, JsonBackend backend = defaultJsonBackend());
+
+/**
+ * Parse income response
+ * @param payload response body, see JSON_PAYLOAD_PADDING
+ * @param incomes filled model, previous content is cleared
+ * @param backend parsing backend
+ * @throws nlohmann::json::exception, JsonParseError, std::runtime_error if the backend is not available
+ */
+void parseResponse(const std::string &payload, Incomes &incomes, JsonBackend backend = defaultJsonBackend());
+}
+#endif //INCLUDE_STONKY_BINANCE_JSON_PARSER_H
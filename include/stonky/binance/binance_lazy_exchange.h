@@ -0,0 +1,95 @@
+/**
+Binance Lazily Decoded Exchange Info
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_LAZY_EXCHANGE_H
+#define INCLUDE_STONKY_BINANCE_LAZY_EXCHANGE_H
+
+#include "binance_models.h"
+#include "binance_symbol_registry.h"
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace stonky::binance::futures {
+/**
+ * Exchange info kept as the raw exchangeInfo response in one buffer. Construction only indexes the symbols - their
+ * names and positions in the buffer - a Symbol is decoded on its first access and full Exchange only when requested.
+ * All memory is released at once with the instance, share it by std::shared_ptr and replace the pointer on refresh.
+ * Thread-safe.
+ */
+class LazyExchange {
+    struct P;
+    std::unique_ptr<P> m_p{};
+
+public:
+    LazyExchange(const LazyExchange &) = delete;
+
+    LazyExchange &operator=(const LazyExchange &) = delete;
+
+    /**
+     * Index exchangeInfo response, symbols are interned into SymbolRegistry
+     * @param payload response body
+     * @throws JsonParseError
+     */
+    explicit LazyExchange(std::string payload);
+
+    /**
+     * Wrap already decoded Exchange, e.g. set by RESTClient::setExchangeInfo()
+     */
+    explicit LazyExchange(Exchange exchange);
+
+    ~LazyExchange();
+
+    [[nodiscard]] std::int64_t serverTime() const;
+
+    /**
+     * @return raw exchangeInfo response, empty if constructed from decoded Exchange
+     */
+    [[nodiscard]] std::string_view payload() const;
+
+    /**
+     * @return number of symbols
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @param index 0 - size()-1
+     * @return symbol name without decoding the symbol
+     * @throws std::out_of_range
+     */
+    [[nodiscard]] std::string_view symbolName(std::size_t index) const;
+
+    /**
+     * @param index 0 - size()-1
+     * @return symbol decoded on the first access, valid for the lifetime of this instance
+     * @throws std::out_of_range, nlohmann::json::exception
+     */
+    [[nodiscard]] const Symbol &symbol(std::size_t index) const;
+
+    /**
+     * @param symbolId id from SymbolRegistry
+     * @return symbol decoded on the first access, nullptr if it is not in the Exchange info
+     * @throws nlohmann::json::exception
+     */
+    [[nodiscard]] const Symbol *find(SymbolId symbolId) const;
+
+    /**
+     * @param symbol e.g. BTCUSDT
+     * @return symbol decoded on the first access, nullptr if it is not in the Exchange info
+     * @throws nlohmann::json::exception
+     */
+    [[nodiscard]] const Symbol *find(std::string_view symbol) const;
+
+    /**
+     * @return fully decoded Exchange, decoded on the first call, lastUpdateTime is not set
+     * @throws nlohmann::json::exception, JsonParseError
+     */
+    [[nodiscard]] const Exchange &exchange() const;
+};
+}
+#endif //INCLUDE_STONKY_BINANCE_LAZY_EXCHANGE_H
@@ -0,0 +1,162 @@
+/**
+Binance Model Field Tables
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_MODEL_FIELDS_H
+#define INCLUDE_STONKY_BINANCE_MODEL_FIELDS_H
+
+#include "binance_json_parser.h"
+#include "binance_enum_parser.h"
+#include "stonky/utils/magic_enum_wrapper.hpp"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <charconv>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace stonky::binance {
+/**
+ * JSON key of a model member
+ */
+template<typename Class, typename T>
+struct Field {
+    std::string_view key;
+    T Class::*member;
+};
+
+template<typename Class, typename T>
+constexpr Field<Class, T> field(const std::string_view key, T Class::*member) {
+    return {key, member};
+}
+
+/**
+ * Field table of a model, specialize with
+ * static constexpr std::tuple FIELDS{field("key", &Model::member), ...};
+ * Supported members are std::string, bool, integers, decimals (double) and enums (by name).
+ */
+template<typename Model>
+struct ModelFields;
+
+/**
+ * Reads and writes a model by its ModelFields table
+ */
+template<typename Model>
+class FieldTable {
+    static constexpr auto &FIELDS = ModelFields<Model>::FIELDS;
+    static constexpr std::size_t COUNT = std::tuple_size_v<std::remove_cvref_t<decltype(FIELDS)> >;
+
+    static constexpr PerfectHashIndex<COUNT> INDEX{std::apply([](const auto &... fields) {
+        return std::array<std::string_view, COUNT>{fields.key...};
+    }, FIELDS)};
+
+    using Reader = void (*)(const nlohmann::json &, Model &);
+
+    static void readValue(const nlohmann::json &value, std::string &member) {
+        member = value.get_ref<const std::string &>();
+    }
+
+    static void readValue(const nlohmann::json &value, double &member) {
+        member = readDecimal(value);
+    }
+
+    template<typename T> requires std::is_enum_v<T>
+    static void readValue(const nlohmann::json &value, T &member) {
+        if (const auto enumValue = parseEnum<T>(value.get_ref<const std::string &>()); enumValue.has_value()) {
+            member = enumValue.value();
+        }
+    }
+
+    template<typename T> requires std::is_arithmetic_v<T>
+    static void readValue(const nlohmann::json &value, T &member) {
+        value.get_to(member);
+    }
+
+    static nlohmann::json writeValue(const std::string &member) {
+        return member;
+    }
+
+    /**
+     * Decimals are written as strings like Binance sends them, shortest fixed notation that reads back exactly
+     */
+    static nlohmann::json writeValue(const double member) {
+        std::array<char, 64> buffer{};
+        auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), member, std::chars_format::fixed);
+
+        if (ec != std::errc()) {
+            end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), member).ptr;
+        }
+
+        return std::string(buffer.data(), end);
+    }
+
+    template<typename T> requires std::is_enum_v<T>
+    static nlohmann::json writeValue(const T member) {
+        return magic_enum::enum_name(member);
+    }
+
+    template<typename T> requires std::is_arithmetic_v<T>
+    static nlohmann::json writeValue(const T member) {
+        return member;
+    }
+
+    template<std::size_t I>
+    static void readField(const nlohmann::json &value, Model &model) {
+        readValue(value, model.*std::get<I>(FIELDS).member);
+    }
+
+    static constexpr auto READERS = []<std::size_t... I>(std::index_sequence<I...>) {
+        return std::array<Reader, COUNT>{&readField<I>...};
+    }(std::make_index_sequence<COUNT>{});
+
+public:
+    /**
+     * One pass over the object, every key is dispatched by the perfect hash.
+     * Unknown keys and nulls are skipped, members without a key in the object keep their value.
+     * @throws nlohmann::json::exception, JsonParseError if a value does not match the member type
+     */
+    static void read(const nlohmann::json &json, Model &model) {
+        if (!json.is_object()) {
+            return;
+        }
+
+        for (auto it = json.begin(); it != json.end(); ++it) {
+            if (const auto index = INDEX.find(it.key()); index < COUNT && !it->is_null()) {
+                READERS[index](*it, model);
+            }
+        }
+    }
+
+    static nlohmann::json write(const Model &model) {
+        nlohmann::json json = nlohmann::json::object();
+
+        std::apply([&](const auto &... fields) {
+            ((json[std::string(fields.key)] = writeValue(model.*fields.member)), ...);
+        }, FIELDS);
+
+        return json;
+    }
+};
+
+/**
+ * Fill the model from JSON object by its ModelFields table
+ * @throws nlohmann::json::exception, JsonParseError
+ */
+template<typename Model>
+void readFields(const nlohmann::json &json, Model &model) {
+    FieldTable<Model>::read(json, model);
+}
+
+/**
+ * @return JSON object of all members in the ModelFields table
+ */
+template<typename Model>
+nlohmann::json writeFields(const Model &model) {
+    return FieldTable<Model>::write(model);
+}
+}
+#endif //INCLUDE_STONKY_BINANCE_MODEL_FIELDS_H
@@ -10,7 +10,12 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 #define INCLUDE_CK_BINANCE_MODELS_H
 
 #include "stonky/interface/i_json.h"
+#include "binance_decimal.h"
 #include <nlohmann/json.hpp>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace stonky::binance {
 enum class CandleInterval : std::int32_t {
@@ -278,6 +283,15 @@ enum class SelfTradePreventionMode : std::int32_t {
     EXPIRE_MAKER
 };
 
+/**
+ * Reason of a failed request in multi-symbol downloads
+ */
+enum class FetchErrorType : std::int32_t {
+    Network,
+    Api,
+    Parse
+};
+
 struct FundingRate final : IJson {
     std::string symbol{};
     double fundingRate{};
@@ -306,6 +320,14 @@ struct TickerPrice final : IJson {
     void fromJson(const nlohmann::json &json) override;
 };
 
+struct TickerPrices final : IJson {
+    std::unordered_map<std::string, TickerPrice> tickerPrices{};
+
+    [[nodiscard]] nlohmann::json toJson() const override;
+
+    void fromJson(const nlohmann::json &json) override;
+};
+
 struct BookTickerPrice final : IJson {
     std::string symbol{};
     double bidPrice{};
@@ -319,6 +341,14 @@ struct BookTickerPrice final : IJson {
     void fromJson(const nlohmann::json &json) override;
 };
 
+struct BookTickerPrices final : IJson {
+    std::unordered_map<std::string, BookTickerPrice> bookTickerPrices{};
+
+    [[nodiscard]] nlohmann::json toJson() const override;
+
+    void fromJson(const nlohmann::json &json) override;
+};
+
 struct MarkPrice final : IJson {
     std::string symbol{};
     double markPrice{};
@@ -417,6 +447,9 @@ struct Order : IJson {
     /// Cannot be sent with closePosition=true(Close-All)
     double quantity{};
 
+    /// Sent instead of quantity if set, e.g. result of Symbol::truncateQuantity(), no float formatting involved
+    std::optional<Decimal> exactQuantity{};
+
     /// "true" or "false". default "false". Cannot be sent in Hedge Mode; cannot be sent with closePosition=true
     bool reduceOnly{false};
 
@@ -426,6 +459,9 @@ struct Order : IJson {
 
     double price{};
 
+    /// Sent instead of price if set, e.g. result of Symbol::roundPrice(), no float formatting involved
+    std::optional<Decimal> exactPrice{};
+
     /// Used with STOP/STOP_MARKET or TAKE_PROFIT/TAKE_PROFIT_MARKET orders.
     double stopPrice{};
 
@@ -520,6 +556,10 @@ struct Filter final : IJson {
     double multiplierDown{};
     double multiplierDecimal{};
     double notional{};
+    /// tickSize exactly as sent, 0 if not set
+    Decimal exactTickSize{};
+    /// stepSize exactly as sent, 0 if not set
+    Decimal exactStepSize{};
 
     [[nodiscard]] nlohmann::json toJson() const override;
 
@@ -555,6 +595,34 @@ struct Symbol final : IJson {
     [[nodiscard]] nlohmann::json toJson() const override;
 
     void fromJson(const nlohmann::json &json) override;
+
+    /**
+     * @param price e.g. 37012.45000000
+     * @return price with pricePrecision decimal places
+     * @throws std::invalid_argument, std::out_of_range
+     */
+    [[nodiscard]] Decimal toPrice(std::string_view price) const;
+
+    [[nodiscard]] Decimal toPrice(double price) const;
+
+    /**
+     * @param quantity e.g. 0.00100000
+     * @return quantity with quantityPrecision decimal places
+     * @throws std::invalid_argument, std::out_of_range
+     */
+    [[nodiscard]] Decimal toQuantity(std::string_view quantity) const;
+
+    [[nodiscard]] Decimal toQuantity(double quantity) const;
+
+    /**
+     * @return price rounded to PRICE_FILTER tickSize with pricePrecision decimal places
+     */
+    [[nodiscard]] Decimal roundPrice(const Decimal &price) const;
+
+    /**
+     * @return quantity truncated to LOT_SIZE stepSize with quantityPrecision decimal places
+     */
+    [[nodiscard]] Decimal truncateQuantity(const Decimal &quantity) const;
 };
 
 struct Exchange final : IJson {
@@ -636,6 +704,31 @@ struct OpenInterest final : IJson {
     void fromJson(const nlohmann::json &json) override;
 };
 
+/**
+ * Price level of an order book, quantity is the total quantity at the price
+ */
+struct OrderBookLevel {
+    double price{};
+    double quantity{};
+
+    bool operator==(const OrderBookLevel &other) const = default;
+};
+
+/**
+ * Order book depth, levels of both sides are ordered from the best price
+ */
+struct OrderBookSnapshot final : IJson {
+    std::int64_t lastUpdateId{};
+    std::int64_t E{}; /// message output time
+    std::int64_t T{}; /// transaction time
+    std::vector<OrderBookLevel> bids{};
+    std::vector<OrderBookLevel> asks{};
+
+    [[nodiscard]] nlohmann::json toJson() const override;
+
+    void fromJson(const nlohmann::json &json) override;
+};
+
 struct LongShortRatio final : IJson {
     std::string symbol{};
     double longShortRatio{};
@@ -669,5 +762,76 @@ struct BuySellVolume final : IJson {
 
     void fromJson(const nlohmann::json &json) override;
 };
+
+/**
+ * Column-oriented storage of OpenInterestStatistics records of a single symbol, ordered from the oldest
+ */
+struct OpenInterestStatisticsSeries {
+    std::vector<std::int64_t> timestamp{};
+    std::vector<double> sumOpenInterest{};
+    std::vector<double> sumOpenInterestValue{};
+
+    void reserve(std::size_t size);
+
+    void push_back(const OpenInterestStatistics &statistics);
+
+    [[nodiscard]] std::size_t size() const { return timestamp.size(); }
+};
+
+/**
+ * Column-oriented storage of LongShortRatio records of a single symbol, ordered from the oldest
+ */
+struct LongShortRatioSeries {
+    std::vector<std::int64_t> timestamp{};
+    std::vector<double> longShortRatio{};
+    std::vector<double> longAccount{};
+    std::vector<double> shortAccount{};
+
+    void reserve(std::size_t size);
+
+    void push_back(const LongShortRatio &ratio);
+
+    [[nodiscard]] std::size_t size() const { return timestamp.size(); }
+};
+
+/**
+ * Column-oriented storage of BuySellVolume records of a single symbol, ordered from the oldest
+ */
+struct BuySellVolumeSeries {
+    std::vector<std::int64_t> timestamp{};
+    std::vector<double> buySellRatio{};
+    std::vector<double> buyVol{};
+    std::vector<double> sellVol{};
+
+    void reserve(std::size_t size);
+
+    void push_back(const BuySellVolume &volume);
+
+    [[nodiscard]] std::size_t size() const { return timestamp.size(); }
+};
+
+/**
+ * Required account settings of a symbol, see RESTClient::configureSymbols
+ */
+struct SymbolConfiguration {
+    std::string symbol{};
+    int leverage{1};
+    MarginType marginType{MarginType::CROSS};
+};
+
+struct FetchError {
+    std::string symbol{};
+    FetchErrorType type{FetchErrorType::Api};
+    std::string message{};
+};
+
+/**
+ * Result of a multi-symbol download: data of all symbols that succeeded and an error record for each one that failed
+ */
+template<typename Series>
+struct MultiSymbolSeries {
+    std::map<std::string, Series> series{};
+    std::vector<FetchError> errors{};
+};
 }
 #endif //INCLUDE_CK_BINANCE_MODELS_H
@@ -0,0 +1,162 @@
+/**
+Binance Futures Local Order Book
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_ORDER_BOOK_H
+#define INCLUDE_STONKY_BINANCE_ORDER_BOOK_H
+
+#include "binance_event_models.h"
+#include "binance_models.h"
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace stonky::binance::futures {
+/**
+ * Local L2 order book of one symbol kept from the depth snapshot and the Diff. Book Depth Stream.
+ * Both sides are flat vectors ordered so that the best level is the last one - updates, which mostly hit the top of the
+ * book, shift only a few levels behind them. The best level and a level by its distance from the top are O(1), a level
+ * by price is O(log n).
+ * Events follow Binance sequencing rules: they are buffered until a snapshot arrives, events older than the snapshot
+ * are dropped, the first applied event has to span the snapshot lastUpdateId and every next one has to continue the
+ * previous one, i.e. its pu equals u of the previous event. A break unsyncs the book until a new snapshot arrives.
+ * Not thread-safe.
+ */
+class OrderBook final {
+public:
+    /// Events kept while waiting for a snapshot, the oldest are dropped
+    static constexpr std::size_t MAX_BUFFERED_EVENTS = 1000;
+
+private:
+    std::string m_symbol{};
+    /// Ascending prices, the best bid is the last one
+    std::vector<OrderBookLevel> m_bids{};
+    /// Descending prices, the best ask is the last one
+    std::vector<OrderBookLevel> m_asks{};
+    std::deque<EventDepthUpdate> m_buffer{};
+    std::int64_t m_lastUpdateId{-1};
+    std::int64_t m_updateTime{};
+    std::int64_t m_transactionTime{};
+    bool m_synced{false};
+    /// Snapshot is loaded, no event has been applied on it yet
+    bool m_awaitingFirstEvent{false};
+
+    /**
+     * @return false if the event does not follow the book
+     */
+    bool applyEvent(const EventDepthUpdate &event);
+
+    void unsync();
+
+public:
+    explicit OrderBook(std::string symbol = {});
+
+    [[nodiscard]] const std::string &symbol() const {
+        return m_symbol;
+    }
+
+    /**
+     * @return true if the book reflects the stream, levels of an unsynced book are empty
+     */
+    [[nodiscard]] bool synced() const {
+        return m_synced;
+    }
+
+    /**
+     * @return update id of the last applied event or of the snapshot, -1 if not synced
+     */
+    [[nodiscard]] std::int64_t lastUpdateId() const {
+        return m_lastUpdateId;
+    }
+
+    /**
+     * @return event time of the last applied event or of the snapshot in ms
+     */
+    [[nodiscard]] std::int64_t updateTime() const {
+        return m_updateTime;
+    }
+
+    /**
+     * @return transaction time of the last applied event or of the snapshot in ms
+     */
+    [[nodiscard]] std::int64_t transactionTime() const {
+        return m_transactionTime;
+    }
+
+    /**
+     * Load the snapshot and apply the buffered events following it
+     * @param snapshot REST depth, see RESTClient::getOrderBook()
+     * @return false if the snapshot does not connect to the buffered events, the book stays unsynced - request
+     * a newer snapshot
+     */
+    bool applySnapshot(const OrderBookSnapshot &snapshot);
+
+    /**
+     * Apply the event to a synced book, buffer it otherwise
+     * @param event Diff. Book Depth Stream event
+     * @return false if the book needs a snapshot - the event is the first one buffered by the unsynced book, e.g. the
+     * first event of the stream or the one breaking the sequence
+     */
+    bool applyUpdate(const EventDepthUpdate &event);
+
+    /**
+     * Unsync the book and drop the buffered events, e.g. after an interruption of the stream
+     */
+    void reset();
+
+    [[nodiscard]] std::size_t bidDepth() const {
+        return m_bids.size();
+    }
+
+    [[nodiscard]] std::size_t askDepth() const {
+        return m_asks.size();
+    }
+
+    /**
+     * @return best bid, nullptr if there is none
+     */
+    [[nodiscard]] const OrderBookLevel *bestBid() const {
+        return m_bids.empty() ? nullptr : &m_bids.back();
+    }
+
+    /**
+     * @return best ask, nullptr if there is none
+     */
+    [[nodiscard]] const OrderBookLevel *bestAsk() const {
+        return m_asks.empty() ? nullptr : &m_asks.back();
+    }
+
+    /**
+     * @param level 0 is the best bid
+     * @throws std::out_of_range if there are not so many levels
+     */
+    [[nodiscard]] const OrderBookLevel &bid(std::size_t level) const;
+
+    /**
+     * @param level 0 is the best ask
+     * @throws std::out_of_range if there are not so many levels
+     */
+    [[nodiscard]] const OrderBookLevel &ask(std::size_t level) const;
+
+    /**
+     * @return bid quantity at the price, 0 if there is no such level
+     */
+    [[nodiscard]] double bidQuantity(double price) const;
+
+    /**
+     * @return ask quantity at the price, 0 if there is no such level
+     */
+    [[nodiscard]] double askQuantity(double price) const;
+
+    /**
+     * @param depth maximal number of levels of each side, 0 for all
+     * @return copy of the book, levels are ordered from the best price
+     */
+    [[nodiscard]] OrderBookSnapshot snapshot(std::size_t depth = 0) const;
+};
+}
+#endif //INCLUDE_STONKY_BINANCE_ORDER_BOOK_H
@@ -0,0 +1,74 @@
+/**
+Binance Parallel Multi-Symbol Fetch
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_PARALLEL_FETCH_H
+#define INCLUDE_STONKY_BINANCE_PARALLEL_FETCH_H
+
+#include "binance_json_parser.h"
+#include "binance_models.h"
+#include <boost/system/system_error.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace stonky::binance::futures {
+/**
+ * Run fn for every symbol on at most maxParallelRequests threads
+ * @return error record for every symbol for which fn has thrown
+ */
+template<typename Fn>
+std::vector<FetchError>
+forEachSymbol(const std::vector<std::string> &symbols, const std::size_t maxParallelRequests, const Fn &fn) {
+    std::vector<FetchError> retVal;
+    std::mutex locker;
+    std::atomic<std::size_t> nextSymbol = 0;
+
+    const auto numWorkers = std::min(std::max<std::size_t>(maxParallelRequests, 1), symbols.size());
+    std::vector<std::future<void> > workers;
+
+    for (std::size_t i = 0; i < numWorkers; i++) {
+        workers.push_back(std::async(std::launch::async, [&] {
+            for (auto idx = nextSymbol++; idx < symbols.size(); idx = nextSymbol++) {
+                const auto &symbol = symbols[idx];
+                FetchError error{symbol};
+
+                try {
+                    fn(symbol);
+                    continue;
+                } catch (const nlohmann::json::exception &e) {
+                    error.type = FetchErrorType::Parse;
+                    error.message = e.what();
+                } catch (const JsonParseError &e) {
+                    error.type = FetchErrorType::Parse;
+                    error.message = e.what();
+                } catch (const boost::system::system_error &e) {
+                    error.type = FetchErrorType::Network;
+                    error.message = e.what();
+                } catch (const std::exception &e) {
+                    error.type = FetchErrorType::Api;
+                    error.message = e.what();
+                }
+
+                std::lock_guard lk(locker);
+                retVal.push_back(std::move(error));
+            }
+        }));
+    }
+
+    for (auto &worker: workers) {
+        worker.get();
+    }
+
+    return retVal;
+}
+}
+#endif //INCLUDE_STONKY_BINANCE_PARALLEL_FETCH_H
@@ -0,0 +1,77 @@
+/**
+Binance Compile-Time Perfect Hash
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_PERFECT_HASH_H
+#define INCLUDE_STONKY_BINANCE_PERFECT_HASH_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+
+namespace stonky::binance {
+/**
+ * Seeded FNV-1a with a final avalanche, low bits of plain FNV-1a do not depend on the seed for one-letter keys
+ */
+constexpr std::uint32_t perfectHashKey(const std::string_view key, const std::uint32_t seed) {
+    std::uint32_t hash = 2166136261U ^ seed;
+
+    for (const auto c: key) {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= 16777619U;
+    }
+
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6BU;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+/**
+ * Collision-free key to index table built at compile time, keys are compared on lookup so unknown keys are rejected
+ */
+template<std::size_t N>
+class PerfectHashIndex {
+    static constexpr std::size_t SIZE = std::max<std::size_t>(std::bit_ceil(N * 2), 2);
+    static constexpr std::uint8_t EMPTY = 0xFF;
+
+    std::array<std::string_view, N> m_keys{};
+    std::array<std::uint8_t, SIZE> m_slots{};
+    std::uint32_t m_seed{0};
+
+public:
+    static_assert(N < EMPTY, "Too many keys");
+
+    explicit constexpr PerfectHashIndex(const std::array<std::string_view, N> &keys) : m_keys(keys) {
+        for (;; m_seed++) {
+            m_slots.fill(EMPTY);
+            bool collision = false;
+
+            for (std::size_t i = 0; i < N && !collision; i++) {
+                auto &slot = m_slots[perfectHashKey(m_keys[i], m_seed) & (SIZE - 1)];
+                collision = slot != EMPTY;
+                slot = static_cast<std::uint8_t>(i);
+            }
+
+            if (!collision) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @return key index, N if the key is not in the table
+     */
+    [[nodiscard]] constexpr std::size_t find(const std::string_view key) const {
+        const auto index = m_slots[perfectHashKey(key, m_seed) & (SIZE - 1)];
+        return index != EMPTY && m_keys[index] == key ? index : N;
+    }
+};
+}
+#endif //INCLUDE_STONKY_BINANCE_PERFECT_HASH_H
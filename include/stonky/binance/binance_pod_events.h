@@ -0,0 +1,124 @@
+/**
+Binance Compact Market Data Events
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_POD_EVENTS_H
+#define INCLUDE_STONKY_BINANCE_POD_EVENTS_H
+
+#include "binance_event_models.h"
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Trivially copyable counterparts of the market data events - no virtual functions, no heap, the symbol is stored
+ * inline. They can be copied by memcpy, passed through lock-free queues or placed into shared memory.
+ * They are packed, not padded to the cache line: 72, 80 and 136 bytes instead of 128, 128 and 192 with alignas(64).
+ * Buffers keep many events and scan them in order, where dense packing pays off more than alignment. Containers that
+ * need one event per cache line align their slots themselves, see TradeBuffer.
+ */
+namespace stonky::binance::futures {
+/**
+ * Symbol stored inline, zero terminated
+ */
+struct FixedSymbol {
+    static constexpr std::size_t CAPACITY = 15;
+
+    std::array<char, CAPACITY + 1> chars{};
+
+    FixedSymbol() = default;
+
+    /**
+     * @param symbol e.g. BTCUSDT
+     * @throws std::invalid_argument if the symbol is longer than CAPACITY
+     */
+    explicit FixedSymbol(std::string_view symbol);
+
+    [[nodiscard]] std::string_view view() const;
+
+    [[nodiscard]] bool empty() const {
+        return chars[0] == '\0';
+    }
+
+    bool operator==(const FixedSymbol &other) const = default;
+};
+
+struct PodEventTickPrice {
+    FixedSymbol s{}; /// symbol
+    std::int64_t E{}; /// event time
+    std::int64_t T{}; /// transaction time
+    std::int64_t u{}; /// order book updateId
+    double b{}; /// best bid price
+    double B{}; /// bid qty
+    double a{}; /// best ask price
+    double A{}; /// ask qty
+};
+
+struct PodEventAggregatedTrade {
+    FixedSymbol s{}; /// symbol
+    std::int64_t E{}; /// event time
+    std::int64_t T{}; /// trade time
+    std::int64_t a{}; /// aggregate trade ID
+    std::int64_t f{}; /// first trade ID
+    std::int64_t l{}; /// last trade ID
+    double p{}; /// price
+    double q{}; /// quantity
+    bool m{false}; /// is the buyer the market maker?
+};
+
+struct PodEventCandlestick {
+    FixedSymbol s{}; /// symbol
+    std::int64_t E{}; /// event time
+    std::int64_t t{}; /// kline start time
+    std::int64_t T{}; /// kline close time
+    std::int64_t f{}; /// first trade ID
+    std::int64_t L{}; /// last trade ID
+    std::int64_t n{}; /// number of trades
+    double o{}; /// open price
+    double h{}; /// high price
+    double l{}; /// low price
+    double c{}; /// close price
+    double v{}; /// base asset volume
+    double q{}; /// quote asset volume
+    double V{}; /// taker buy base asset volume
+    double Q{}; /// taker buy quote asset volume
+    CandleInterval i{CandleInterval::_1m}; /// interval
+    bool x{false}; /// is this kline closed?
+};
+
+static_assert(std::is_trivially_copyable_v<PodEventTickPrice> && std::is_standard_layout_v<PodEventTickPrice>);
+static_assert(std::is_trivially_copyable_v<PodEventAggregatedTrade> &&
+              std::is_standard_layout_v<PodEventAggregatedTrade>);
+static_assert(std::is_trivially_copyable_v<PodEventCandlestick> && std::is_standard_layout_v<PodEventCandlestick>);
+/// Layout is part of the shared memory contract, a new field has to be a deliberate change
+static_assert(sizeof(PodEventTickPrice) == 72);
+static_assert(sizeof(PodEventAggregatedTrade) == 80);
+static_assert(sizeof(PodEventCandlestick) == 136);
+
+/**
+ * @throws std::invalid_argument if the symbol is longer than FixedSymbol::CAPACITY
+ */
+PodEventTickPrice toPod(const EventTickPrice &event);
+
+/**
+ * @throws std::invalid_argument if the symbol is longer than FixedSymbol::CAPACITY
+ */
+PodEventAggregatedTrade toPod(const EventAggregatedTrade &event);
+
+/**
+ * @throws std::invalid_argument if the symbol is longer than FixedSymbol::CAPACITY
+ */
+PodEventCandlestick toPod(const EventCandlestick &event);
+
+EventTickPrice fromPod(const PodEventTickPrice &event);
+
+EventAggregatedTrade fromPod(const PodEventAggregatedTrade &event);
+
+EventCandlestick fromPod(const PodEventCandlestick &event);
+}
+#endif //INCLUDE_STONKY_BINANCE_POD_EVENTS_H
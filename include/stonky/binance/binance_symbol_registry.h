@@ -0,0 +1,74 @@
+/**
+Binance Symbol Registry
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_SYMBOL_REGISTRY_H
+#define INCLUDE_STONKY_BINANCE_SYMBOL_REGISTRY_H
+
+#include "binance_models.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace stonky::binance {
+/**
+ * Dense integer id of a symbol, ids are assigned from 0 in the order of interning and never reused
+ */
+using SymbolId = std::uint32_t;
+
+/**
+ * Process-wide symbol interning. Once interned, a symbol keeps its id and its name stays valid for the lifetime of
+ * the process. Lookups take std::string_view, e.g. the raw "s" field of a WebSocket frame, and do not allocate.
+ * Thread-safe.
+ */
+class SymbolRegistry {
+    struct P;
+    std::unique_ptr<P> m_p{};
+
+    SymbolRegistry();
+
+public:
+    SymbolRegistry(const SymbolRegistry &) = delete;
+
+    SymbolRegistry &operator=(const SymbolRegistry &) = delete;
+
+    ~SymbolRegistry();
+
+    static SymbolRegistry &instance();
+
+    /**
+     * @param symbol e.g. BTCUSDT
+     * @return id of the symbol, a new id is assigned to an unknown symbol
+     */
+    SymbolId intern(std::string_view symbol) const;
+
+    /**
+     * Intern all symbols of the exchange info
+     */
+    void intern(const futures::Exchange &exchange) const;
+
+    /**
+     * @param symbol e.g. BTCUSDT
+     * @return id of the symbol, nullopt if the symbol was not interned
+     */
+    [[nodiscard]] std::optional<SymbolId> find(std::string_view symbol) const;
+
+    /**
+     * @param symbolId interned id
+     * @return symbol name
+     * @throws std::out_of_range if the id was not assigned
+     */
+    [[nodiscard]] std::string_view name(SymbolId symbolId) const;
+
+    /**
+     * @return number of interned symbols, all ids are lower
+     */
+    [[nodiscard]] std::size_t size() const;
+};
+}
+#endif //INCLUDE_STONKY_BINANCE_SYMBOL_REGISTRY_H
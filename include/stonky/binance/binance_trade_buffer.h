@@ -0,0 +1,88 @@
+/**
+Binance Futures Aggregated Trade Buffer
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#ifndef INCLUDE_STONKY_BINANCE_TRADE_BUFFER_H
+#define INCLUDE_STONKY_BINANCE_TRADE_BUFFER_H
+
+#include "binance_pod_events.h"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace stonky::binance::futures {
+/**
+ * Trades of a time window, see TradeBuffer::statistics()
+ */
+struct TradeStatistics {
+    std::int64_t count{}; /// number of trades
+    double volume{}; /// base asset volume
+    double quoteVolume{}; /// quote asset volume
+    double vwap{}; /// volume weighted average price, 0 if there is no trade
+    bool complete{true}; /// false if older trades of the window were already overwritten
+};
+
+/**
+ * Fixed-capacity ring of the latest aggregated trades of one symbol, written by a single thread and read by any number
+ * of threads without locks. The writer never waits for readers - every slot carries a sequence number and a read
+ * overlapped by a write of the same slot is detected and dropped (seqlock).
+ * Every slot keeps the cumulative volumes up to its trade as well, so statistics of a time window take a binary search
+ * and two slot reads regardless of the number of trades in the window.
+ */
+class TradeBuffer final {
+    struct P;
+    std::unique_ptr<P> m_p{};
+
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 4096;
+
+    TradeBuffer(const TradeBuffer &) = delete;
+
+    TradeBuffer &operator=(const TradeBuffer &) = delete;
+
+    /**
+     * @param capacity number of kept trades, rounded up to a power of two
+     */
+    explicit TradeBuffer(std::size_t capacity = DEFAULT_CAPACITY);
+
+    ~TradeBuffer();
+
+    [[nodiscard]] std::size_t capacity() const;
+
+    /**
+     * Append the trade, the oldest one is overwritten when the buffer is full. Must be called by one thread only.
+     * @param trade trades are expected in the order of the stream, i.e. by trade time
+     */
+    void push(const PodEventAggregatedTrade &trade) const;
+
+    /**
+     * @return number of trades pushed since the creation
+     */
+    [[nodiscard]] std::uint64_t size() const;
+
+    /**
+     * Copy the latest trades, nothing is allocated
+     * @param trades filled with up to trades.size() latest trades, the oldest first
+     * @return number of copied trades
+     */
+    std::size_t latest(std::span<PodEventAggregatedTrade> trades) const;
+
+    /**
+     * @param count maximal number of trades
+     * @return up to count latest trades, the oldest first
+     */
+    [[nodiscard]] std::vector<PodEventAggregatedTrade> latest(std::size_t count) const;
+
+    /**
+     * @param startTime trade time in ms INCLUSIVE, the window ends with the latest trade
+     * @return volumes and VWAP of the trades in the window
+     */
+    [[nodiscard]] TradeStatistics statistics(std::int64_t startTime) const;
+};
+}
+#endif //INCLUDE_STONKY_BINANCE_TRADE_BUFFER_H
@@ -12,23 +12,34 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 #include <stonky/utils/log_utils.h>
 #include "binance_event_models.h"
 #include "binance_models.h"
+#include "binance_order_book.h"
+#include "binance_symbol_registry.h"
+#include "binance_trade_buffer.h"
+#include <chrono>
 #include <optional>
 
 namespace stonky::binance::futures {
 class RESTClient;
 
+/// Stream name of the User Data Stream in EventStreamGap, the listenKey is not exposed
+static constexpr auto USER_DATA_STREAM = "userData";
+
 class WSStreamManager {
     struct P;
     std::unique_ptr<P> m_p{};
 
 public:
-    explicit WSStreamManager(const std::weak_ptr<RESTClient> &restClient);
+    /**
+     * @param restClient
+     * @param numIoThreads number of WebSocket IO threads, see WebSocketClient
+     */
+    explicit WSStreamManager(const std::weak_ptr<RESTClient> &restClient, std::size_t numIoThreads = 1);
 
     ~WSStreamManager();
 
     /**
      * Check if the Book Ticker Stream is subscribed for a selected pair, if not then subscribe it. When force parameter
-     * is true then re-subscribe if already subscribed
+     * is true then re-subscribe if already subscribed. Nothing is subscribed while the All Book Tickers Stream is.
      * @param pair e.g BTCUSDT
      * @param force If true then re-subscribe if already subscribed
      */
@@ -43,6 +54,62 @@ public:
      */
     void subscribeCandlestickStream(const std::string &pair, CandleInterval interval, bool force = false) const;
 
+    /**
+     * Check if the Aggregate Trade Stream is subscribed for a selected pair, if not then subscribe it. Trades are kept
+     * in a fixed-capacity TradeBuffer of the pair, frames are parsed into it without allocation.
+     * @param pair e.g BTCUSDT
+     * @param capacity number of kept trades
+     */
+    void subscribeAggTradeStream(const std::string &pair, std::size_t capacity = TradeBuffer::DEFAULT_CAPACITY) const;
+
+    /**
+     * Check if the Partial Book Depth Stream is subscribed for a selected pair, if not then subscribe it
+     * @param pair e.g BTCUSDT
+     * @param depth stream depth 5, 10 or 20
+     * @throws std::invalid_argument if the depth is not 5, 10 or 20
+     */
+    void subscribeDepthStream(const std::string &pair, int depth) const;
+
+    /**
+     * Keep a local order book of the pair from the depth snapshot and the Diff. Book Depth Stream if not kept yet.
+     * Snapshots are obtained by the REST client from a background thread, a new one whenever the update sequence
+     * breaks or the stream is interrupted. Interruptions are reported to the stream gap callback.
+     * @param pair e.g. BTCUSDT
+     */
+    void subscribeOrderBook(const std::string &pair) const;
+
+    /**
+     * Check if the All Book Tickers Stream is subscribed, if not then subscribe it. One connection then carries tickers
+     * of all symbols for readEventTickPrice(), Book Ticker Streams of single pairs are unsubscribed.
+     */
+    void subscribeAllBookTickers() const;
+
+    /**
+     * Check if the All Market Mark Price Stream is subscribed, if not then subscribe it. Mark prices and funding rates
+     * of all symbols are cached every second, see readEventMarkPrice() and readMarkPrices().
+     */
+    void subscribeAllMarkPrices() const;
+
+    /**
+     * Check if the All Market Mini Tickers Stream is subscribed, if not then subscribe it, see readEventMiniTicker()
+     */
+    void subscribeAllMiniTickers() const;
+
+    /**
+     * Connect to the User Data Stream if not connected yet. The listenKey is obtained by the REST client and kept
+     * alive every 30 minutes from a background thread, an expired or rejected listenKey is replaced and the stream
+     * reconnected. Interruptions are reported to the stream gap callback as stream USER_DATA_STREAM, re-read account
+     * and positions by REST then - events pushed in the meantime are lost.
+     * @param onUserDataCB called from a WebSocket IO thread with every event
+     * @throws nlohmann::json::exception, std::exception if the listenKey cannot be obtained
+     */
+    void subscribeUserDataStream(const onUserData &onUserDataCB) const;
+
+    /**
+     * Disconnect the User Data Stream and close its listenKey
+     */
+    void unsubscribeUserDataStream() const;
+
     /**
      * Set time of all reading operations
      * @param seconds
@@ -61,6 +128,19 @@ public:
      */
     void setLoggerCallback(const onLogMessage &onLogMessageCB) const;
 
+    /**
+     * Set callback of stream interruptions. Failed connections are restored automatically. Data received before the
+     * interruption are dropped, so read methods wait for fresh events instead of returning stale ones. The gap of a
+     * Book Ticker Stream is reported with the first event after the reconnect to carry both update ids.
+     * @param onStreamGapCB called from a WebSocket IO thread
+     */
+    void setStreamGapCallback(const onStreamGap &onStreamGapCB) const;
+
+    /**
+     * @return stream interruptions reported since the previous call, at most 1000 latest
+     */
+    [[nodiscard]] std::vector<EventStreamGap> readStreamGaps() const;
+
     /**
      * Try to read EventTickPrice structure. It will block at most Timeout time.
      * @param pair e.g BTCUSDT
@@ -71,6 +151,14 @@ public:
     [[nodiscard]] std::optional<EventTickPrice> readEventTickPrice(const std::string &pair,
                                                                    bool consumeEvent = false) const;
 
+    /**
+     * Try to read EventTickPrice structure without symbol string lookups. It will block at most Timeout time.
+     * @param symbolId id from SymbolRegistry
+     * @param consumeEvent If true then the event is taken from the underlying list
+     * @return EventTickPrice structure if successful
+     */
+    [[nodiscard]] std::optional<EventTickPrice> readEventTickPrice(SymbolId symbolId, bool consumeEvent = false) const;
+
     /**
      * Try to read EventCandlestick structure. It will block at most Timeout time.
      * @param pair e.g BTCUSDT
@@ -80,6 +168,133 @@ public:
      */
     [[nodiscard]] std::optional<EventCandlestick>
     readEventCandlestick(const std::string &pair, CandleInterval interval, bool previous = false) const;
+
+    /**
+     * Try to read EventCandlestick structure without symbol string lookups. It will block at most Timeout time.
+     * @param symbolId id from SymbolRegistry
+     * @param interval e.g CandleInterval::_1m
+     * @param previous if true then return interval-1 candle
+     * @return EventCandlestick structure if successful
+     */
+    [[nodiscard]] std::optional<EventCandlestick>
+    readEventCandlestick(SymbolId symbolId, CandleInterval interval, bool previous = false) const;
+
+    /**
+     * Get trade buffer of the pair. Reads of the buffer take no lock, keep it instead of looking it up repeatedly.
+     * Trades pushed during stream interruptions are missing, see setStreamGapCallback().
+     * @param pair e.g BTCUSDT
+     * @return nullptr if the Aggregate Trade Stream of the pair is not subscribed
+     */
+    [[nodiscard]] std::shared_ptr<const TradeBuffer> aggTradeBuffer(const std::string &pair) const;
+
+    /**
+     * Get trade buffer of the pair without symbol string lookups
+     * @param symbolId id from SymbolRegistry
+     * @return nullptr if the Aggregate Trade Stream of the pair is not subscribed
+     */
+    [[nodiscard]] std::shared_ptr<const TradeBuffer> aggTradeBuffer(SymbolId symbolId) const;
+
+    /**
+     * Read the latest aggregated trades, returns immediately
+     * @param pair e.g BTCUSDT
+     * @param count maximal number of trades
+     * @return trades ordered from the oldest, empty if the stream is not subscribed
+     */
+    [[nodiscard]] std::vector<PodEventAggregatedTrade> readAggregatedTrades(const std::string &pair,
+                                                                          std::size_t count) const;
+
+    /**
+     * Read volumes and VWAP of the trades of the latest time window, returns immediately
+     * @param pair e.g BTCUSDT
+     * @param window window length, it ends at the current local time
+     * @return statistics of the window, nullopt if the stream is not subscribed
+     */
+    [[nodiscard]] std::optional<TradeStatistics> readTradeStatistics(const std::string &pair,
+                                                                     std::chrono::milliseconds window) const;
+
+    /**
+     * Try to read the latest EventDepth structure of the Partial Book Depth Stream. It will block at most Timeout time.
+     * Levels are stored inline, so the read does not allocate.
+     * @param pair e.g BTCUSDT
+     * @param depth stream depth 5, 10 or 20
+     * @return EventDepth structure if successful
+     * @throws std::invalid_argument if the depth is not 5, 10 or 20
+     */
+    [[nodiscard]] std::optional<EventDepth> readEventDepth(const std::string &pair, int depth) const;
+
+    /**
+     * Try to read the latest EventDepth structure without symbol string lookups. It will block at most Timeout time.
+     * @param symbolId id from SymbolRegistry
+     * @param depth stream depth 5, 10 or 20
+     * @return EventDepth structure if successful
+     * @throws std::invalid_argument if the depth is not 5, 10 or 20
+     */
+    [[nodiscard]] std::optional<EventDepth> readEventDepth(SymbolId symbolId, int depth) const;
+
+    /**
+     * Try to read top levels of the local order book. It will block at most Timeout time while the book is not synced.
+     * @param pair e.g. BTCUSDT
+     * @param depth maximal number of levels of each side, 0 for all
+     * @return levels ordered from the best price, lastUpdateId is u of the last applied event
+     */
+    [[nodiscard]] std::optional<OrderBookSnapshot> readOrderBook(const std::string &pair, std::size_t depth = 20) const;
+
+    /**
+     * Try to read top levels of the local order book without symbol string lookups. It will block at most Timeout
+     * time while the book is not synced.
+     * @param symbolId id from SymbolRegistry
+     * @param depth maximal number of levels of each side, 0 for all
+     * @return levels ordered from the best price, lastUpdateId is u of the last applied event
+     */
+    [[nodiscard]] std::optional<OrderBookSnapshot> readOrderBook(SymbolId symbolId, std::size_t depth = 20) const;
+
+    /**
+     * Try to read the latest EventMarkPrice structure of the All Market Mark Price Stream. It will block at most
+     * Timeout time, it returns at once if the pair is not in SymbolRegistry, i.e. neither in Exchange info nor
+     * received by any stream yet.
+     * @param pair e.g BTCUSDT
+     * @return EventMarkPrice structure if successful
+     */
+    [[nodiscard]] std::optional<EventMarkPrice> readEventMarkPrice(const std::string &pair) const;
+
+    /**
+     * Try to read the latest EventMarkPrice structure without symbol string lookups. It will block at most Timeout
+     * time.
+     * @param symbolId id from SymbolRegistry
+     * @return EventMarkPrice structure if successful
+     */
+    [[nodiscard]] std::optional<EventMarkPrice> readEventMarkPrice(SymbolId symbolId) const;
+
+    /**
+     * Read mark prices and funding rates of all symbols cached from the All Market Mark Price Stream, a replacement of
+     * RESTClient::getMarkPrices() polling. It will block at most Timeout time while the cache is empty.
+     * @return MarkPrice structures, interestRate is not streamed and stays 0
+     */
+    [[nodiscard]] std::vector<MarkPrice> readMarkPrices() const;
+
+    /**
+     * Read cached mark prices and funding rates of all symbols without waiting. Entries older than maxAge are dropped
+     * from the cache, e.g. of symbols delisted or settled since they were received.
+     * @param maxAge maximal age of the event time
+     * @return MarkPrice structures, empty if the cache is empty or stale
+     */
+    [[nodiscard]] std::vector<MarkPrice> readMarkPrices(std::chrono::milliseconds maxAge) const;
+
+    /**
+     * Try to read the latest EventMiniTicker structure of the All Market Mini Tickers Stream. It will block at most
+     * Timeout time, it returns at once if the pair is not in SymbolRegistry.
+     * @param pair e.g BTCUSDT
+     * @return EventMiniTicker structure if successful
+     */
+    [[nodiscard]] std::optional<EventMiniTicker> readEventMiniTicker(const std::string &pair) const;
+
+    /**
+     * Try to read the latest EventMiniTicker structure without symbol string lookups. It will block at most Timeout
+     * time.
+     * @param symbolId id from SymbolRegistry
+     * @return EventMiniTicker structure if successful
+     */
+    [[nodiscard]] std::optional<EventMiniTicker> readEventMiniTicker(SymbolId symbolId) const;
 };
 }
 
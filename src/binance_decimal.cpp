@@ -0,0 +1,213 @@
+/**
+Binance Fixed-Point Decimal
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_decimal.h"
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace stonky::binance {
+static constexpr std::int64_t MAX_VALUE = std::numeric_limits<std::int64_t>::max();
+static constexpr std::int64_t MIN_VALUE = std::numeric_limits<std::int64_t>::min();
+
+static void checkScale(const std::int32_t scale) {
+    if (scale < 0 || scale > Decimal::MAX_SCALE) {
+        throw std::invalid_argument("Decimal scale out of range: " + std::to_string(scale));
+    }
+}
+
+/**
+ * Add one digit to the magnitude, the magnitude is kept non-negative
+ */
+static void appendDigit(std::int64_t &magnitude, const std::int64_t digit, const std::string_view str) {
+    if (magnitude > (MAX_VALUE - digit) / 10) {
+        throw std::out_of_range("Decimal overflow: " + std::string(str));
+    }
+
+    magnitude = magnitude * 10 + digit;
+}
+
+/**
+ * Divide rounding half away from zero
+ * @param divisor positive divisor
+ */
+template<typename T>
+static T divideRounded(const T value, const T divisor) {
+    const auto quotient = value / divisor;
+    const auto remainder = value % divisor;
+
+    if (remainder >= divisor - remainder) {
+        return quotient + 1;
+    }
+
+    if (-remainder >= divisor + remainder) {
+        return quotient - 1;
+    }
+
+    return quotient;
+}
+
+Decimal Decimal::fromString(const std::string_view str, const std::int32_t scale) {
+    checkScale(scale);
+
+    std::size_t pos = 0;
+    const bool negative = !str.empty() && str[0] == '-';
+
+    if (negative || (!str.empty() && str[0] == '+')) {
+        pos++;
+    }
+
+    std::int64_t magnitude = 0;
+    std::int32_t decimals = 0;
+    bool hasDigits = false;
+    bool hasPoint = false;
+    bool roundUp = false;
+
+    for (; pos < str.size(); pos++) {
+        const auto c = str[pos];
+
+        if (c == '.' && !hasPoint) {
+            hasPoint = true;
+            continue;
+        }
+
+        if (c < '0' || c > '9') {
+            throw std::invalid_argument("Invalid decimal: " + std::string(str));
+        }
+
+        hasDigits = true;
+
+        if (!hasPoint || decimals < scale) {
+            appendDigit(magnitude, c - '0', str);
+            decimals += hasPoint ? 1 : 0;
+        } else if (decimals++ == scale) {
+            roundUp = c >= '5';
+        }
+    }
+
+    if (!hasDigits) {
+        throw std::invalid_argument("Invalid decimal: " + std::string(str));
+    }
+
+    for (; decimals < scale; decimals++) {
+        appendDigit(magnitude, 0, str);
+    }
+
+    if (roundUp) {
+        if (magnitude == MAX_VALUE) {
+            throw std::out_of_range("Decimal overflow: " + std::string(str));
+        }
+
+        magnitude++;
+    }
+
+    return {negative ? -magnitude : magnitude, scale};
+}
+
+Decimal Decimal::fromString(const std::string_view str) {
+    const auto point = str.find('.');
+    const auto decimals = point == std::string_view::npos ? 0 : str.size() - point - 1;
+    return fromString(str, static_cast<std::int32_t>(std::min<std::size_t>(decimals, MAX_SCALE)));
+}
+
+Decimal Decimal::fromDouble(const double value, const std::int32_t scale) {
+    checkScale(scale);
+    const auto scaled = std::round(value * static_cast<double>(POW10[scale]));
+
+    if (!std::isfinite(scaled) || std::abs(scaled) >= static_cast<double>(MAX_VALUE)) {
+        throw std::out_of_range("Decimal overflow: " + std::to_string(value));
+    }
+
+    return {static_cast<std::int64_t>(scaled), scale};
+}
+
+double Decimal::toDouble() const {
+    return static_cast<double>(m_value) / static_cast<double>(POW10[m_scale]);
+}
+
+std::string Decimal::toString() const {
+    std::string result;
+    appendTo(result);
+    return result;
+}
+
+void Decimal::appendTo(std::string &out) const {
+    /// Magnitude in unsigned arithmetic, -INT64_MIN does not fit into int64
+    const auto magnitude = m_value < 0
+                           ? 0 - static_cast<std::uint64_t>(m_value)
+                           : static_cast<std::uint64_t>(m_value);
+    const auto divisor = static_cast<std::uint64_t>(POW10[m_scale]);
+
+    std::array<char, 24> buffer{};
+    auto *end = buffer.data();
+
+    if (m_value < 0) {
+        *end++ = '-';
+    }
+
+    end = std::to_chars(end, buffer.data() + buffer.size(), magnitude / divisor).ptr;
+    out.append(buffer.data(), end);
+
+    if (m_scale > 0) {
+        const auto fraction = std::to_chars(buffer.data(), buffer.data() + buffer.size(), magnitude % divisor).ptr;
+        const auto fractionSize = static_cast<std::size_t>(fraction - buffer.data());
+        out.push_back('.');
+        out.append(static_cast<std::size_t>(m_scale) - fractionSize, '0');
+        out.append(buffer.data(), fraction);
+    }
+}
+
+Decimal Decimal::rescale(const std::int32_t scale) const {
+    checkScale(scale);
+
+    if (scale >= m_scale) {
+        return {valueAt(scale), scale};
+    }
+
+    return {divideRounded(m_value, POW10[m_scale - scale]), scale};
+}
+
+Decimal Decimal::truncateToStep(const Decimal &step) const {
+    if (step.m_value <= 0) {
+        throw std::invalid_argument("Decimal step has to be positive: " + step.toString());
+    }
+
+    const auto scale = std::max(m_scale, step.m_scale);
+    const auto stepValue = step.valueAt(scale);
+    return {valueAt(scale) / stepValue * stepValue, scale};
+}
+
+Decimal Decimal::roundToStep(const Decimal &step) const {
+    if (step.m_value <= 0) {
+        throw std::invalid_argument("Decimal step has to be positive: " + step.toString());
+    }
+
+    const auto scale = std::max(m_scale, step.m_scale);
+    const auto stepValue = step.valueAt(scale);
+    return {multiplyChecked(divideRounded(valueAt(scale), stepValue), stepValue), scale};
+}
+
+Decimal Decimal::operator*(const Decimal &other) const {
+    const auto scale = m_scale + other.m_scale;
+    const auto excess = std::max(scale - MAX_SCALE, 0);
+
+#ifdef __SIZEOF_INT128__
+    const auto product = divideRounded(static_cast<__int128>(m_value) * other.m_value,
+                                       static_cast<__int128>(POW10[excess]));
+
+    if (product > MAX_VALUE || product < MIN_VALUE) {
+        throw std::out_of_range("Decimal overflow: " + toString() + " * " + other.toString());
+    }
+
+    return {static_cast<std::int64_t>(product), scale - excess};
+#else
+    return {divideRounded(multiplyChecked(m_value, other.m_value), POW10[excess]), scale - excess};
+#endif
+}
+}
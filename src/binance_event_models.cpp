@@ -9,6 +9,146 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 #include "stonky/binance/binance_event_models.h"
 #include "stonky/utils/utils.h"
 #include "stonky/utils/json_utils.h"
+#include "stonky/binance/binance_json_parser.h"
+#include "stonky/binance/binance_enum_parser.h"
+#include "stonky/binance/binance_model_fields.h"
+
+namespace stonky::binance {
+template<>
+struct ModelFields<futures::EventTickPrice> {
+    static constexpr std::tuple FIELDS{
+        field("e", &futures::Event::e),
+        field("E", &futures::Event::E),
+        field("u", &futures::EventTickPrice::u),
+        field("T", &futures::EventTickPrice::T),
+        field("s", &futures::EventTickPrice::s),
+        field("b", &futures::EventTickPrice::b),
+        field("B", &futures::EventTickPrice::B),
+        field("a", &futures::EventTickPrice::a),
+        field("A", &futures::EventTickPrice::A)
+    };
+};
+
+template<>
+struct ModelFields<futures::EventOrderUpdate> {
+    static constexpr std::tuple FIELDS{
+        field("e", &futures::Event::e),
+        field("E", &futures::Event::E),
+        field("s", &futures::EventOrderUpdate::s),
+        field("c", &futures::EventOrderUpdate::c),
+        field("S", &futures::EventOrderUpdate::S),
+        field("o", &futures::EventOrderUpdate::o),
+        field("f", &futures::EventOrderUpdate::f),
+        field("q", &futures::EventOrderUpdate::q),
+        field("p", &futures::EventOrderUpdate::p),
+        field("ap", &futures::EventOrderUpdate::ap),
+        field("sp", &futures::EventOrderUpdate::sp),
+        field("x", &futures::EventOrderUpdate::x),
+        field("X", &futures::EventOrderUpdate::X),
+        field("i", &futures::EventOrderUpdate::i),
+        field("l", &futures::EventOrderUpdate::l),
+        field("z", &futures::EventOrderUpdate::z),
+        field("L", &futures::EventOrderUpdate::L),
+        field("T", &futures::EventOrderUpdate::T),
+        field("t", &futures::EventOrderUpdate::t),
+        field("b", &futures::EventOrderUpdate::b),
+        field("a", &futures::EventOrderUpdate::a),
+        field("m", &futures::EventOrderUpdate::m),
+        field("R", &futures::EventOrderUpdate::R),
+        field("wt", &futures::EventOrderUpdate::wt),
+        field("ot", &futures::EventOrderUpdate::ot),
+        field("ps", &futures::EventOrderUpdate::ps),
+        field("cp", &futures::EventOrderUpdate::cp),
+        field("AP", &futures::EventOrderUpdate::AP),
+        field("cr", &futures::EventOrderUpdate::cr),
+        field("rp", &futures::EventOrderUpdate::rp)
+    };
+};
+
+template<>
+struct ModelFields<futures::EventBalanceUpdate> {
+    static constexpr std::tuple FIELDS{
+        field("a", &futures::EventBalanceUpdate::a),
+        field("wb", &futures::EventBalanceUpdate::wb),
+        field("cw", &futures::EventBalanceUpdate::cw),
+        field("bc", &futures::EventBalanceUpdate::bc)
+    };
+};
+
+template<>
+struct ModelFields<futures::EventAccountUpdate::Position> {
+    static constexpr std::tuple FIELDS{
+        field("s", &futures::EventAccountUpdate::Position::s),
+        field("pa", &futures::EventAccountUpdate::Position::pa),
+        field("ep", &futures::EventAccountUpdate::Position::ep),
+        field("bep", &futures::EventAccountUpdate::Position::bep),
+        field("cr", &futures::EventAccountUpdate::Position::cr),
+        field("up", &futures::EventAccountUpdate::Position::up),
+        field("mt", &futures::EventAccountUpdate::Position::mt),
+        field("iw", &futures::EventAccountUpdate::Position::iw),
+        field("ps", &futures::EventAccountUpdate::Position::ps)
+    };
+};
+
+template<>
+struct ModelFields<futures::EventMarginCall::Position> {
+    static constexpr std::tuple FIELDS{
+        field("s", &futures::EventMarginCall::Position::s),
+        field("ps", &futures::EventMarginCall::Position::ps),
+        field("pa", &futures::EventMarginCall::Position::pa),
+        field("mt", &futures::EventMarginCall::Position::mt),
+        field("iw", &futures::EventMarginCall::Position::iw),
+        field("mp", &futures::EventMarginCall::Position::mp),
+        field("up", &futures::EventMarginCall::Position::up),
+        field("mm", &futures::EventMarginCall::Position::mm)
+    };
+};
+
+template<>
+struct ModelFields<futures::EventAggregatedTrade> {
+    static constexpr std::tuple FIELDS{
+        field("e", &futures::Event::e),
+        field("E", &futures::Event::E),
+        field("s", &futures::EventAggregatedTrade::s),
+        field("a", &futures::EventAggregatedTrade::a),
+        field("p", &futures::EventAggregatedTrade::p),
+        field("q", &futures::EventAggregatedTrade::q),
+        field("f", &futures::EventAggregatedTrade::f),
+        field("l", &futures::EventAggregatedTrade::l),
+        field("T", &futures::EventAggregatedTrade::T),
+        field("m", &futures::EventAggregatedTrade::m)
+    };
+};
+
+template<>
+struct ModelFields<futures::EventMarkPrice> {
+    static constexpr std::tuple FIELDS{
+        field("e", &futures::Event::e),
+        field("E", &futures::Event::E),
+        field("s", &futures::EventMarkPrice::s),
+        field("p", &futures::EventMarkPrice::p),
+        field("i", &futures::EventMarkPrice::i),
+        field("P", &futures::EventMarkPrice::P),
+        field("r", &futures::EventMarkPrice::r),
+        field("T", &futures::EventMarkPrice::T)
+    };
+};
+
+/// Event type is not a field, 24hrMiniTicker is not an EventType name
+template<>
+struct ModelFields<futures::EventMiniTicker> {
+    static constexpr std::tuple FIELDS{
+        field("E", &futures::Event::E),
+        field("s", &futures::EventMiniTicker::s),
+        field("c", &futures::EventMiniTicker::c),
+        field("o", &futures::EventMiniTicker::o),
+        field("h", &futures::EventMiniTicker::h),
+        field("l", &futures::EventMiniTicker::l),
+        field("v", &futures::EventMiniTicker::v),
+        field("q", &futures::EventMiniTicker::q)
+    };
+};
+}
 
 namespace stonky::binance::futures {
 nlohmann::json Event::toJson() const {
@@ -19,115 +159,146 @@ nlohmann::json Event::toJson() const {
 }
 
 void Event::fromJson(const nlohmann::json &json) {
-    readMagicEnum<EventType>(json, "e", e);
+    readEnum(json, "e", e);
     readValue<std::int64_t>(json, "E", E);
 }
 
 nlohmann::json EventTickPrice::toJson() const {
-    nlohmann::json json = Event::toJson();
-    json["u"] = u;
-    json["s"] = s;
-    json["b"] = std::to_string(b);
-    json["B"] = std::to_string(B);
-    json["a"] = std::to_string(a);
-    json["A"] = std::to_string(A);
-    return json;
+    return writeFields(*this);
 }
 
 void EventTickPrice::fromJson(const nlohmann::json &json) {
-    Event::fromJson(json);
+    readFields(json, *this);
+}
 
-    readValue<std::int64_t>(json, "u", u);
-    readValue<std::int64_t>(json, "T", T);
-    readValue<std::string>(json, "s", s);
+nlohmann::json EventBalanceUpdate::toJson() const {
+    return writeFields(*this);
+}
 
-    b = readStringAsDouble(json, "b");
-    B = readStringAsDouble(json, "B");
-    a = readStringAsDouble(json, "a");
-    A = readStringAsDouble(json, "A");
+void EventBalanceUpdate::fromJson(const nlohmann::json &json) {
+    readFields(json, *this);
+}
+
+nlohmann::json EventAccountUpdate::Position::toJson() const {
+    return writeFields(*this);
+}
+
+void EventAccountUpdate::Position::fromJson(const nlohmann::json &json) {
+    readFields(json, *this);
 }
 
 nlohmann::json EventAccountUpdate::toJson() const {
-    throw std::runtime_error("Unimplemented: EventAccountUpdate::toJson()");
+    nlohmann::json json = Event::toJson();
+    json["T"] = T;
+
+    nlohmann::json update;
+    update["m"] = m;
+    update["B"] = nlohmann::json::array();
+    update["P"] = nlohmann::json::array();
+
+    for (const auto &balance: B) {
+        update["B"].push_back(balance.toJson());
+    }
+
+    for (const auto &position: P) {
+        update["P"].push_back(position.toJson());
+    }
+
+    json["a"] = std::move(update);
+    return json;
 }
 
 void EventAccountUpdate::fromJson(const nlohmann::json &json) {
     Event::fromJson(json);
+    readValue<std::int64_t>(json, "T", T);
+    B.clear();
+    P.clear();
+
+    if (const auto it = json.find("a"); it != json.end()) {
+        readValue<std::string>(*it, "m", m);
+
+        if (const auto itBalances = it->find("B"); itBalances != it->end()) {
+            for (const auto &el: *itBalances) {
+                auto &balance = B.emplace_back();
+                balance.fromJson(el);
+                balance.e = e;
+                balance.E = E;
+            }
+        }
+
+        if (const auto itPositions = it->find("P"); itPositions != it->end()) {
+            for (const auto &el: *itPositions) {
+                P.emplace_back().fromJson(el);
+            }
+        }
+    }
 }
 
-nlohmann::json EventBalanceUpdate::toJson() const {
-    throw std::runtime_error("Unimplemented: EventBalanceUpdate::toJson()");
+nlohmann::json EventMarginCall::Position::toJson() const {
+    return writeFields(*this);
 }
 
-void EventBalanceUpdate::fromJson(const nlohmann::json &json) {
+void EventMarginCall::Position::fromJson(const nlohmann::json &json) {
+    readFields(json, *this);
+}
+
+nlohmann::json EventMarginCall::toJson() const {
+    nlohmann::json json = Event::toJson();
+    json["cw"] = std::to_string(cw);
+    json["p"] = nlohmann::json::array();
+
+    for (const auto &position: p) {
+        json["p"].push_back(position.toJson());
+    }
+
+    return json;
+}
+
+void EventMarginCall::fromJson(const nlohmann::json &json) {
     Event::fromJson(json);
+    cw = readDecimal(json, "cw");
+    p.clear();
+
+    if (const auto it = json.find("p"); it != json.end()) {
+        for (const auto &el: *it) {
+            p.emplace_back().fromJson(el);
+        }
+    }
 }
 
-nlohmann::json EventOrderUpdate::toJson() const {
+nlohmann::json EventAccountConfigUpdate::toJson() const {
     nlohmann::json json = Event::toJson();
-    json["s"] = s;
-    json["c"] = c;
-    json["S"] = S;
-    json["o"] = o;
-    json["f"] = f;
-    json["q"] = std::to_string(q);
-    json["p"] = std::to_string(p);
-    json["ap"] = std::to_string(ap);
-    json["sp"] = std::to_string(sp);
-    json["x"] = x;
-    json["X"] = X;
-    json["i"] = i;
-    json["l"] = std::to_string(l);
-    json["z"] = std::to_string(z);
-    json["L"] = std::to_string(L);
     json["T"] = T;
-    json["t"] = t;
-    json["b"] = std::to_string(b);
-    json["a"] = std::to_string(a);
-    json["m"] = m;
-    json["R"] = R;
-    json["wt"] = wt;
-    json["ot"] = ot;
-    json["ps"] = ps;
-    json["cp"] = cp;
-    json["AP"] = std::to_string(AP);
-    json["cr"] = std::to_string(cr);
-    json["rp"] = std::to_string(rp);
+
+    if (s.empty()) {
+        json["ai"] = {{"j", j}};
+    } else {
+        json["ac"] = {{"s", s}, {"l", l}};
+    }
 
     return json;
 }
 
-void EventOrderUpdate::fromJson(const nlohmann::json &json) {
+void EventAccountConfigUpdate::fromJson(const nlohmann::json &json) {
     Event::fromJson(json);
-
-    readValue<std::string>(json, "s", s);
-    readValue<std::string>(json, "c", c);
-    readMagicEnum<Side>(json, "S", S);
-    readMagicEnum<OrderType>(json, "o", o);
-    readMagicEnum<TimeInForce>(json, "f", f);
-    q = readStringAsDouble(json, "q");
-    p = readStringAsDouble(json, "p");
-    ap = readStringAsDouble(json, "ap");
-    sp = readStringAsDouble(json, "sp");
-    readMagicEnum<ExecutionType>(json, "x", x);
-    readMagicEnum<OrderStatus>(json, "X", X);
-    readValue<std::int64_t>(json, "i", i);
-    l = readStringAsDouble(json, "l");
-    z = readStringAsDouble(json, "z");
-    L = readStringAsDouble(json, "L");
     readValue<std::int64_t>(json, "T", T);
-    readValue<std::int64_t>(json, "t", t);
-    b = readStringAsDouble(json, "b");
-    a = readStringAsDouble(json, "a");
-    readValue<bool>(json, "m", m);
-    readValue<bool>(json, "R", R);
-    readMagicEnum<WorkingType>(json, "wt", wt);
-    readMagicEnum<OrderType>(json, "ot", ot);
-    readMagicEnum<PositionSide>(json, "ps", ps);
-    readValue<bool>(json, "cp", cp);
-    AP = readStringAsDouble(json, "AP");
-    cr = readStringAsDouble(json, "cr");
-    rp = readStringAsDouble(json, "rp");
+
+    if (const auto it = json.find("ac"); it != json.end()) {
+        readValue<std::string>(*it, "s", s);
+        readValue<int>(*it, "l", l);
+    }
+
+    if (const auto it = json.find("ai"); it != json.end()) {
+        readValue<bool>(*it, "j", j);
+    }
+}
+
+nlohmann::json EventOrderUpdate::toJson() const {
+    return writeFields(*this);
+}
+
+void EventOrderUpdate::fromJson(const nlohmann::json &json) {
+    readFields(json, *this);
 }
 
 nlohmann::json EventUserData::toJson() const {
@@ -143,24 +314,29 @@ void EventUserData::fromJson(const nlohmann::json &json) {
             if (const auto it = json.find("o"); it != json.end()) {
                 EventOrderUpdate evOrderUpdate;
                 evOrderUpdate.fromJson(*it);
-                eventData = evOrderUpdate;
+                /// Order object carries no event type and time
+                evOrderUpdate.e = ev.e;
+                evOrderUpdate.E = ev.E;
+                eventData = std::move(evOrderUpdate);
             }
             break;
         }
         case EventType::ACCOUNT_CONFIG_UPDATE: {
-            if (const auto it = json.find("a"); it != json.end()) {
-                EventBalanceUpdate evBalanceUpdate;
-                evBalanceUpdate.fromJson(*it);
-                eventData = evBalanceUpdate;
-            }
+            EventAccountConfigUpdate evAccountConfigUpdate;
+            evAccountConfigUpdate.fromJson(json);
+            eventData = std::move(evAccountConfigUpdate);
             break;
         }
         case EventType::ACCOUNT_UPDATE: {
-            if (const auto it = json.find("ac"); it != json.end()) {
-                EventAccountUpdate evAccountUpdate;
-                evAccountUpdate.fromJson(*it);
-                eventData = evAccountUpdate;
-            }
+            EventAccountUpdate evAccountUpdate;
+            evAccountUpdate.fromJson(json);
+            eventData = std::move(evAccountUpdate);
+            break;
+        }
+        case EventType::MARGIN_CALL: {
+            EventMarginCall evMarginCall;
+            evMarginCall.fromJson(json);
+            eventData = std::move(evMarginCall);
             break;
         }
         case EventType::listenKeyExpired: {
@@ -172,18 +348,11 @@ void EventUserData::fromJson(const nlohmann::json &json) {
 }
 
 nlohmann::json EventAggregatedTrade::toJson() const {
-    throw std::runtime_error("Unimplemented: EventAggregatedTrade::toJson()");
+    return writeFields(*this);
 }
 
 void EventAggregatedTrade::fromJson(const nlohmann::json &json) {
-    readValue<std::string>(json, "s", s);
-    readValue<std::int64_t>(json, "a", a);
-    p = readStringAsDouble(json, "p");
-    q = readStringAsDouble(json, "q");
-    readValue<std::int64_t>(json, "f", f);
-    readValue<std::int64_t>(json, "l", l);
-    readValue<std::int64_t>(json, "T", T);
-    readValue<bool>(json, "m", m);
+    readFields(json, *this);
 }
 
 [[nodiscard]] nlohmann::json EventCandlestick::Candlestick::toJson() const {
@@ -227,16 +396,16 @@ void EventCandlestick::Candlestick::fromJson(const nlohmann::json &json) {
         i = m_i_val.value();
     }
 
-    o = readStringAsDouble(json, "o");
-    h = readStringAsDouble(json, "h");
-    l = readStringAsDouble(json, "l");
-    c = readStringAsDouble(json, "c");
-    v = readStringAsDouble(json, "v");
+    o = readDecimal(json, "o");
+    h = readDecimal(json, "h");
+    l = readDecimal(json, "l");
+    c = readDecimal(json, "c");
+    v = readDecimal(json, "v");
     readValue<std::int64_t>(json, "n", n);
     readValue<bool>(json, "x", x);
-    q = readStringAsDouble(json, "q");
-    V = readStringAsDouble(json, "V");
-    Q = readStringAsDouble(json, "Q");
+    q = readDecimal(json, "q");
+    V = readDecimal(json, "V");
+    Q = readDecimal(json, "Q");
 }
 
 [[nodiscard]] nlohmann::json EventCandlestick::toJson() const {
@@ -250,4 +419,115 @@ void EventCandlestick::fromJson(const nlohmann::json &json) {
     readValue<std::string>(json, "s", s);
     k.fromJson(json["k"]);
 }
+
+nlohmann::json EventDepthUpdate::toJson() const {
+    nlohmann::json json = Event::toJson();
+    json["T"] = T;
+    json["s"] = s;
+    json["U"] = U;
+    json["u"] = u;
+    json["pu"] = pu;
+    json["b"] = nlohmann::json::array();
+    json["a"] = nlohmann::json::array();
+
+    for (const auto &level: b) {
+        json["b"].push_back({std::to_string(level.price), std::to_string(level.quantity)});
+    }
+
+    for (const auto &level: a) {
+        json["a"].push_back({std::to_string(level.price), std::to_string(level.quantity)});
+    }
+
+    return json;
+}
+
+void EventDepthUpdate::fromJson(const nlohmann::json &json) {
+    Event::fromJson(json);
+    readValue<std::int64_t>(json, "T", T);
+    readValue<std::string>(json, "s", s);
+    readValue<std::int64_t>(json, "U", U);
+    readValue<std::int64_t>(json, "u", u);
+    readValue<std::int64_t>(json, "pu", pu);
+    readOrderBookLevels(json, "b", b);
+    readOrderBookLevels(json, "a", a);
+}
+
+/**
+ * Levels behind MAX_LEVELS are skipped
+ * @return number of read levels
+ */
+static std::size_t readDepthLevels(const nlohmann::json &json, const std::string_view key,
+                                   std::array<OrderBookLevel, EventDepth::MAX_LEVELS> &levels) {
+    const auto it = json.find(key);
+
+    if (it == json.end() || it->is_null()) {
+        return 0;
+    }
+
+    std::size_t count = 0;
+
+    for (const auto &level: *it) {
+        if (count == levels.size()) {
+            break;
+        }
+
+        if (!level.is_array() || level.size() < 2) {
+            throw JsonParseError("Price level expected, got " + level.dump());
+        }
+
+        levels[count++] = {readDecimal(level[0]), readDecimal(level[1])};
+    }
+
+    return count;
+}
+
+nlohmann::json EventDepth::toJson() const {
+    nlohmann::json json = Event::toJson();
+    json["T"] = T;
+    json["s"] = s;
+    json["U"] = U;
+    json["u"] = u;
+    json["pu"] = pu;
+    json["b"] = nlohmann::json::array();
+    json["a"] = nlohmann::json::array();
+
+    for (std::size_t i = 0; i < bidCount; i++) {
+        json["b"].push_back({std::to_string(b[i].price), std::to_string(b[i].quantity)});
+    }
+
+    for (std::size_t i = 0; i < askCount; i++) {
+        json["a"].push_back({std::to_string(a[i].price), std::to_string(a[i].quantity)});
+    }
+
+    return json;
+}
+
+void EventDepth::fromJson(const nlohmann::json &json) {
+    Event::fromJson(json);
+    readValue<std::int64_t>(json, "T", T);
+    readValue<std::string>(json, "s", s);
+    readValue<std::int64_t>(json, "U", U);
+    readValue<std::int64_t>(json, "u", u);
+    readValue<std::int64_t>(json, "pu", pu);
+    bidCount = readDepthLevels(json, "b", b);
+    askCount = readDepthLevels(json, "a", a);
+}
+
+nlohmann::json EventMarkPrice::toJson() const {
+    return writeFields(*this);
+}
+
+void EventMarkPrice::fromJson(const nlohmann::json &json) {
+    readFields(json, *this);
+}
+
+nlohmann::json EventMiniTicker::toJson() const {
+    nlohmann::json json = writeFields(*this);
+    json["e"] = "24hrMiniTicker";
+    return json;
+}
+
+void EventMiniTicker::fromJson(const nlohmann::json &json) {
+    readFields(json, *this);
+}
 }
@@ -0,0 +1,347 @@
+/**
+Binance WebSocket Event Parser
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_event_parser.h"
+#include "stonky/binance/binance_frame_reader.h"
+
+namespace stonky::binance::futures {
+/**
+ * Event type of the compact events is given by their structure, the "e" field is skipped
+ */
+template<typename Event>
+static void readEventType(FrameReader &reader, Event &event) {
+    if constexpr (requires { event.e; }) {
+        reader.read(event.e);
+    } else {
+        reader.skipValue();
+    }
+}
+
+static EventCandlestick::Candlestick &candleOf(EventCandlestick &event) {
+    return event.k;
+}
+
+static PodEventCandlestick &candleOf(PodEventCandlestick &event) {
+    return event;
+}
+
+template<typename Event>
+static void parseTickPrice(const std::string_view frame, Event &event) {
+    FrameReader reader(frame);
+
+    reader.readObject([&](const std::string_view key) {
+        if (key == "e") {
+            readEventType(reader, event);
+        } else if (key == "E") {
+            reader.read(event.E);
+        } else if (key == "u") {
+            reader.read(event.u);
+        } else if (key == "s") {
+            reader.read(event.s);
+        } else if (key == "b") {
+            reader.read(event.b);
+        } else if (key == "B") {
+            reader.read(event.B);
+        } else if (key == "a") {
+            reader.read(event.a);
+        } else if (key == "A") {
+            reader.read(event.A);
+        } else if (key == "T") {
+            reader.read(event.T);
+        } else {
+            reader.skipValue();
+        }
+    });
+}
+
+template<typename Event>
+static void parseCandlestick(const std::string_view frame, Event &event) {
+    FrameReader reader(frame);
+    auto &k = candleOf(event);
+
+    reader.readObject([&](const std::string_view key) {
+        if (key == "e") {
+            readEventType(reader, event);
+        } else if (key == "E") {
+            reader.read(event.E);
+        } else if (key == "s") {
+            reader.read(event.s);
+        } else if (key == "k") {
+            reader.readObject([&](const std::string_view candleKey) {
+                if (candleKey == "t") {
+                    reader.read(k.t);
+                } else if (candleKey == "T") {
+                    reader.read(k.T);
+                } else if (candleKey == "s") {
+                    reader.read(k.s);
+                } else if (candleKey == "i") {
+                    reader.read(k.i);
+                } else if (candleKey == "f") {
+                    reader.read(k.f);
+                } else if (candleKey == "L") {
+                    reader.read(k.L);
+                } else if (candleKey == "o") {
+                    reader.read(k.o);
+                } else if (candleKey == "h") {
+                    reader.read(k.h);
+                } else if (candleKey == "l") {
+                    reader.read(k.l);
+                } else if (candleKey == "c") {
+                    reader.read(k.c);
+                } else if (candleKey == "v") {
+                    reader.read(k.v);
+                } else if (candleKey == "n") {
+                    reader.read(k.n);
+                } else if (candleKey == "x") {
+                    reader.read(k.x);
+                } else if (candleKey == "q") {
+                    reader.read(k.q);
+                } else if (candleKey == "V") {
+                    reader.read(k.V);
+                } else if (candleKey == "Q") {
+                    reader.read(k.Q);
+                } else {
+                    reader.skipValue();
+                }
+            });
+        } else {
+            reader.skipValue();
+        }
+    });
+}
+
+template<typename Event>
+static void parseAggregatedTrade(const std::string_view frame, Event &event) {
+    FrameReader reader(frame);
+
+    reader.readObject([&](const std::string_view key) {
+        if (key == "e") {
+            readEventType(reader, event);
+        } else if (key == "E") {
+            reader.read(event.E);
+        } else if (key == "s") {
+            reader.read(event.s);
+        } else if (key == "a") {
+            reader.read(event.a);
+        } else if (key == "p") {
+            reader.read(event.p);
+        } else if (key == "q") {
+            reader.read(event.q);
+        } else if (key == "f") {
+            reader.read(event.f);
+        } else if (key == "l") {
+            reader.read(event.l);
+        } else if (key == "T") {
+            reader.read(event.T);
+        } else if (key == "m") {
+            reader.read(event.m);
+        } else {
+            reader.skipValue();
+        }
+    });
+}
+
+static void readLevel(FrameReader &reader, OrderBookLevel &level) {
+    std::size_t index = 0;
+
+    reader.readArray([&] {
+        if (index == 0) {
+            reader.read(level.price);
+        } else if (index == 1) {
+            reader.read(level.quantity);
+        } else {
+            reader.skipValue();
+        }
+
+        index++;
+    });
+}
+
+/**
+ * Read [["price","quantity"],...], levels keep the capacity of the previous frame
+ */
+static void readLevels(FrameReader &reader, std::vector<OrderBookLevel> &levels) {
+    levels.clear();
+
+    reader.readArray([&] {
+        readLevel(reader, levels.emplace_back());
+    });
+}
+
+/**
+ * Read [["price","quantity"],...] into the inline levels, levels behind their capacity are skipped
+ * @return number of read levels
+ */
+template<std::size_t N>
+static std::size_t readLevels(FrameReader &reader, std::array<OrderBookLevel, N> &levels) {
+    std::size_t count = 0;
+
+    reader.readArray([&] {
+        if (count < N) {
+            readLevel(reader, levels[count++]);
+        } else {
+            reader.skipValue();
+        }
+    });
+
+    return count;
+}
+
+/**
+ * Diff. and Partial Book Depth Streams share the frame format, only the partial one has inline levels with counts
+ */
+template<typename Event>
+static void parseDepth(const std::string_view frame, Event &event) {
+    FrameReader reader(frame);
+
+    reader.readObject([&](const std::string_view key) {
+        if (key == "e") {
+            reader.read(event.e);
+        } else if (key == "E") {
+            reader.read(event.E);
+        } else if (key == "T") {
+            reader.read(event.T);
+        } else if (key == "s") {
+            reader.read(event.s);
+        } else if (key == "U") {
+            reader.read(event.U);
+        } else if (key == "u") {
+            reader.read(event.u);
+        } else if (key == "pu") {
+            reader.read(event.pu);
+        } else if (key == "b") {
+            if constexpr (requires { event.bidCount; }) {
+                event.bidCount = readLevels(reader, event.b);
+            } else {
+                readLevels(reader, event.b);
+            }
+        } else if (key == "a") {
+            if constexpr (requires { event.askCount; }) {
+                event.askCount = readLevels(reader, event.a);
+            } else {
+                readLevels(reader, event.a);
+            }
+        } else {
+            reader.skipValue();
+        }
+    });
+}
+
+static void readMarkPrice(FrameReader &reader, EventMarkPrice &event) {
+    reader.readObject([&](const std::string_view key) {
+        if (key == "e") {
+            reader.read(event.e);
+        } else if (key == "E") {
+            reader.read(event.E);
+        } else if (key == "s") {
+            reader.read(event.s);
+        } else if (key == "p") {
+            reader.read(event.p);
+        } else if (key == "i") {
+            reader.read(event.i);
+        } else if (key == "P") {
+            reader.read(event.P);
+        } else if (key == "r") {
+            reader.read(event.r);
+        } else if (key == "T") {
+            reader.read(event.T);
+        } else {
+            reader.skipValue();
+        }
+    });
+}
+
+/**
+ * Event type 24hrMiniTicker is not an EventType name, it is set by the constructor
+ */
+static void readMiniTicker(FrameReader &reader, EventMiniTicker &event) {
+    reader.readObject([&](const std::string_view key) {
+        if (key == "E") {
+            reader.read(event.E);
+        } else if (key == "s") {
+            reader.read(event.s);
+        } else if (key == "c") {
+            reader.read(event.c);
+        } else if (key == "o") {
+            reader.read(event.o);
+        } else if (key == "h") {
+            reader.read(event.h);
+        } else if (key == "l") {
+            reader.read(event.l);
+        } else if (key == "v") {
+            reader.read(event.v);
+        } else if (key == "q") {
+            reader.read(event.q);
+        } else {
+            reader.skipValue();
+        }
+    });
+}
+
+void parseEvent(const std::string_view frame, EventTickPrice &event) {
+    parseTickPrice(frame, event);
+}
+
+void parseEvent(const std::string_view frame, EventCandlestick &event) {
+    parseCandlestick(frame, event);
+}
+
+void parseEvent(const std::string_view frame, EventAggregatedTrade &event) {
+    parseAggregatedTrade(frame, event);
+}
+
+void parseEvent(const std::string_view frame, EventDepthUpdate &event) {
+    parseDepth(frame, event);
+}
+
+void parseEvent(const std::string_view frame, EventDepth &event) {
+    parseDepth(frame, event);
+}
+
+void parseEvent(const std::string_view frame, EventMarkPrice &event) {
+    FrameReader reader(frame);
+    readMarkPrice(reader, event);
+}
+
+void parseEvent(const std::string_view frame, EventMiniTicker &event) {
+    FrameReader reader(frame);
+    readMiniTicker(reader, event);
+}
+
+void parseEvents(const std::string_view frame, EventMarkPrice &event,
+                 const std::function<void(const EventMarkPrice &)> &cb) {
+    FrameReader reader(frame);
+
+    reader.readArray([&] {
+        readMarkPrice(reader, event);
+        cb(event);
+    });
+}
+
+void parseEvents(const std::string_view frame, EventMiniTicker &event,
+                 const std::function<void(const EventMiniTicker &)> &cb) {
+    FrameReader reader(frame);
+
+    reader.readArray([&] {
+        readMiniTicker(reader, event);
+        cb(event);
+    });
+}
+
+void parseEvent(const std::string_view frame, PodEventTickPrice &event) {
+    parseTickPrice(frame, event);
+}
+
+void parseEvent(const std::string_view frame, PodEventCandlestick &event) {
+    parseCandlestick(frame, event);
+}
+
+void parseEvent(const std::string_view frame, PodEventAggregatedTrade &event) {
+    parseAggregatedTrade(frame, event);
+}
+}
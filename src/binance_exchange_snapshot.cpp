@@ -0,0 +1,407 @@
+/**
+Binance Futures Exchange Info Snapshot
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_exchange_snapshot.h"
+#include "stonky/binance/binance_json_parser.h"
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <type_traits>
+
+namespace stonky::binance::futures {
+static constexpr std::array<char, 4> EXCHANGE_SNAPSHOT_MAGIC{'S', 'B', 'F', 'X'};
+
+/**
+ * Content of the snapshot following the header
+ */
+enum class SnapshotContent : std::uint8_t {
+    Decoded,
+    Response
+};
+
+class SnapshotWriter {
+    std::string m_data;
+
+public:
+    template<typename T> requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    void write(const T value) {
+        m_data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    void write(const std::string_view value) {
+        write(static_cast<std::uint32_t>(value.size()));
+        m_data.append(value);
+    }
+
+    void write(const std::string &value) {
+        write(std::string_view(value));
+    }
+
+    void write(const Decimal &value) {
+        write(value.value());
+        write(value.scale());
+    }
+
+    template<typename T>
+    void write(const std::vector<T> &values) {
+        write(static_cast<std::uint32_t>(values.size()));
+
+        for (const auto &value: values) {
+            write(value);
+        }
+    }
+
+    void write(const RateLimit &rateLimit) {
+        write(rateLimit.interval);
+        write(rateLimit.intervalNum);
+        write(rateLimit.limit);
+        write(rateLimit.rateLimitType);
+    }
+
+    void write(const Asset &asset) {
+        write(asset.asset);
+        write(asset.walletBalance);
+        write(asset.unrealizedProfit);
+        write(asset.marginBalance);
+        write(asset.maintMargin);
+        write(asset.initialMargin);
+        write(asset.positionInitialMargin);
+        write(asset.openOrderInitialMargin);
+        write(asset.crossWalletBalance);
+        write(asset.crossUnPnl);
+        write(asset.availableBalance);
+        write(asset.maxWithdrawAmount);
+        write(asset.marginAvailable);
+        write(asset.updateTime);
+        write(asset.autoAssetExchange);
+    }
+
+    void write(const Filter &filter) {
+        write(filter.filterType);
+        write(filter.maxPrice);
+        write(filter.minPrice);
+        write(filter.tickSize);
+        write(filter.minQty);
+        write(filter.maxQty);
+        write(filter.stepSize);
+        write(filter.limit);
+        write(filter.multiplierUp);
+        write(filter.multiplierDown);
+        write(filter.multiplierDecimal);
+        write(filter.notional);
+        write(filter.exactTickSize);
+        write(filter.exactStepSize);
+    }
+
+    void write(const Symbol &symbol) {
+        write(symbol.symbol);
+        write(symbol.pair);
+        write(symbol.contractType);
+        write(symbol.deliveryDate);
+        write(symbol.onboardDate);
+        write(symbol.status);
+        write(symbol.maintMarginPercent);
+        write(symbol.requiredMarginPercent);
+        write(symbol.baseAsset);
+        write(symbol.quoteAsset);
+        write(symbol.marginAsset);
+        write(symbol.pricePrecision);
+        write(symbol.quantityPrecision);
+        write(symbol.baseAssetPrecision);
+        write(symbol.quotePrecision);
+        write(symbol.underlyingType);
+        write(symbol.underlyingSubType);
+        write(symbol.settlePlan);
+        write(symbol.triggerProtect);
+        write(symbol.filters);
+        write(symbol.orderType);
+        write(symbol.timeInForce);
+        write(symbol.liquidationFee);
+        write(symbol.marketTakeBound);
+    }
+
+    [[nodiscard]] std::string release() {
+        return std::move(m_data);
+    }
+};
+
+class SnapshotReader {
+    std::string_view m_data;
+
+    [[nodiscard]] std::string_view take(const std::size_t size) {
+        if (m_data.size() < size) {
+            throw std::runtime_error("Exchange snapshot is truncated");
+        }
+
+        const auto retVal = m_data.substr(0, size);
+        m_data.remove_prefix(size);
+        return retVal;
+    }
+
+public:
+    explicit SnapshotReader(const std::string_view data) : m_data(data) {
+    }
+
+    template<typename T> requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    void read(T &value) {
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+    }
+
+    void read(std::string &value) {
+        std::uint32_t size{};
+        read(size);
+        value = take(size);
+    }
+
+    /**
+     * Read the response keeping JSON_PAYLOAD_PADDING spare capacity, so that it is parsed without a copy
+     */
+    void readPayload(std::string &value) {
+        std::uint32_t size{};
+        read(size);
+        const auto data = take(size);
+        value.reserve(data.size() + JSON_PAYLOAD_PADDING);
+        value.assign(data);
+    }
+
+    void read(Decimal &value) {
+        std::int64_t scaledValue{};
+        std::int32_t scale{};
+        read(scaledValue);
+        read(scale);
+
+        if (scale < 0 || scale > Decimal::MAX_SCALE) {
+            throw std::runtime_error("Exchange snapshot contains invalid decimal");
+        }
+
+        value = Decimal(scaledValue, scale);
+    }
+
+    template<typename T>
+    void read(std::vector<T> &values) {
+        std::uint32_t size{};
+        read(size);
+
+        /// Every element takes at least one byte, a corrupted count must not cause a huge allocation
+        if (size > m_data.size()) {
+            throw std::runtime_error("Exchange snapshot is truncated");
+        }
+
+        values.clear();
+        values.resize(size);
+
+        for (auto &value: values) {
+            read(value);
+        }
+    }
+
+    void read(RateLimit &rateLimit) {
+        read(rateLimit.interval);
+        read(rateLimit.intervalNum);
+        read(rateLimit.limit);
+        read(rateLimit.rateLimitType);
+    }
+
+    void read(Asset &asset) {
+        read(asset.asset);
+        read(asset.walletBalance);
+        read(asset.unrealizedProfit);
+        read(asset.marginBalance);
+        read(asset.maintMargin);
+        read(asset.initialMargin);
+        read(asset.positionInitialMargin);
+        read(asset.openOrderInitialMargin);
+        read(asset.crossWalletBalance);
+        read(asset.crossUnPnl);
+        read(asset.availableBalance);
+        read(asset.maxWithdrawAmount);
+        read(asset.marginAvailable);
+        read(asset.updateTime);
+        read(asset.autoAssetExchange);
+    }
+
+    void read(Filter &filter) {
+        read(filter.filterType);
+        read(filter.maxPrice);
+        read(filter.minPrice);
+        read(filter.tickSize);
+        read(filter.minQty);
+        read(filter.maxQty);
+        read(filter.stepSize);
+        read(filter.limit);
+        read(filter.multiplierUp);
+        read(filter.multiplierDown);
+        read(filter.multiplierDecimal);
+        read(filter.notional);
+        read(filter.exactTickSize);
+        read(filter.exactStepSize);
+    }
+
+    void read(Symbol &symbol) {
+        read(symbol.symbol);
+        read(symbol.pair);
+        read(symbol.contractType);
+        read(symbol.deliveryDate);
+        read(symbol.onboardDate);
+        read(symbol.status);
+        read(symbol.maintMarginPercent);
+        read(symbol.requiredMarginPercent);
+        read(symbol.baseAsset);
+        read(symbol.quoteAsset);
+        read(symbol.marginAsset);
+        read(symbol.pricePrecision);
+        read(symbol.quantityPrecision);
+        read(symbol.baseAssetPrecision);
+        read(symbol.quotePrecision);
+        read(symbol.underlyingType);
+        read(symbol.underlyingSubType);
+        read(symbol.settlePlan);
+        read(symbol.triggerProtect);
+        read(symbol.filters);
+        read(symbol.orderType);
+        read(symbol.timeInForce);
+        read(symbol.liquidationFee);
+        read(symbol.marketTakeBound);
+    }
+
+    [[nodiscard]] bool atEnd() const {
+        return m_data.empty();
+    }
+};
+
+std::string serializeExchange(const ExchangeSnapshot &snapshot) {
+    SnapshotWriter writer;
+
+    for (const auto c: EXCHANGE_SNAPSHOT_MAGIC) {
+        writer.write(c);
+    }
+
+    writer.write(EXCHANGE_SNAPSHOT_VERSION);
+    writer.write(snapshot.lastUpdateTime);
+
+    if (const auto payload = snapshot.exchange->payload(); !payload.empty()) {
+        writer.write(SnapshotContent::Response);
+        writer.write(payload);
+        return writer.release();
+    }
+
+    /// Exchange wrapped by LazyExchange is already decoded
+    const auto &exchange = snapshot.exchange->exchange();
+    writer.write(SnapshotContent::Decoded);
+    writer.write(exchange.serverTime);
+    writer.write(exchange.timezone);
+    writer.write(exchange.rateLimits);
+    writer.write(exchange.assets);
+    writer.write(exchange.symbols);
+    return writer.release();
+}
+
+ExchangeSnapshot deserializeExchange(const std::string_view data) {
+    SnapshotReader reader(data);
+
+    for (const auto expected: EXCHANGE_SNAPSHOT_MAGIC) {
+        char c{};
+        reader.read(c);
+
+        if (c != expected) {
+            throw std::runtime_error("Not an Exchange snapshot");
+        }
+    }
+
+    std::uint32_t version{};
+    reader.read(version);
+
+    if (version != EXCHANGE_SNAPSHOT_VERSION) {
+        throw std::runtime_error("Unsupported Exchange snapshot version: " + std::to_string(version));
+    }
+
+    ExchangeSnapshot retVal;
+    reader.read(retVal.lastUpdateTime);
+
+    SnapshotContent content{};
+    reader.read(content);
+
+    if (content == SnapshotContent::Response) {
+        std::string payload;
+        reader.readPayload(payload);
+
+        if (!reader.atEnd()) {
+            throw std::runtime_error("Unexpected data at the end of Exchange snapshot");
+        }
+
+        retVal.exchange = std::make_shared<const LazyExchange>(std::move(payload));
+        return retVal;
+    }
+
+    if (content != SnapshotContent::Decoded) {
+        throw std::runtime_error("Unknown Exchange snapshot content");
+    }
+
+    Exchange exchange;
+    exchange.lastUpdateTime = retVal.lastUpdateTime;
+    reader.read(exchange.serverTime);
+    reader.read(exchange.timezone);
+    reader.read(exchange.rateLimits);
+    reader.read(exchange.assets);
+    reader.read(exchange.symbols);
+
+    if (!reader.atEnd()) {
+        throw std::runtime_error("Unexpected data at the end of Exchange snapshot");
+    }
+
+    retVal.exchange = std::make_shared<const LazyExchange>(std::move(exchange));
+    return retVal;
+}
+
+void saveExchangeSnapshot(const ExchangeSnapshot &snapshot, const std::filesystem::path &path) {
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+
+    {
+        std::ofstream outFile(tmpPath, std::ios::binary | std::ios::trunc);
+
+        if (!outFile.is_open()) {
+            throw std::runtime_error("Cannot open file: " + tmpPath.string());
+        }
+
+        const auto data = serializeExchange(snapshot);
+        outFile.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+        if (!outFile) {
+            throw std::runtime_error("Cannot write file: " + tmpPath.string());
+        }
+    }
+
+    std::filesystem::rename(tmpPath, path);
+}
+
+std::optional<ExchangeSnapshot> loadExchangeSnapshot(const std::filesystem::path &path) {
+    std::ifstream inFile(path, std::ios::binary);
+
+    if (!inFile.is_open()) {
+        return std::nullopt;
+    }
+
+    const std::string data{std::istreambuf_iterator(inFile), std::istreambuf_iterator<char>()};
+
+    try {
+        return deserializeExchange(data);
+    } catch (const std::runtime_error &e) {
+        spdlog::warn("Ignoring Exchange snapshot {}: {}", path.string(), e.what());
+    }
+
+    return std::nullopt;
+}
+}
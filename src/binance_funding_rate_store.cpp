@@ -0,0 +1,317 @@
+/**
+Binance Futures Funding Rate Store
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_funding_rate_store.h"
+#include "stonky/binance/binance_futures_rest_client.h"
+#include "stonky/binance/binance_parallel_fetch.h"
+#include "stonky/utils/utils.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <mutex>
+#include <spdlog/spdlog.h>
+
+namespace stonky::binance::futures {
+static constexpr int FUNDING_RATES_PAGE_LIMIT = 1000; /// max. limit of fundingRate endpoint
+static auto FUNDING_RATES_FILE_HEADER = "fundingTime,fundingRate";
+static auto COVERAGE_FILE_HEADER = "coveredFrom,coveredUntil";
+
+struct FundingRateStore::P {
+    struct SymbolHistory {
+        mutable std::mutex locker;
+        std::vector<FundingRate> fundingRates;
+        std::int64_t coveredFrom{-1};
+        /// Records are complete up to this timestamp in ms, time of the last update
+        std::int64_t coveredUntil{-1};
+    };
+
+    std::weak_ptr<RESTClient> restClient;
+    std::filesystem::path directory;
+    mutable std::mutex locker;
+    std::map<std::string, std::unique_ptr<SymbolHistory> > histories;
+
+    P(const std::weak_ptr<RESTClient> &restClient, std::filesystem::path directory) : restClient(restClient),
+        directory(std::move(directory)) {
+    }
+
+    [[nodiscard]] std::filesystem::path filePath(const std::string &symbol) const {
+        return directory / (symbol + "_funding_rates.csv");
+    }
+
+    /**
+     * Requested coverage is stored next to the records, it may start before the first record, e.g. before listing
+     */
+    [[nodiscard]] std::filesystem::path coveragePath(const std::string &symbol) const {
+        return directory / (symbol + "_funding_rates_coverage.csv");
+    }
+
+    /**
+     * Find history of the symbol, load it from disk when accessed for the first time
+     */
+    SymbolHistory &history(const std::string &symbol) {
+        std::lock_guard lk(locker);
+
+        auto [it, inserted] = histories.try_emplace(symbol, nullptr);
+
+        if (inserted) {
+            it->second = std::make_unique<SymbolHistory>();
+            load(symbol, *it->second);
+        }
+
+        return *it->second;
+    }
+
+    void load(const std::string &symbol, SymbolHistory &history) const {
+        std::ifstream inFile(filePath(symbol));
+
+        if (!inFile.is_open()) {
+            return;
+        }
+
+        std::string row;
+        std::getline(inFile, row);
+
+        while (std::getline(inFile, row)) {
+            const auto separator = row.find(',');
+
+            if (separator == std::string::npos) {
+                continue;
+            }
+
+            FundingRate fundingRate;
+            fundingRate.symbol = symbol;
+
+            if (const auto [ptr, ec] = std::from_chars(row.data(), row.data() + separator, fundingRate.fundingTime);
+                ec != std::errc() || ptr != row.data() + separator
+                || !parseDouble(std::string_view(row).substr(separator + 1), fundingRate.fundingRate)) {
+                continue;
+            }
+
+            if (history.fundingRates.empty() || history.fundingRates.back().fundingTime < fundingRate.fundingTime) {
+                history.fundingRates.push_back(fundingRate);
+            }
+        }
+
+        if (!history.fundingRates.empty()) {
+            history.coveredFrom = history.fundingRates.front().fundingTime;
+            history.coveredUntil = history.fundingRates.back().fundingTime;
+        }
+
+        loadCoverage(symbol, history);
+    }
+
+    void loadCoverage(const std::string &symbol, SymbolHistory &history) const {
+        std::ifstream inFile(coveragePath(symbol));
+
+        if (!inFile.is_open()) {
+            return;
+        }
+
+        std::string row;
+        std::getline(inFile, row);
+
+        if (!std::getline(inFile, row)) {
+            return;
+        }
+
+        const auto separator = row.find(',');
+
+        if (separator == std::string::npos) {
+            return;
+        }
+
+        std::int64_t coveredFrom;
+        std::int64_t coveredUntil;
+
+        if (const auto [ptr, ec] = std::from_chars(row.data(), row.data() + separator, coveredFrom);
+            ec != std::errc() || ptr != row.data() + separator) {
+            return;
+        }
+
+        if (const auto [ptr, ec] = std::from_chars(row.data() + separator + 1, row.data() + row.size(), coveredUntil);
+            ec != std::errc()) {
+            return;
+        }
+
+        /// Records are the source of truth, the stored coverage may only extend them
+        if (history.fundingRates.empty()) {
+            history.coveredFrom = coveredFrom;
+            history.coveredUntil = coveredUntil;
+        } else {
+            history.coveredFrom = std::min(history.coveredFrom, coveredFrom);
+            history.coveredUntil = std::max(history.coveredUntil, coveredUntil);
+        }
+    }
+
+    void saveCoverage(const std::string &symbol, const SymbolHistory &history) const {
+        std::filesystem::create_directories(directory);
+        std::ofstream outFile(coveragePath(symbol), std::ios::trunc);
+        outFile << COVERAGE_FILE_HEADER << '\n';
+        outFile << fmt::format("{},{}\n", history.coveredFrom, history.coveredUntil);
+    }
+
+    static void writeRows(std::ofstream &outFile, const std::vector<FundingRate>::const_iterator &begin,
+                          const std::vector<FundingRate>::const_iterator &end) {
+        for (auto it = begin; it != end; ++it) {
+            outFile << fmt::format("{},{}\n", it->fundingTime, it->fundingRate);
+        }
+    }
+
+    void append(const std::string &symbol, const SymbolHistory &history, const std::size_t numNewRecords) const {
+        std::filesystem::create_directories(directory);
+        const auto path = filePath(symbol);
+        const bool writeHeader = !std::filesystem::exists(path);
+
+        std::ofstream outFile(path, std::ios::app);
+
+        if (writeHeader) {
+            outFile << FUNDING_RATES_FILE_HEADER << '\n';
+        }
+
+        writeRows(outFile, history.fundingRates.end() - static_cast<std::ptrdiff_t>(numNewRecords),
+                  history.fundingRates.end());
+    }
+
+    void rewrite(const std::string &symbol, const SymbolHistory &history) const {
+        std::filesystem::create_directories(directory);
+        std::ofstream outFile(filePath(symbol), std::ios::trunc);
+        outFile << FUNDING_RATES_FILE_HEADER << '\n';
+        writeRows(outFile, history.fundingRates.begin(), history.fundingRates.end());
+    }
+
+    /**
+     * Append records newer than the last stored one, duplicates at page boundaries are dropped
+     * @return number of appended records
+     */
+    static std::size_t merge(std::vector<FundingRate> &target, const std::vector<FundingRate> &fundingRates) {
+        std::size_t retVal = 0;
+
+        for (const auto &fundingRate: fundingRates) {
+            if (target.empty() || target.back().fundingTime < fundingRate.fundingTime) {
+                target.push_back(fundingRate);
+                retVal++;
+            }
+        }
+
+        return retVal;
+    }
+
+    void updateSymbol(const std::shared_ptr<RESTClient> &client, const std::string &symbol, const std::int64_t startTime) {
+        auto &symbolHistory = history(symbol);
+
+        std::int64_t coveredFrom;
+        std::int64_t lastFundingTime;
+        {
+            std::lock_guard lk(symbolHistory.locker);
+            coveredFrom = symbolHistory.coveredFrom;
+            lastFundingTime = symbolHistory.fundingRates.empty() ? -1 : symbolHistory.fundingRates.back().fundingTime;
+        }
+
+        const auto nowTimestamp = getMsTimestamp(currentTime()).count();
+        std::vector<FundingRate> olderRates;
+        std::vector<FundingRate> newerRates;
+
+        if (lastFundingTime < 0) {
+            newerRates = client->getFundingRates(symbol, startTime, nowTimestamp, FUNDING_RATES_PAGE_LIMIT);
+        } else {
+            if (startTime < coveredFrom) {
+                olderRates = client->getFundingRates(symbol, startTime, coveredFrom - 1, FUNDING_RATES_PAGE_LIMIT);
+            }
+
+            newerRates = client->getFundingRates(symbol, lastFundingTime + 1, nowTimestamp, FUNDING_RATES_PAGE_LIMIT);
+        }
+
+        std::lock_guard lk(symbolHistory.locker);
+        symbolHistory.coveredUntil = nowTimestamp;
+
+        if (lastFundingTime < 0 || startTime < coveredFrom) {
+            if (!olderRates.empty()) {
+                std::vector<FundingRate> fundingRates;
+                merge(fundingRates, olderRates);
+                merge(fundingRates, symbolHistory.fundingRates);
+                symbolHistory.fundingRates = std::move(fundingRates);
+                merge(symbolHistory.fundingRates, newerRates);
+                rewrite(symbol, symbolHistory);
+                symbolHistory.coveredFrom = startTime;
+                saveCoverage(symbol, symbolHistory);
+                return;
+            }
+
+            symbolHistory.coveredFrom = startTime;
+        }
+
+        if (const auto numNewRecords = merge(symbolHistory.fundingRates, newerRates); numNewRecords > 0) {
+            append(symbol, symbolHistory, numNewRecords);
+        }
+
+        saveCoverage(symbol, symbolHistory);
+    }
+};
+
+FundingRateStore::FundingRateStore(const std::weak_ptr<RESTClient> &restClient,
+                                   const std::filesystem::path &directory) : m_p(
+    std::make_unique<P>(restClient, directory)) {
+}
+
+FundingRateStore::~FundingRateStore() = default;
+
+std::vector<FetchError>
+FundingRateStore::update(const std::vector<std::string> &symbols, const std::int64_t startTime,
+                         const std::size_t maxParallelRequests) const {
+    const auto client = m_p->restClient.lock();
+
+    if (!client) {
+        throw std::runtime_error("REST client is not available");
+    }
+
+    auto retVal = forEachSymbol(symbols, maxParallelRequests, [&](const std::string &symbol) {
+        m_p->updateSymbol(client, symbol, startTime);
+    });
+
+    for (const auto &error: retVal) {
+        spdlog::warn(fmt::format("Funding rates update of {} failed: {}", error.symbol, error.message));
+    }
+
+    return retVal;
+}
+
+std::vector<FundingRate>
+FundingRateStore::getFundingRates(const std::string &symbol, const std::int64_t startTime,
+                                  const std::int64_t endTime) const {
+    const auto &symbolHistory = m_p->history(symbol);
+    std::lock_guard lk(symbolHistory.locker);
+    const auto &fundingRates = symbolHistory.fundingRates;
+
+    const auto first = std::ranges::lower_bound(fundingRates, startTime, {}, &FundingRate::fundingTime);
+    const auto last = std::ranges::upper_bound(fundingRates, endTime, {}, &FundingRate::fundingTime);
+
+    if (first >= last) {
+        return {};
+    }
+
+    return {first, last};
+}
+
+std::int64_t FundingRateStore::coveredFrom(const std::string &symbol) const {
+    const auto &symbolHistory = m_p->history(symbol);
+    std::lock_guard lk(symbolHistory.locker);
+    return symbolHistory.coveredFrom;
+}
+
+std::int64_t FundingRateStore::coveredUntil(const std::string &symbol) const {
+    const auto &symbolHistory = m_p->history(symbol);
+    std::lock_guard lk(symbolHistory.locker);
+    return symbolHistory.coveredUntil;
+}
+
+std::int64_t FundingRateStore::lastFundingTime(const std::string &symbol) const {
+    const auto &symbolHistory = m_p->history(symbol);
+    std::lock_guard lk(symbolHistory.locker);
+    return symbolHistory.fundingRates.empty() ? -1 : symbolHistory.fundingRates.back().fundingTime;
+}
+}
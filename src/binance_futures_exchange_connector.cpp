@@ -10,11 +10,111 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 #include "stonky/binance/binance_futures_rest_client.h"
 #include "stonky/binance/binance_futures_ws_client.h"
 #include "stonky/binance/binance_ws_stream_manager.h"
+#include "stonky/binance/binance_funding_rate_store.h"
+#include "stonky/binance/binance_exchange_snapshot.h"
+#include "stonky/utils/utils.h"
+#include <algorithm>
+#include <future>
+#include <spdlog/spdlog.h>
 
 namespace stonky {
+static auto FUNDING_RATES_STORE_DIR = "stonky_binance_futures_funding_rates";
+static auto EXCHANGE_SNAPSHOT_FILE = "stonky_binance_futures_exchange.bin";
+static constexpr std::int64_t MIN_FUNDING_INTERVAL_IN_MS = 3600000; /// shortest funding interval of any symbol
+static constexpr std::int64_t FUNDING_RATES_REFRESH_INTERVAL_IN_MS = 60000;
+/// Mark prices are streamed every second, an older entry means the stream is stalled or the symbol is not traded
+static constexpr std::chrono::milliseconds MARK_PRICES_MAX_AGE{3000};
+
 struct BinanceFuturesExchangeConnector::P {
     std::shared_ptr<binance::futures::RESTClient> restClient{};
     std::unique_ptr<binance::futures::WSStreamManager> streamManager{};
+    std::unique_ptr<binance::futures::FundingRateStore> fundingRateStore{};
+    std::future<void> exchangeRefresh{};
+    std::filesystem::path dataDirectory;
+
+    explicit P(std::filesystem::path dataDirectory) : dataDirectory(std::move(dataDirectory)) {
+    }
+
+    /**
+     * Funding rates of all symbols are streamed every second, getFundingRates() reads them from the cache
+     */
+    void createStreamManager() {
+        streamManager = std::make_unique<binance::futures::WSStreamManager>(restClient);
+        streamManager->subscribeAllMarkPrices();
+    }
+
+    void createFundingRateStore() {
+        fundingRateStore = std::make_unique<binance::futures::FundingRateStore>(
+            restClient, dataDirectory / FUNDING_RATES_STORE_DIR);
+    }
+
+    /**
+     * Stored history is missing the requested range. No new record can exist sooner than the shortest funding
+     * interval after the newest one, and a recently updated history is not refreshed again.
+     */
+    [[nodiscard]] bool fundingRatesOutdated(const std::string& symbol, const std::int64_t startTime,
+                                            const std::int64_t endTime) const {
+        if (const auto coveredFrom = fundingRateStore->coveredFrom(symbol);
+            coveredFrom < 0 || startTime < coveredFrom) {
+            return true;
+        }
+
+        const auto coveredUntil = fundingRateStore->coveredUntil(symbol);
+
+        if (endTime <= coveredUntil) {
+            return false;
+        }
+
+        const auto nowTimestamp = getMsTimestamp(currentTime()).count();
+        const auto nextFundingTime = fundingRateStore->lastFundingTime(symbol) + MIN_FUNDING_INTERVAL_IN_MS;
+
+        return std::min(endTime, nowTimestamp) >= nextFundingTime
+               && nowTimestamp >= coveredUntil + FUNDING_RATES_REFRESH_INTERVAL_IN_MS;
+    }
+
+    /**
+     * Download Exchange info and store it as the snapshot for the next startup
+     */
+    static void refreshExchangeInfo(const std::shared_ptr<binance::futures::RESTClient> &client,
+                                    const std::filesystem::path &snapshotPath) {
+        const auto [exchange, updateTime] = client->getLazyExchangeInfo(true);
+
+        try {
+            /// The raw response is stored, Exchange info is not decoded
+            binance::futures::saveExchangeSnapshot({exchange, updateTime}, snapshotPath);
+        } catch (const std::exception &e) {
+            spdlog::warn("Cannot save Exchange snapshot {}: {}", snapshotPath.string(), e.what());
+        }
+    }
+
+    /**
+     * Use the stored snapshot and refresh it in the background, download Exchange info synchronously only when
+     * there is no usable snapshot. The snapshot keeps its update time, an outdated one is downloaded again on access
+     * after the running refresh, so a failed refresh is retried.
+     */
+    void initExchangeInfo() {
+        const auto snapshotPath = dataDirectory / EXCHANGE_SNAPSHOT_FILE;
+
+        if (const auto snapshot = binance::futures::loadExchangeSnapshot(snapshotPath)) {
+            restClient->setExchangeInfo(snapshot->exchange, snapshot->lastUpdateTime);
+
+            exchangeRefresh = std::async(std::launch::async, [client = restClient, snapshotPath] {
+                try {
+                    refreshExchangeInfo(client, snapshotPath);
+                } catch (const std::exception &e) {
+                    spdlog::error("Exchange info refresh failed: {}", e.what());
+                }
+            });
+        } else {
+            refreshExchangeInfo(restClient, snapshotPath);
+        }
+    }
+
+    void waitForExchangeRefresh() const {
+        if (exchangeRefresh.valid()) {
+            exchangeRefresh.wait();
+        }
+    }
 
     static binance::Side generalOrderSideToBinanceOrderSide(const Side& side) {
         switch (side) {
@@ -75,13 +175,21 @@ struct BinanceFuturesExchangeConnector::P {
     }
 };
 
-BinanceFuturesExchangeConnector::BinanceFuturesExchangeConnector() : m_p(std::make_unique<P>()) {
+BinanceFuturesExchangeConnector::BinanceFuturesExchangeConnector() : BinanceFuturesExchangeConnector(
+    std::filesystem::temp_directory_path()) {
+}
+
+BinanceFuturesExchangeConnector::BinanceFuturesExchangeConnector(const std::filesystem::path& dataDirectory) : m_p(
+    std::make_unique<P>(dataDirectory)) {
     m_p->restClient = std::make_shared<binance::futures::RESTClient>("","");
-    m_p->streamManager = std::make_unique<binance::futures::WSStreamManager>(m_p->restClient);
-    m_p->restClient->updateExchangeInfo(true);
+    m_p->createStreamManager();
+    m_p->createFundingRateStore();
+    m_p->initExchangeInfo();
 }
 
 BinanceFuturesExchangeConnector::~BinanceFuturesExchangeConnector() {
+    m_p->waitForExchangeRefresh();
+    m_p->fundingRateStore.reset();
     m_p->streamManager.reset();
     m_p->restClient.reset();
 }
@@ -99,12 +207,15 @@ void BinanceFuturesExchangeConnector::setLoggerCallback(const onLogMessage& onLo
 }
 
 void BinanceFuturesExchangeConnector::login(const std::tuple<std::string, std::string, std::string>& credentials) {
+    m_p->waitForExchangeRefresh();
+    m_p->fundingRateStore.reset();
     m_p->streamManager.reset();
     m_p->restClient.reset();
     m_p->restClient = std::make_shared<binance::futures::RESTClient>(std::get<0>(credentials),
                                                                      std::get<1>(credentials));
-    m_p->streamManager = std::make_unique<binance::futures::WSStreamManager>(m_p->restClient);
-    m_p->restClient->updateExchangeInfo(true);
+    m_p->createStreamManager();
+    m_p->createFundingRateStore();
+    m_p->initExchangeInfo();
 }
 
 Trade BinanceFuturesExchangeConnector::placeOrder(const Order& order) {
@@ -187,7 +298,14 @@ FundingRate BinanceFuturesExchangeConnector::getFundingRate(const std::string& s
 std::vector<FundingRate> BinanceFuturesExchangeConnector::getFundingRates() const {
     std::vector<FundingRate> retVal;
 
-    for (const auto& mp : m_p->restClient->getMarkPrices()) {
+    /// premiumIndex is requested only until the first frames arrive or while the stream is stalled
+    auto markPrices = m_p->streamManager->readMarkPrices(MARK_PRICES_MAX_AGE);
+
+    if (markPrices.empty()) {
+        markPrices = m_p->restClient->getMarkPrices();
+    }
+
+    for (const auto& mp : markPrices) {
         FundingRate fr;
         fr.symbol = mp.symbol;
         fr.fundingRate = mp.lastFundingRate;
@@ -207,7 +325,20 @@ std::vector<Position> BinanceFuturesExchangeConnector::getPositionInfo(const std
 }
 
 std::vector<FundingRate> BinanceFuturesExchangeConnector::getHistoricalFundingRates(const std::string& symbol, std::int64_t startTime, std::int64_t endTime) const {
-    throw std::runtime_error("Unimplemented: BinanceFuturesExchangeConnector::getHistoricalFundingRates");
+    /// Only records missing in the store are downloaded, the rest is answered from memory
+    if (m_p->fundingRatesOutdated(symbol, startTime, endTime)) {
+        if (const auto errors = m_p->fundingRateStore->update({symbol}, startTime); !errors.empty()) {
+            throw std::runtime_error(errors.front().message);
+        }
+    }
+
+    std::vector<FundingRate> retVal;
+
+    for (const auto& fr : m_p->fundingRateStore->getFundingRates(symbol, startTime, endTime)) {
+        retVal.push_back({fr.symbol, fr.fundingRate, fr.fundingTime});
+    }
+
+    return retVal;
 }
 
 std::vector<Candle> BinanceFuturesExchangeConnector::getHistoricalCandles(const std::string& symbol, CandleInterval interval, std::int64_t startTime, std::int64_t endTime) const {
@@ -8,14 +8,21 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 
 #include "stonky/binance/binance_futures_rest_client.h"
 #include "stonky/binance/binance_http_session.h"
+#include "stonky/binance/binance_json_parser.h"
+#include "stonky/binance/binance_lazy_exchange.h"
+#include "stonky/binance/binance_parallel_fetch.h"
+#include "stonky/binance/binance_symbol_registry.h"
 #include "stonky/utils/json_utils.h"
 #include "stonky/utils/utils.h"
 #include <mutex>
 #include <future>
+#include <ranges>
 #include <spdlog/spdlog.h>
 
 namespace stonky::binance::futures {
 static constexpr std::int64_t EXCHANGE_DATA_MAX_AGE_S = 3600; /// 1 hour
+static constexpr std::int32_t STATISTICS_PAGE_LIMIT = 500; /// max. limit of futures/data endpoints
+static constexpr int NO_NEED_TO_CHANGE_MARGIN_TYPE = -4046; /// API code of marginType with the current margin type
 
 enum class PrecisionType : int {
     Quantity,
@@ -25,21 +32,71 @@ enum class PrecisionType : int {
 
 struct RESTClient::P {
 private:
-    Exchange m_exchange;
+    std::shared_ptr<const LazyExchange> m_exchange;
+    std::int64_t m_exchangeUpdateTime{-1};
     mutable std::recursive_mutex m_locker;
 
+    [[nodiscard]] std::shared_ptr<const LazyExchange> lazyExchange() const {
+        std::lock_guard lk(m_locker);
+        return m_exchange;
+    }
+
 public:
     RESTClient *parent = nullptr;
     std::shared_ptr<HTTPSession> httpSession;
+    /// Held while Exchange info is downloaded, concurrent callers wait for the download instead of starting another
+    std::mutex exchangeUpdateLocker;
 
     [[nodiscard]] Exchange getExchange() const {
         std::lock_guard lk(m_locker);
-        return m_exchange;
+        Exchange retVal;
+
+        if (m_exchange) {
+            retVal = m_exchange->exchange();
+        }
+
+        retVal.lastUpdateTime = m_exchangeUpdateTime;
+        return retVal;
     }
 
     void setExchange(const Exchange &exchange) {
+        setExchange(std::make_shared<const LazyExchange>(exchange), exchange.lastUpdateTime);
+    }
+
+    void setExchange(std::shared_ptr<const LazyExchange> exchange, const std::int64_t updateTime) {
+        std::lock_guard lk(m_locker);
+        m_exchange = std::move(exchange);
+        m_exchangeUpdateTime = updateTime;
+    }
+
+    [[nodiscard]] std::pair<std::shared_ptr<const LazyExchange>, std::int64_t> lazyExchangeInfo() const {
+        std::lock_guard lk(m_locker);
+        return {m_exchange, m_exchangeUpdateTime};
+    }
+
+    [[nodiscard]] std::int64_t exchangeUpdateTime() const {
+        std::lock_guard lk(m_locker);
+        return m_exchangeUpdateTime;
+    }
+
+    [[nodiscard]] bool hasExchangeSymbols() const {
         std::lock_guard lk(m_locker);
-        m_exchange = exchange;
+        return m_exchange && m_exchange->size() > 0;
+    }
+
+    [[nodiscard]] bool exchangeOutdated() const {
+        const auto updateTime = exchangeUpdateTime();
+        return updateTime < 0 || std::time(nullptr) - updateTime > EXCHANGE_DATA_MAX_AGE_S || !hasExchangeSymbols();
+    }
+
+    [[nodiscard]] std::optional<Symbol> getSymbol(const SymbolId symbolId) const {
+        if (const auto exchange = lazyExchange()) {
+            if (const auto *symbol = exchange->find(symbolId)) {
+                return *symbol;
+            }
+        }
+
+        return std::nullopt;
     }
 
     [[nodiscard]] std::vector<Candle>
@@ -51,23 +108,27 @@ public:
                     int limit) const;
 
     int findPrecisionForSymbol(const PrecisionType &type, const std::string &symbol) const {
-        if (getExchange().lastUpdateTime < 0 || std::time(nullptr) - getExchange().lastUpdateTime >
-            EXCHANGE_DATA_MAX_AGE_S) {
-            this->parent->updateExchangeInfo(true);
+        this->parent->updateExchangeInfo();
+
+        const auto symbolId = SymbolRegistry::instance().find(symbol);
+
+        if (!symbolId) {
+            return 1;
         }
 
-        for (const auto &symbolEl: getExchange().symbols) {
-            if (symbolEl.symbol == symbol) {
-                switch (type) {
-                    case PrecisionType::Quantity:
-                        return symbolEl.quantityPrecision;
-                    case PrecisionType::Price:
-                        return symbolEl.pricePrecision;
-                    case PrecisionType::Quote:
-                        return symbolEl.quotePrecision;
-                }
+        const auto exchange = lazyExchange();
+
+        if (const auto *symbolEl = exchange ? exchange->find(*symbolId) : nullptr) {
+            switch (type) {
+                case PrecisionType::Quantity:
+                    return symbolEl->quantityPrecision;
+                case PrecisionType::Price:
+                    return symbolEl->pricePrecision;
+                case PrecisionType::Quote:
+                    return symbolEl->quotePrecision;
             }
         }
+
         return 1;
     }
 
@@ -89,9 +150,71 @@ public:
     getBuySellVolume(const std::string &symbol, StatisticsPeriod period, std::int64_t startTime,
                      std::int64_t endTime,
                      std::int32_t limit) const;
+
+    /// Same as the methods above but exceptions are propagated to the caller
+    std::vector<OpenInterestStatistics>
+    requestOpenInterestStatistics(const std::string &symbol, StatisticsPeriod period, std::int64_t startTime,
+                                  std::int64_t endTime,
+                                  std::int32_t limit) const;
+
+    std::vector<LongShortRatio>
+    requestLongShortRatio(const std::string &symbol, StatisticsPeriod period, std::int64_t startTime,
+                          std::int64_t endTime,
+                          std::int32_t limit) const;
+
+    std::vector<BuySellVolume>
+    requestBuySellVolume(const std::string &symbol, StatisticsPeriod period, std::int64_t startTime,
+                         std::int64_t endTime,
+                         std::int32_t limit) const;
+
+    /**
+     * Download statistics pages backwards in time starting at endTime until the server returns no more data
+     * @return series ordered from the oldest record
+     */
+    template<typename Series, typename Fetch>
+    static Series fetchStatisticsBackwards(const Fetch &fetchPage, std::int64_t endTime) {
+        std::vector<decltype(fetchPage(endTime))> pages;
+        std::size_t numRecords = 0;
+
+        for (auto page = fetchPage(endTime); !page.empty(); page = fetchPage(endTime)) {
+            endTime = page.front().timestamp - 1;
+            numRecords += page.size();
+            pages.push_back(std::move(page));
+        }
+
+        Series retVal;
+        retVal.reserve(numRecords);
+
+        for (auto it = pages.rbegin(); it != pages.rend(); ++it) {
+            for (const auto &record: *it) {
+                retVal.push_back(record);
+            }
+        }
+
+        return retVal;
+    }
+
+    /**
+     * Run fetchSeries for every symbol on at most maxParallelRequests threads, failures are collected per symbol
+     */
+    template<typename Series, typename Fetch>
+    static MultiSymbolSeries<Series>
+    fetchForSymbols(const std::vector<std::string> &symbols, const std::size_t maxParallelRequests,
+                    const Fetch &fetchSeries) {
+        MultiSymbolSeries<Series> retVal;
+        std::mutex locker;
+
+        retVal.errors = forEachSymbol(symbols, maxParallelRequests, [&](const std::string &symbol) {
+            auto series = fetchSeries(symbol);
+            std::lock_guard lk(locker);
+            retVal.series.insert_or_assign(symbol, std::move(series));
+        });
+
+        return retVal;
+    }
 };
 
-http::response<http::string_body> checkResponse(const http::response<http::string_body> &response) {
+http::response<http::string_body> checkResponse(http::response<http::string_body> response) {
     if (response.result() != http::status::ok) {
         ErrorResponse errorResponse;
         errorResponse.fromJson(nlohmann::json::parse(response.body()));
@@ -139,7 +262,7 @@ RESTClient::P::getFundingRates(const std::string &symbol, const int64_t startTim
 
     const auto response = checkResponse(httpSession->get(path, true));
     FundingRates fundingRates;
-    fundingRates.fromJson(nlohmann::json::parse(response.body()));
+    parseResponse(response.body(), fundingRates);
     return fundingRates.fundingRates;
 }
 
@@ -150,7 +273,7 @@ FundingRate RESTClient::getLastFundingRate(const std::string &symbol) const {
 
     const auto response = checkResponse(m_p->httpSession->get("fundingRate?symbol=" + symbol, true));
     FundingRates fundingRates;
-    fundingRates.fromJson(nlohmann::json::parse(response.body()));
+    parseResponse(response.body(), fundingRates);
 
     std::ranges::sort(fundingRates.fundingRates,
                       [](const FundingRate &a, const FundingRate &b) -> bool {
@@ -193,13 +316,39 @@ BookTickerPrice RESTClient::getBookTickerPrice(const std::string &symbol) const
     return bookTickerPrice;
 }
 
+std::unordered_map<std::string, TickerPrice> RESTClient::getTickerPrices() const {
+    const auto response = checkResponse(m_p->httpSession->get("ticker/price", true));
+    TickerPrices tickerPrices;
+    tickerPrices.fromJson(nlohmann::json::parse(response.body()));
+    return tickerPrices.tickerPrices;
+}
+
+std::unordered_map<std::string, BookTickerPrice> RESTClient::getBookTickerPrices() const {
+    const auto response = checkResponse(m_p->httpSession->get("ticker/bookTicker", true));
+    BookTickerPrices bookTickerPrices;
+    bookTickerPrices.fromJson(nlohmann::json::parse(response.body()));
+    return bookTickerPrices.bookTickerPrices;
+}
+
 std::vector<MarkPrice> RESTClient::getMarkPrices() const {
     const auto response = checkResponse(m_p->httpSession->get("premiumIndex", true));
     MarkPrices markPrices;
-    markPrices.fromJson(nlohmann::json::parse(response.body()));
+    parseResponse(response.body(), markPrices);
     return markPrices.markPrices;
 }
 
+/**
+ * Append the exact decimal if set, otherwise the double formatted to the precision
+ */
+static void appendDecimal(std::string &path, const std::optional<Decimal> &exact, const int precision,
+                          const double value) {
+    if (exact.has_value()) {
+        exact->appendTo(path);
+    } else {
+        path.append(formatDouble(precision, value));
+    }
+}
+
 OrderResponse RESTClient::sendOrder(const Order &order) const {
     auto quantityPrecision = m_p->findPrecisionForSymbol(PrecisionType::Quantity, order.symbol);
     auto pricePrecision = m_p->findPrecisionForSymbol(PrecisionType::Price, order.symbol);
@@ -221,33 +370,33 @@ OrderResponse RESTClient::sendOrder(const Order &order) const {
         path.append(magic_enum::enum_name(order.timeInForce));
 
         path.append("&quantity=");
-        path.append(formatDouble(quantityPrecision, order.quantity));
+        appendDecimal(path, order.exactQuantity, quantityPrecision, order.quantity);
 
         path.append("&price=");
-        path.append(formatDouble(pricePrecision, order.price));
+        appendDecimal(path, order.exactPrice, pricePrecision, order.price);
     } else if (order.type == OrderType::MARKET) {
         path.append("&quantity=");
-        path.append(formatDouble(quantityPrecision, order.quantity));
+        appendDecimal(path, order.exactQuantity, quantityPrecision, order.quantity);
     } else if (order.type == OrderType::STOP ||
                order.type == OrderType::TAKE_PROFIT) {
         path.append("&quantity=");
-        path.append(formatDouble(quantityPrecision, order.quantity));
+        appendDecimal(path, order.exactQuantity, quantityPrecision, order.quantity);
 
         path.append("&price=");
-        path.append(formatDouble(pricePrecision, order.price));
+        appendDecimal(path, order.exactPrice, pricePrecision, order.price);
 
         path.append("&stopPrice=");
         path.append(formatDouble(pricePrecision, order.stopPrice));
     } else if (order.type == OrderType::STOP_MARKET ||
                order.type == OrderType::TAKE_PROFIT_MARKET) {
         path.append("&quantity=");
-        path.append(formatDouble(quantityPrecision, order.quantity));
+        appendDecimal(path, order.exactQuantity, quantityPrecision, order.quantity);
 
         path.append("&stopPrice=");
         path.append(formatDouble(pricePrecision, order.stopPrice));
     } else if (order.type == OrderType::TRAILING_STOP_MARKET) {
         path.append("&quantity=");
-        path.append(formatDouble(quantityPrecision, order.quantity));
+        appendDecimal(path, order.exactQuantity, quantityPrecision, order.quantity);
 
         path.append("&callbackRate=");
         path.append(std::to_string(order.callbackRate));
@@ -333,7 +482,7 @@ RESTClient::P::getHistoricalPrices(const std::string &symbol, const CandleInterv
 
     auto response = checkResponse(httpSession->get(path, true));
     CandlesResponse candlesResponse;
-    candlesResponse.fromJson(nlohmann::json::parse(response.body()));
+    parseResponse(response.body(), candlesResponse);
 
     return candlesResponse.candles;
 }
@@ -367,7 +516,7 @@ RESTClient::getHistoricalPricesSingle(const std::string &symbol, const CandleInt
 
     auto response = checkResponse(m_p->httpSession->get(path, true));
     CandlesResponse candlesResponse;
-    candlesResponse.fromJson(nlohmann::json::parse(response.body()));
+    parseResponse(response.body(), candlesResponse);
 
     return candlesResponse.candles;
 }
@@ -481,20 +630,25 @@ Exchange RESTClient::getExchangeInfo(const bool force) const {
     return m_p->getExchange();
 }
 
-void RESTClient::updateExchangeInfo(bool force) const {
+std::pair<std::shared_ptr<const LazyExchange>, std::int64_t> RESTClient::getLazyExchangeInfo(const bool force) const {
+    updateExchangeInfo(force);
+    return m_p->lazyExchangeInfo();
+}
 
-    if (m_p->getExchange().lastUpdateTime < 0 || std::time(nullptr) - m_p->getExchange().lastUpdateTime > EXCHANGE_DATA_MAX_AGE_S) {
-        force = true;
+void RESTClient::updateExchangeInfo(const bool force) const {
+    if (!force && !m_p->exchangeOutdated()) {
+        return;
     }
 
-    if (m_p->getExchange().symbols.empty() || force) {
-        const auto response = checkResponse(m_p->httpSession->get("exchangeInfo?", true));
+    std::lock_guard lk(m_p->exchangeUpdateLocker);
 
-        Exchange exchange;
-        exchange.fromJson(nlohmann::json::parse(response.body()));
-        exchange.lastUpdateTime = std::time(nullptr);
-        m_p->setExchange(exchange);
+    /// Exchange info may have been downloaded while waiting for the lock
+    if (!force && !m_p->exchangeOutdated()) {
+        return;
     }
+
+    auto response = checkResponse(m_p->httpSession->get("exchangeInfo?", true));
+    m_p->setExchange(std::make_shared<const LazyExchange>(std::move(response.body())), std::time(nullptr));
 }
 
 std::vector<AccountBalance> RESTClient::getAccountBalances() const {
@@ -591,7 +745,8 @@ std::string RESTClient::getDownloadUrl(const DownloadId &downloadId) const {
 
 std::vector<Income> RESTClient::getIncome(const std::string &symbol, const std::int64_t startTime,
                                           const std::int64_t endTime,
-                                          const IncomeType incomeType) const {
+                                          const IncomeType incomeType, const std::int32_t limit,
+                                          const std::int32_t page) const {
     std::string path = "income?";
 
     if (!symbol.empty()) {
@@ -601,7 +756,7 @@ std::vector<Income> RESTClient::getIncome(const std::string &symbol, const std::
 
     if (incomeType != IncomeType::ALL) {
         path.append("&incomeType=");
-        path.append(symbol);
+        path.append(magic_enum::enum_name(incomeType));
     }
 
     if (startTime != -1) {
@@ -614,9 +769,19 @@ std::vector<Income> RESTClient::getIncome(const std::string &symbol, const std::
         path.append(std::to_string(endTime));
     }
 
+    if (limit != -1) {
+        path.append("&limit=");
+        path.append(std::to_string(limit));
+    }
+
+    if (page != -1) {
+        path.append("&page=");
+        path.append(std::to_string(page));
+    }
+
     const auto response = checkResponse(m_p->httpSession->get(path, false));
     Incomes incomes;
-    incomes.fromJson(nlohmann::json::parse(response.body()));
+    parseResponse(response.body(), incomes);
     return incomes.incomes;
 }
 
@@ -655,8 +820,12 @@ RESTClient::getHistoricalPrices(const std::vector<std::string> &symbols, CandleI
 }
 
 std::vector<PositionRisk> RESTClient::getPositionRisk(const std::string &symbol) const {
-    std::string path = "positionRisk?symbol=";
-    path.append(symbol);
+    std::string path = "positionRisk?";
+
+    if (!symbol.empty()) {
+        path.append("&symbol=");
+        path.append(symbol);
+    }
 
     const auto response = checkResponse(m_p->httpSession->get(path, false));
     std::vector<PositionRisk> retVal;
@@ -682,6 +851,25 @@ void RESTClient::setExchangeInfo(const Exchange &exchange) const {
     m_p->setExchange(exchange);
 }
 
+void RESTClient::setExchangeInfo(std::shared_ptr<const LazyExchange> exchange, const std::int64_t updateTime) const {
+    m_p->setExchange(std::move(exchange), updateTime);
+}
+
+std::optional<Symbol> RESTClient::getSymbol(const SymbolId symbolId) const {
+    updateExchangeInfo();
+    return m_p->getSymbol(symbolId);
+}
+
+std::optional<Symbol> RESTClient::getSymbol(const std::string &symbol) const {
+    updateExchangeInfo();
+
+    if (const auto symbolId = SymbolRegistry::instance().find(symbol)) {
+        return m_p->getSymbol(*symbolId);
+    }
+
+    return std::nullopt;
+}
+
 std::pair<int, double> RESTClient::changeInitialLeverage(const std::string &symbol, const int leverage) const {
     std::string path = "leverage?symbol=";
     path.append(symbol);
@@ -692,11 +880,71 @@ std::pair<int, double> RESTClient::changeInitialLeverage(const std::string &symb
     const nlohmann::json responseJson = nlohmann::json::parse(response.body());
 
     int targetLeverage;
-    std::string maxNotionalValue;
     readValue<int>(responseJson, "leverage", targetLeverage);
-    readValue<std::string>(responseJson, "maxNotionalValue", maxNotionalValue);
 
-    return {targetLeverage, stod(maxNotionalValue)};
+    return {targetLeverage, readDecimal(responseJson, "maxNotionalValue")};
+}
+
+void RESTClient::changeMarginType(const std::string &symbol, const MarginType marginType) const {
+    std::string path = "marginType?symbol=";
+    path.append(symbol);
+    path.append("&marginType=");
+    path.append(marginType == MarginType::CROSS ? "CROSSED" : "ISOLATED");
+
+    const auto response = m_p->httpSession->post(path, "", false);
+
+    if (response.result() != http::status::ok) {
+        ErrorResponse errorResponse;
+        errorResponse.fromJson(nlohmann::json::parse(response.body()));
+
+        /// The symbol already has the margin type
+        if (errorResponse.code == NO_NEED_TO_CHANGE_MARGIN_TYPE) {
+            return;
+        }
+    }
+
+    checkResponse(response);
+}
+
+std::vector<FetchError>
+RESTClient::configureSymbols(const std::vector<SymbolConfiguration> &configurations,
+                             const std::size_t maxParallelRequests) const {
+    /// Leverage and margin type are shared by both sides in Hedge mode, the first record of a symbol is enough
+    std::map<std::string, PositionRisk> positionRisks;
+
+    for (const auto &positionRisk: getPositionRisk("")) {
+        positionRisks.try_emplace(positionRisk.symbol, positionRisk);
+    }
+
+    std::map<std::string, SymbolConfiguration> changes;
+
+    for (const auto &configuration: configurations) {
+        if (const auto it = positionRisks.find(configuration.symbol);
+            it == positionRisks.end() || it->second.leverage != configuration.leverage ||
+            it->second.marginType != configuration.marginType) {
+            changes.insert_or_assign(configuration.symbol, configuration);
+        }
+    }
+
+    std::vector<std::string> symbols;
+    symbols.reserve(changes.size());
+
+    for (const auto &symbol: changes | std::views::keys) {
+        symbols.push_back(symbol);
+    }
+
+    return forEachSymbol(symbols, maxParallelRequests, [&](const std::string &symbol) {
+        const auto &configuration = changes.at(symbol);
+        const auto it = positionRisks.find(symbol);
+
+        if (it == positionRisks.end() || it->second.marginType != configuration.marginType) {
+            changeMarginType(symbol, configuration.marginType);
+        }
+
+        if (it == positionRisks.end() || it->second.leverage != configuration.leverage) {
+            [[maybe_unused]] const auto result = changeInitialLeverage(symbol, configuration.leverage);
+        }
+    });
 }
 
 std::vector<FundingRate>
@@ -739,181 +987,255 @@ OpenInterest RESTClient::getOpenInterest(const std::string &symbol) const {
     return retVal;
 }
 
+OrderBookSnapshot RESTClient::getOrderBook(const std::string &symbol, const int limit) const {
+    if (symbol.empty()) {
+        throw std::runtime_error(std::string("Invalid parameter, symbol must be specified").c_str());
+    }
+
+    std::string path = "depth?symbol=";
+    path.append(symbol);
+    path.append("&limit=");
+    path.append(std::to_string(limit));
+
+    const auto response = checkResponse(m_p->httpSession->get(path, true));
+    OrderBookSnapshot retVal;
+    retVal.fromJson(nlohmann::json::parse(response.body()));
+    return retVal;
+}
+
 std::vector<OpenInterestStatistics>
-RESTClient::P::getOpenInterestStatistics(const std::string &symbol, const StatisticsPeriod period,
-                                         const std::int64_t startTime,
-                                         const std::int64_t endTime,
-                                         const std::int32_t limit) const {
-    std::vector<OpenInterestStatistics> retVal;
+RESTClient::P::requestOpenInterestStatistics(const std::string &symbol, const StatisticsPeriod period,
+                                             const std::int64_t startTime,
+                                             const std::int64_t endTime,
+                                             const std::int32_t limit) const {
+    std::string path = "/futures/data/openInterestHist?symbol=";
+    path.append(symbol);
 
-    try {
-        std::string path = "/futures/data/openInterestHist?symbol=";
-        path.append(symbol);
+    path.append("&period=");
+    auto periodStr = std::string(magic_enum::enum_name(period));
+    periodStr.erase(0, 1);
+    path.append(periodStr);
 
-        path.append("&period=");
-        auto periodStr = std::string(magic_enum::enum_name(period));
-        periodStr.erase(0, 1);
-        path.append(periodStr);
+    if (startTime != -1) {
+        path.append("&startTime=");
+        path.append(std::to_string(startTime));
+    }
 
-        if (startTime != -1) {
-            path.append("&startTime=");
-            path.append(std::to_string(startTime));
-        }
+    if (endTime != -1) {
+        path.append("&endTime=");
+        path.append(std::to_string(endTime));
+    }
 
-        if (endTime != -1) {
-            path.append("&endTime=");
-            path.append(std::to_string(endTime));
-        }
+    if (limit != -1) {
+        path.append("&limit=");
+        path.append(std::to_string(limit));
+    }
 
-        if (limit != -1) {
-            path.append("&limit=");
-            path.append(std::to_string(limit));
-        }
+    const auto response = checkResponse(httpSession->getFutures(path));
+    std::vector<OpenInterestStatistics> retVal;
 
-        const auto response = checkResponse(httpSession->getFutures(path));
+    for (nlohmann::json jsonObject = nlohmann::json::parse(response.body()); const auto &el: jsonObject) {
+        OpenInterestStatistics openInterestStatistics;
+        openInterestStatistics.fromJson(el);
+        retVal.push_back(openInterestStatistics);
+    }
 
-        for (nlohmann::json jsonObject = nlohmann::json::parse(response.body()); const auto &el: jsonObject) {
-            OpenInterestStatistics openInterestStatistics;
-            openInterestStatistics.fromJson(el);
-            retVal.push_back(openInterestStatistics);
-        }
+    return retVal;
+}
+
+std::vector<OpenInterestStatistics>
+RESTClient::P::getOpenInterestStatistics(const std::string &symbol, const StatisticsPeriod period,
+                                         const std::int64_t startTime,
+                                         const std::int64_t endTime,
+                                         const std::int32_t limit) const {
+    try {
+        return requestOpenInterestStatistics(symbol, period, startTime, endTime, limit);
     } catch (const std::exception &e) {
         spdlog::warn(fmt::format("Exception: {}", e.what()));
     }
-    return retVal;
+
+    return {};
 }
 
 std::vector<OpenInterestStatistics>
 RESTClient::getOpenInterestStatistics(const std::string &symbol, const StatisticsPeriod period,
                                       std::int64_t startTime) const {
     std::vector<OpenInterestStatistics> retVal;
-    std::vector<OpenInterestStatistics> statistics = m_p->getOpenInterestStatistics(symbol, period, -1, startTime, 500);
+    std::vector<OpenInterestStatistics> statistics = m_p->getOpenInterestStatistics(symbol, period, -1, startTime, STATISTICS_PAGE_LIMIT);
 
     while (!statistics.empty()) {
         retVal.insert(retVal.begin(), statistics.begin(), statistics.end());
         startTime = statistics.front().timestamp - 1;
         statistics.clear();
-        statistics = m_p->getOpenInterestStatistics(symbol, period, -1, startTime, 500);
+        statistics = m_p->getOpenInterestStatistics(symbol, period, -1, startTime, STATISTICS_PAGE_LIMIT);
     }
 
     return retVal;
 }
 
 std::vector<LongShortRatio>
-RESTClient::P::getLongShortRatio(const std::string &symbol, const StatisticsPeriod period, const std::int64_t startTime,
-                                 const std::int64_t endTime,
-                                 const std::int32_t limit) const {
-    std::vector<LongShortRatio> retVal;
+RESTClient::P::requestLongShortRatio(const std::string &symbol, const StatisticsPeriod period,
+                                     const std::int64_t startTime,
+                                     const std::int64_t endTime,
+                                     const std::int32_t limit) const {
+    std::string path = "/futures/data/globalLongShortAccountRatio?symbol=";
+    path.append(symbol);
 
-    try {
-        std::string path = "/futures/data/globalLongShortAccountRatio?symbol=";
-        path.append(symbol);
+    path.append("&period=");
+    auto periodStr = std::string(magic_enum::enum_name(period));
+    periodStr.erase(0, 1);
+    path.append(periodStr);
 
-        path.append("&period=");
-        auto periodStr = std::string(magic_enum::enum_name(period));
-        periodStr.erase(0, 1);
-        path.append(periodStr);
+    if (startTime != -1) {
+        path.append("&startTime=");
+        path.append(std::to_string(startTime));
+    }
 
-        if (startTime != -1) {
-            path.append("&startTime=");
-            path.append(std::to_string(startTime));
-        }
+    if (endTime != -1) {
+        path.append("&endTime=");
+        path.append(std::to_string(endTime));
+    }
 
-        if (endTime != -1) {
-            path.append("&endTime=");
-            path.append(std::to_string(endTime));
-        }
+    if (limit != -1) {
+        path.append("&limit=");
+        path.append(std::to_string(limit));
+    }
 
-        if (limit != -1) {
-            path.append("&limit=");
-            path.append(std::to_string(limit));
-        }
+    const auto response = checkResponse(httpSession->getFutures(path));
+    std::vector<LongShortRatio> retVal;
 
-        const auto response = checkResponse(httpSession->getFutures(path));
+    for (nlohmann::json jsonObject = nlohmann::json::parse(response.body()); const auto &el: jsonObject) {
+        LongShortRatio longShortRatio;
+        longShortRatio.fromJson(el);
+        retVal.push_back(longShortRatio);
+    }
 
-        for (nlohmann::json jsonObject = nlohmann::json::parse(response.body()); const auto &el: jsonObject) {
-            LongShortRatio longShortRatio;
-            longShortRatio.fromJson(el);
-            retVal.push_back(longShortRatio);
-        }
+    return retVal;
+}
+
+std::vector<LongShortRatio>
+RESTClient::P::getLongShortRatio(const std::string &symbol, const StatisticsPeriod period, const std::int64_t startTime,
+                                 const std::int64_t endTime,
+                                 const std::int32_t limit) const {
+    try {
+        return requestLongShortRatio(symbol, period, startTime, endTime, limit);
     } catch (const std::exception &e) {
         spdlog::warn(fmt::format("Exception: {}", e.what()));
     }
 
-    return retVal;
+    return {};
 }
 
 std::vector<LongShortRatio>
 RESTClient::getLongShortRatio(const std::string &symbol, const StatisticsPeriod period, std::int64_t startTime) const {
     std::vector<LongShortRatio> retVal;
-    std::vector<LongShortRatio> ratio = m_p->getLongShortRatio(symbol, period, -1, startTime, 500);
+    std::vector<LongShortRatio> ratio = m_p->getLongShortRatio(symbol, period, -1, startTime, STATISTICS_PAGE_LIMIT);
 
     while (!ratio.empty()) {
         retVal.insert(retVal.begin(), ratio.begin(), ratio.end());
         startTime = ratio.front().timestamp - 1;
         ratio.clear();
-        ratio = m_p->getLongShortRatio(symbol, period, -1, startTime, 500);
+        ratio = m_p->getLongShortRatio(symbol, period, -1, startTime, STATISTICS_PAGE_LIMIT);
     }
 
     return retVal;
 }
 
 std::vector<BuySellVolume>
-RESTClient::P::getBuySellVolume(const std::string &symbol, const StatisticsPeriod period, const std::int64_t startTime,
-                                const std::int64_t endTime,
-                                const std::int32_t limit) const {
-    std::vector<BuySellVolume> retVal;
+RESTClient::P::requestBuySellVolume(const std::string &symbol, const StatisticsPeriod period,
+                                    const std::int64_t startTime,
+                                    const std::int64_t endTime,
+                                    const std::int32_t limit) const {
+    std::string path = "/futures/data/takerlongshortRatio?symbol=";
+    path.append(symbol);
 
-    try {
-        std::string path = "/futures/data/takerlongshortRatio?symbol=";
-        path.append(symbol);
+    path.append("&period=");
+    auto periodStr = std::string(magic_enum::enum_name(period));
+    periodStr.erase(0, 1);
+    path.append(periodStr);
 
-        path.append("&period=");
-        auto periodStr = std::string(magic_enum::enum_name(period));
-        periodStr.erase(0, 1);
-        path.append(periodStr);
+    if (startTime != -1) {
+        path.append("&startTime=");
+        path.append(std::to_string(startTime));
+    }
 
-        if (startTime != -1) {
-            path.append("&startTime=");
-            path.append(std::to_string(startTime));
-        }
+    if (endTime != -1) {
+        path.append("&endTime=");
+        path.append(std::to_string(endTime));
+    }
 
-        if (endTime != -1) {
-            path.append("&endTime=");
-            path.append(std::to_string(endTime));
-        }
+    if (limit != -1) {
+        path.append("&limit=");
+        path.append(std::to_string(limit));
+    }
 
-        if (limit != -1) {
-            path.append("&limit=");
-            path.append(std::to_string(limit));
-        }
+    const auto response = checkResponse(httpSession->getFutures(path));
+    std::vector<BuySellVolume> retVal;
 
-        const auto response = checkResponse(httpSession->getFutures(path));
+    for (nlohmann::json jsonObject = nlohmann::json::parse(response.body()); const auto &el: jsonObject) {
+        BuySellVolume buySellVolume;
+        buySellVolume.fromJson(el);
+        retVal.push_back(buySellVolume);
+    }
 
-        for (nlohmann::json jsonObject = nlohmann::json::parse(response.body()); const auto &el: jsonObject) {
-            BuySellVolume buySellVolume;
-            buySellVolume.fromJson(el);
-            retVal.push_back(buySellVolume);
-        }
+    return retVal;
+}
+
+std::vector<BuySellVolume>
+RESTClient::P::getBuySellVolume(const std::string &symbol, const StatisticsPeriod period, const std::int64_t startTime,
+                                const std::int64_t endTime,
+                                const std::int32_t limit) const {
+    try {
+        return requestBuySellVolume(symbol, period, startTime, endTime, limit);
     } catch (const std::exception &e) {
         spdlog::warn(fmt::format("Exception: {}", e.what()));
     }
 
-    return retVal;
+    return {};
 }
 
 std::vector<BuySellVolume>
 RESTClient::getBuySellVolume(const std::string &symbol, const StatisticsPeriod period, std::int64_t startTime) const {
     std::vector<BuySellVolume> retVal;
-    std::vector<BuySellVolume> bsVolume = m_p->getBuySellVolume(symbol, period, -1, startTime, 500);
+    std::vector<BuySellVolume> bsVolume = m_p->getBuySellVolume(symbol, period, -1, startTime, STATISTICS_PAGE_LIMIT);
 
     while (!bsVolume.empty()) {
         retVal.insert(retVal.begin(), bsVolume.begin(), bsVolume.end());
         startTime = bsVolume.front().timestamp - 1;
         bsVolume.clear();
-        bsVolume = m_p->getBuySellVolume(symbol, period, -1, startTime, 500);
+        bsVolume = m_p->getBuySellVolume(symbol, period, -1, startTime, STATISTICS_PAGE_LIMIT);
     }
 
     return retVal;
 }
+
+MultiSymbolSeries<OpenInterestStatisticsSeries>
+RESTClient::getOpenInterestStatistics(const std::vector<std::string> &symbols, const StatisticsPeriod period,
+                                      const std::int64_t startTime, const std::size_t maxParallelRequests) const {
+    return P::fetchForSymbols<OpenInterestStatisticsSeries>(symbols, maxParallelRequests, [&](const std::string &symbol) {
+        return P::fetchStatisticsBackwards<OpenInterestStatisticsSeries>([&](const std::int64_t endTime) {
+            return m_p->requestOpenInterestStatistics(symbol, period, -1, endTime, STATISTICS_PAGE_LIMIT);
+        }, startTime);
+    });
+}
+
+MultiSymbolSeries<LongShortRatioSeries>
+RESTClient::getLongShortRatio(const std::vector<std::string> &symbols, const StatisticsPeriod period,
+                              const std::int64_t startTime, const std::size_t maxParallelRequests) const {
+    return P::fetchForSymbols<LongShortRatioSeries>(symbols, maxParallelRequests, [&](const std::string &symbol) {
+        return P::fetchStatisticsBackwards<LongShortRatioSeries>([&](const std::int64_t endTime) {
+            return m_p->requestLongShortRatio(symbol, period, -1, endTime, STATISTICS_PAGE_LIMIT);
+        }, startTime);
+    });
+}
+
+MultiSymbolSeries<BuySellVolumeSeries>
+RESTClient::getBuySellVolume(const std::vector<std::string> &symbols, const StatisticsPeriod period,
+                             const std::int64_t startTime, const std::size_t maxParallelRequests) const {
+    return P::fetchForSymbols<BuySellVolumeSeries>(symbols, maxParallelRequests, [&](const std::string &symbol) {
+        return P::fetchStatisticsBackwards<BuySellVolumeSeries>([&](const std::int64_t endTime) {
+            return m_p->requestBuySellVolume(symbol, period, -1, endTime, STATISTICS_PAGE_LIMIT);
+        }, startTime);
+    });
+}
 }
@@ -1,162 +1,630 @@
-/**
-Binance Futures WebSocket Client
-
-Licensed under the MIT License <http://opensource.org/licenses/MIT>.
-SPDX-License-Identifier: MIT
-Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
-*/
-
-#include "stonky/binance/binance_futures_ws_client.h"
-#include "stonky/utils/json_utils.h"
-#include <boost/beast/core.hpp>
-#include <boost/algorithm/string/case_conv.hpp>
-#include <thread>
-
-using namespace std::chrono_literals;
-
-namespace stonky::binance::futures {
-#define STRINGIZE_I(x) #x
-#define STRINGIZE(x) STRINGIZE_I(x)
-
-#define MAKE_FILELINE \
-    __FILE__ "(" STRINGIZE(__LINE__) ")"
-
-static auto BINANCE_FUTURES_WS_HOST = "fstream.binance.com";
-static auto BINANCE_FUTURES_WS_PORT = "443";
-
-struct WebSocketClient::P {
-    boost::asio::io_context ioContext;
-    boost::asio::ssl::context ctx;
-    std::string host = {BINANCE_FUTURES_WS_HOST};
-    std::string port = {BINANCE_FUTURES_WS_PORT};
-    std::vector<std::weak_ptr<WebSocketSession> > sessions;
-    std::thread ioThread;
-    std::atomic<bool> isRunning = false;
-    onLogMessage logMessageCB;
-
-    void removeDeadWebsockets() {
-        for (auto it = sessions.begin(); it != sessions.end();) {
-            if (!it->lock()) {
-                it = sessions.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
-
-    P() : ctx(boost::asio::ssl::context::sslv23_client) {
-    }
-};
-
-WebSocketClient::WebSocketClient() : m_p(std::make_unique<P>()) {
-}
-
-WebSocketClient::~WebSocketClient() {
-    m_p->ioContext.stop();
-
-    if (m_p->ioThread.joinable()) {
-        m_p->ioThread.join();
-    }
-}
-
-std::string WebSocketClient::composeStreamName(const std::string &pair, const std::string &channel) {
-    std::string res{"/ws/"};
-    if (!pair.empty()) {
-        res += pair;
-        if (pair != "!") {
-            boost::algorithm::to_lower(res);
-        }
-
-        res += '@';
-    }
-
-    res += channel;
-
-    return res;
-}
-
-void WebSocketClient::run() const {
-    if (m_p->isRunning) {
-        return;
-    }
-
-    m_p->isRunning = true;
-
-    if (m_p->ioThread.joinable()) {
-        m_p->ioThread.join();
-    }
-
-    m_p->ioThread = std::thread([&] {
-        for (;;) {
-            try {
-                m_p->isRunning = true;
-
-                if (m_p->ioContext.stopped()) {
-                    m_p->ioContext.restart();
-                }
-                m_p->ioContext.run();
-                m_p->isRunning = false;
-                break;
-            } catch (std::exception &e) {
-                if (m_p->logMessageCB) {
-                    m_p->logMessageCB(LogSeverity::Error, fmt::format("{}: {}\n", MAKE_FILELINE, e.what()));
-                }
-            }
-        }
-
-        m_p->isRunning = false;
-    });
-}
-
-void WebSocketClient::setLoggerCallback(const onLogMessage &onLogMessageCB) const {
-    m_p->logMessageCB = onLogMessageCB;
-}
-
-bool WebSocketClient::findStream(const std::string &streamName) const {
-    for (auto &m_session: m_p->sessions) {
-        if (const auto session = m_session.lock()) {
-            if (session->target() == streamName) {
-                return true;
-            }
-        }
-    }
-
-    return false;
-}
-
-void WebSocketClient::bookTicker(const std::string &pair, const onJSONMessage &cb) const {
-    m_p->removeDeadWebsockets();
-    const std::string streamName = composeStreamName(pair, "bookTicker");
-    const auto ws = std::make_shared<WebSocketSession>(m_p->ioContext, m_p->ctx, m_p->logMessageCB);
-    std::weak_ptr wp{ws};
-    m_p->sessions.emplace_back(std::move(wp));
-    ws->run(BINANCE_FUTURES_WS_HOST, BINANCE_FUTURES_WS_PORT, streamName, cb);
-}
-
-void WebSocketClient::candlestick(const std::string &pair, const CandleInterval interval,
-                                  const onJSONMessage &cb) const {
-    m_p->removeDeadWebsockets();
-    std::string channel("kline");
-    channel.append(magic_enum::enum_name(interval));
-    const std::string streamName = composeStreamName(pair, channel);
-    const auto ws = std::make_shared<WebSocketSession>(m_p->ioContext, m_p->ctx, m_p->logMessageCB);
-    std::weak_ptr wp{ws};
-    m_p->sessions.emplace_back(std::move(wp));
-    ws->run(BINANCE_FUTURES_WS_HOST, BINANCE_FUTURES_WS_PORT, streamName, cb);
-}
-
-void WebSocketClient::partialBookDepthStream(const std::string &pair, int depth, const onJSONMessage &cb) const {
-    if (depth != 5 && depth != 10 && depth != 20) {
-        throw std::invalid_argument(fmt::format("invalid depth parameter, must be 5, 10 or 20, is {}", depth));
-    }
-
-    m_p->removeDeadWebsockets();
-    std::string channel("depth");
-    channel.append(std::to_string(depth));
-    const std::string streamName = composeStreamName(pair, channel);
-    const auto ws = std::make_shared<WebSocketSession>(m_p->ioContext, m_p->ctx, m_p->logMessageCB);
-    std::weak_ptr wp{ws};
-    m_p->sessions.emplace_back(std::move(wp));
-    ws->run(BINANCE_FUTURES_WS_HOST, BINANCE_FUTURES_WS_PORT, streamName, cb);
-}
-}
+/**
+Binance Futures WebSocket Client
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_futures_ws_client.h"
+#include "stonky/binance/binance_event_parser.h"
+#include "stonky/binance/binance_frame_reader.h"
+#include "stonky/utils/json_utils.h"
+#include <boost/beast/core.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <nlohmann/json.hpp>
+#include <map>
+#include <mutex>
+#include <ranges>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std::chrono_literals;
+
+namespace stonky::binance::futures {
+#define STRINGIZE_I(x) #x
+#define STRINGIZE(x) STRINGIZE_I(x)
+
+#define MAKE_FILELINE \
+    __FILE__ "(" STRINGIZE(__LINE__) ")"
+
+static auto BINANCE_FUTURES_WS_HOST = "fstream.binance.com";
+static auto BINANCE_FUTURES_WS_PORT = "443";
+static constexpr std::string_view RAW_STREAM_PREFIX = "/ws/";
+static auto COMBINED_STREAM_TARGET = "/stream?streams=";
+
+/**
+ * Connection shared by multiple streams
+ */
+struct CombinedConnection {
+    boost::asio::io_context *ioContext = nullptr;
+    std::shared_ptr<WebSocketSession> session;
+    std::mutex locker;
+    /// Keyed by stream name without /ws/ prefix, e.g. btcusdt@bookTicker. Handlers are shared, so dispatching a frame
+    /// copies a pointer instead of the handler and the event it keeps.
+    std::map<std::string, std::shared_ptr<onRawMessage>, std::less<> > handlers;
+    /// Streams waiting for the next SUBSCRIBE request
+    std::vector<std::string> pendingStreams;
+    std::int64_t lastRequestId{};
+};
+
+struct WebSocketClient::P {
+    /// One io_context per IO thread, a session is served by the thread of its io_context only
+    std::vector<std::unique_ptr<boost::asio::io_context> > ioContexts;
+    /// Keep io_contexts without sessions running, a stream may be sharded onto them after run()
+    std::vector<boost::asio::executor_work_guard<boost::asio::io_context::executor_type> > workGuards;
+    boost::asio::ssl::context ctx;
+    std::string host = {BINANCE_FUTURES_WS_HOST};
+    std::string port = {BINANCE_FUTURES_WS_PORT};
+    std::vector<std::weak_ptr<WebSocketSession> > sessions;
+    std::vector<std::thread> ioThreads;
+    bool pinThreads{false};
+    std::atomic<bool> isRunning = false;
+    std::atomic<std::size_t> numRunningThreads{0};
+    onLogMessage logMessageCB;
+    onStreamGap streamGapCB;
+    std::size_t maxStreamsPerConnection{0};
+    std::vector<std::unique_ptr<CombinedConnection> > combinedConnections;
+
+    void removeDeadWebsockets() {
+        for (auto it = sessions.begin(); it != sessions.end();) {
+            if (!it->lock()) {
+                it = sessions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * Streams of the same symbol share the io_context, so their handlers never run concurrently
+     * @param streamName e.g. /ws/btcusdt@bookTicker
+     */
+    [[nodiscard]] boost::asio::io_context &contextForStream(const std::string_view streamName) const {
+        const auto stream = combinedStreamName(streamName);
+        const auto symbol = stream.substr(0, stream.find('@'));
+        return *ioContexts[std::hash<std::string_view>{}(symbol) % ioContexts.size()];
+    }
+
+    /**
+     * Combined connections carry streams of many symbols, they are spread over io_contexts evenly
+     */
+    [[nodiscard]] boost::asio::io_context &contextForConnection() const {
+        return *ioContexts[combinedConnections.size() % ioContexts.size()];
+    }
+
+    std::shared_ptr<WebSocketSession> createSession(boost::asio::io_context &ioContext) {
+        removeDeadWebsockets();
+        const auto ws = std::make_shared<WebSocketSession>(ioContext, ctx, logMessageCB);
+        std::weak_ptr wp{ws};
+        sessions.emplace_back(std::move(wp));
+        return ws;
+    }
+
+    /**
+     * @return stream name as used in combined streams, e.g. btcusdt@bookTicker for /ws/btcusdt@bookTicker
+     */
+    static std::string_view combinedStreamName(const std::string_view streamName) {
+        return streamName.starts_with(RAW_STREAM_PREFIX) ? streamName.substr(RAW_STREAM_PREFIX.size()) : streamName;
+    }
+
+    static void sendRequest(CombinedConnection &connection, const std::string &method,
+                            const std::vector<std::string> &streams) {
+        const nlohmann::json request{{"method", method}, {"params", streams}, {"id", ++connection.lastRequestId}};
+        connection.session->send(request.dump());
+    }
+
+    /**
+     * Dispatch frame of the combined stream - {"stream":"<stream>","data":<event>} - to the stream handler
+     */
+    void route(CombinedConnection &connection, const std::string_view frame) const {
+        try {
+            std::string_view stream;
+            std::string_view data;
+            std::string_view error;
+            FrameReader reader(frame);
+
+            reader.readObject([&](const std::string_view key) {
+                if (key == "stream") {
+                    stream = reader.readString();
+                } else if (key == "data") {
+                    data = reader.readRaw();
+                } else if (key == "error") {
+                    error = reader.readRaw();
+                } else {
+                    reader.skipValue();
+                }
+            });
+
+            if (!error.empty() && logMessageCB) {
+                logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, error));
+            }
+
+            /// Responses to SUBSCRIBE/UNSUBSCRIBE requests have no stream
+            if (stream.empty()) {
+                return;
+            }
+
+            /// The handler runs unlocked, it may subscribe or unsubscribe streams of the same connection
+            std::shared_ptr<onRawMessage> handler;
+            {
+                std::lock_guard lk(connection.locker);
+
+                if (const auto it = connection.handlers.find(stream); it != connection.handlers.end()) {
+                    handler = it->second;
+                }
+            }
+
+            if (handler) {
+                (*handler)(data);
+            }
+        } catch (const std::exception &e) {
+            if (logMessageCB) {
+                logMessageCB(LogSeverity::Warning, fmt::format("{}: {}", MAKE_FILELINE, e.what()));
+            }
+        }
+    }
+
+    void reportGap(const std::string_view stream, const std::int64_t disconnectTime,
+                   const std::int64_t reconnectTime) const {
+        if (streamGapCB) {
+            EventStreamGap gap;
+            gap.stream = stream;
+            gap.disconnectTime = disconnectTime;
+            gap.reconnectTime = reconnectTime;
+            streamGapCB(gap);
+        }
+    }
+
+    /**
+     * Subscribe all streams of the combined connection in one SUBSCRIBE request, a new connection is subscribed only
+     * to the stream in its target
+     * @return subscribed streams
+     */
+    static std::vector<std::string> subscribeAll(CombinedConnection &connection) {
+        std::vector<std::string> streams;
+        std::lock_guard lk(connection.locker);
+
+        for (const auto &stream: connection.handlers | std::views::keys) {
+            streams.push_back(stream);
+        }
+
+        connection.pendingStreams.clear();
+
+        if (!streams.empty()) {
+            sendRequest(connection, "SUBSCRIBE", streams);
+        }
+
+        return streams;
+    }
+
+    /**
+     * Restore all streams of the reconnected combined connection in one SUBSCRIBE request
+     */
+    void resubscribe(CombinedConnection &connection, const std::int64_t disconnectTime,
+                     const std::int64_t reconnectTime) const {
+        for (const auto &stream: subscribeAll(connection)) {
+            reportGap(stream, disconnectTime, reconnectTime);
+        }
+    }
+
+    /**
+     * Send one SUBSCRIBE request for all streams added since the previous request
+     */
+    static void flushSubscriptions(CombinedConnection &connection) {
+        std::lock_guard lk(connection.locker);
+
+        if (!connection.pendingStreams.empty()) {
+            sendRequest(connection, "SUBSCRIBE", connection.pendingStreams);
+            connection.pendingStreams.clear();
+        }
+    }
+
+    void subscribeCombined(const std::string &streamName, const onRawMessage &handler) {
+        const std::string stream(combinedStreamName(streamName));
+
+        for (const auto &connection: combinedConnections) {
+            std::lock_guard lk(connection->locker);
+
+            if (connection->handlers.size() >= maxStreamsPerConnection) {
+                continue;
+            }
+
+            connection->handlers.insert_or_assign(stream, std::make_shared<onRawMessage>(handler));
+
+            /// Streams subscribed at once are sent in a single request, Binance limits incoming messages per second
+            if (connection->pendingStreams.empty()) {
+                boost::asio::post(*connection->ioContext, [connection = connection.get()] {
+                    flushSubscriptions(*connection);
+                });
+            }
+
+            connection->pendingStreams.push_back(stream);
+            return;
+        }
+
+        auto connection = std::make_unique<CombinedConnection>();
+        connection->ioContext = &contextForConnection();
+        connection->handlers.emplace(stream, std::make_shared<onRawMessage>(handler));
+        connection->session = createSession(*connection->ioContext);
+        connection->session->setAutoReconnect(
+            [this, connection = connection.get()](const std::int64_t disconnectTime, const std::int64_t reconnectTime) {
+                resubscribe(*connection, disconnectTime, reconnectTime);
+            });
+        /// Streams keep running on the old connection until the replacement is subscribed, no gap is reported
+        connection->session->setRollover([connection = connection.get()] {
+            subscribeAll(*connection);
+        });
+        connection->session->runRaw(host, port, COMBINED_STREAM_TARGET + stream,
+                                    [this, connection = connection.get()](const std::string_view frame) {
+                                        route(*connection, frame);
+                                    });
+        combinedConnections.push_back(std::move(connection));
+    }
+
+    bool unsubscribeCombined(const std::string &streamName) {
+        const auto stream = combinedStreamName(streamName);
+
+        for (const auto &connection: combinedConnections) {
+            std::lock_guard lk(connection->locker);
+
+            if (const auto it = connection->handlers.find(stream); it != connection->handlers.end()) {
+                connection->handlers.erase(it);
+
+                if (const auto itPending = std::ranges::find(connection->pendingStreams, stream);
+                    itPending != connection->pendingStreams.end()) {
+                    connection->pendingStreams.erase(itPending);
+                } else {
+                    sendRequest(*connection, "UNSUBSCRIBE", {std::string(stream)});
+                }
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @return session of a stream with its own connection, reconnected on failure
+     */
+    std::shared_ptr<WebSocketSession> createStreamSession(const std::string &streamName, const bool rollover = true) {
+        const auto session = createSession(contextForStream(streamName));
+        session->setAutoReconnect(
+            [this, stream = std::string(combinedStreamName(streamName))](const std::int64_t disconnectTime,
+                                                                         const std::int64_t reconnectTime) {
+                reportGap(stream, disconnectTime, reconnectTime);
+            });
+
+        if (rollover) {
+            session->setRollover(nullptr);
+        }
+
+        return session;
+    }
+
+    void subscribe(const std::string &streamName, const onRawMessage &handler) {
+        if (maxStreamsPerConnection > 0) {
+            subscribeCombined(streamName, handler);
+        } else {
+            createStreamSession(streamName)->runRaw(host, port, streamName, handler);
+        }
+    }
+
+    void subscribe(const std::string &streamName, const onJSONMessage &cb) {
+        if (maxStreamsPerConnection > 0) {
+            subscribeCombined(streamName, [cb](const std::string_view data) {
+                cb(nlohmann::json::parse(data));
+            });
+        } else {
+            createStreamSession(streamName)->run(host, port, streamName, cb);
+        }
+    }
+
+    /**
+     * Wrap typed event callback into frame callback. One event instance is kept per stream and refilled by every
+     * frame, so the strings inside keep their capacity and parsing does not allocate. Parse errors and exceptions of
+     * the callback are logged, the stream keeps running.
+     */
+    template<typename Event>
+    onRawMessage createEventHandler(const std::string &streamName, const std::function<void(const Event &)> &cb) {
+        return [this, streamName, cb, event = Event{}](const std::string_view msg) mutable {
+            try {
+                parseEvent(msg, event);
+                cb(event);
+            } catch (const std::exception &e) {
+                if (logMessageCB) {
+                    logMessageCB(LogSeverity::Warning, fmt::format("{}: {}: {}", MAKE_FILELINE, streamName, e.what()));
+                }
+            }
+        };
+    }
+
+    /**
+     * Wrap callback of the array elements of all-market streams into frame callback, one event instance is refilled
+     * by every element
+     */
+    template<typename Event>
+    onRawMessage createEventsHandler(const std::string &streamName, const std::function<void(const Event &)> &cb) {
+        return [this, streamName, cb, event = Event{}](const std::string_view msg) mutable {
+            try {
+                parseEvents(msg, event, cb);
+            } catch (const std::exception &e) {
+                if (logMessageCB) {
+                    logMessageCB(LogSeverity::Warning, fmt::format("{}: {}: {}", MAKE_FILELINE, streamName, e.what()));
+                }
+            }
+        };
+    }
+
+    void runContext(const std::size_t index) {
+        auto &ioContext = *ioContexts[index];
+
+        for (;;) {
+            try {
+                isRunning = true;
+
+                if (ioContext.stopped()) {
+                    ioContext.restart();
+                }
+                ioContext.run();
+                break;
+            } catch (std::exception &e) {
+                if (logMessageCB) {
+                    logMessageCB(LogSeverity::Error, fmt::format("{}: {}\n", MAKE_FILELINE, e.what()));
+                }
+            }
+        }
+
+        if (--numRunningThreads == 0) {
+            isRunning = false;
+        }
+    }
+
+    void pinThread(std::thread &thread, const std::size_t index) const {
+#ifdef __linux__
+        if (const auto numCpus = std::thread::hardware_concurrency(); numCpus > 0) {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(index % numCpus, &cpuSet);
+
+            if (const auto ec = pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuSet);
+                ec != 0 && logMessageCB) {
+                logMessageCB(LogSeverity::Warning,
+                             fmt::format("{}: cannot pin IO thread to CPU {}: {}", MAKE_FILELINE, index % numCpus,
+                                         ec));
+            }
+        }
+#else
+        boost::ignore_unused(thread, index);
+#endif
+    }
+
+    P(const std::size_t numThreads, const bool pinThreads) : ctx(boost::asio::ssl::context::sslv23_client),
+                                                             pinThreads(pinThreads) {
+        for (std::size_t i = 0; i < std::max<std::size_t>(numThreads, 1); i++) {
+            ioContexts.push_back(std::make_unique<boost::asio::io_context>(1));
+            workGuards.push_back(boost::asio::make_work_guard(*ioContexts.back()));
+        }
+    }
+};
+
+WebSocketClient::WebSocketClient() : WebSocketClient(1) {
+}
+
+WebSocketClient::WebSocketClient(const std::size_t numThreads, const bool pinThreads) : m_p(
+    std::make_unique<P>(numThreads, pinThreads)) {
+}
+
+WebSocketClient::~WebSocketClient() {
+    for (auto &workGuard: m_p->workGuards) {
+        workGuard.reset();
+    }
+
+    for (const auto &ioContext: m_p->ioContexts) {
+        ioContext->stop();
+    }
+
+    for (auto &ioThread: m_p->ioThreads) {
+        if (ioThread.joinable()) {
+            ioThread.join();
+        }
+    }
+}
+
+std::string WebSocketClient::composeStreamName(const std::string &pair, const std::string &channel) {
+    std::string res{"/ws/"};
+    if (!pair.empty()) {
+        res += pair;
+        if (pair != "!") {
+            boost::algorithm::to_lower(res);
+        }
+
+        res += '@';
+    }
+
+    res += channel;
+
+    return res;
+}
+
+void WebSocketClient::run() const {
+    if (m_p->isRunning) {
+        return;
+    }
+
+    m_p->isRunning = true;
+
+    for (auto &ioThread: m_p->ioThreads) {
+        if (ioThread.joinable()) {
+            ioThread.join();
+        }
+    }
+
+    m_p->ioThreads.clear();
+    m_p->numRunningThreads = m_p->ioContexts.size();
+
+    for (std::size_t i = 0; i < m_p->ioContexts.size(); i++) {
+        auto &ioThread = m_p->ioThreads.emplace_back([p = m_p.get(), i] {
+            p->runContext(i);
+        });
+
+        if (m_p->pinThreads) {
+            m_p->pinThread(ioThread, i);
+        }
+    }
+}
+
+void WebSocketClient::setLoggerCallback(const onLogMessage &onLogMessageCB) const {
+    m_p->logMessageCB = onLogMessageCB;
+}
+
+void WebSocketClient::setCombinedStreams(const std::size_t maxStreamsPerConnection) const {
+    m_p->maxStreamsPerConnection = maxStreamsPerConnection;
+}
+
+void WebSocketClient::setStreamGapCallback(const onStreamGap &onStreamGapCB) const {
+    m_p->streamGapCB = onStreamGapCB;
+}
+
+bool WebSocketClient::findStream(const std::string &streamName) const {
+    const auto stream = P::combinedStreamName(streamName);
+
+    for (const auto &connection: m_p->combinedConnections) {
+        std::lock_guard lk(connection->locker);
+
+        if (connection->handlers.contains(stream)) {
+            return true;
+        }
+    }
+
+    for (auto &m_session: m_p->sessions) {
+        if (const auto session = m_session.lock()) {
+            if (session->target() == streamName) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void WebSocketClient::unsubscribe(const std::string &streamName) const {
+    if (m_p->unsubscribeCombined(streamName)) {
+        return;
+    }
+
+    for (auto &m_session: m_p->sessions) {
+        if (const auto session = m_session.lock(); session && session->target() == streamName) {
+            session->close();
+        }
+    }
+}
+
+void WebSocketClient::bookTicker(const std::string &pair, const onJSONMessage &cb) const {
+    const std::string streamName = composeStreamName(pair, "bookTicker");
+    m_p->subscribe(streamName, cb);
+}
+
+void WebSocketClient::bookTicker(const std::string &pair, const onBookTicker &cb) const {
+    const std::string streamName = composeStreamName(pair, "bookTicker");
+    m_p->subscribe(streamName, m_p->createEventHandler(streamName, cb));
+}
+
+void WebSocketClient::candlestick(const std::string &pair, const CandleInterval interval,
+                                  const onJSONMessage &cb) const {
+    std::string channel("kline");
+    channel.append(magic_enum::enum_name(interval));
+    const std::string streamName = composeStreamName(pair, channel);
+    m_p->subscribe(streamName, cb);
+}
+
+void WebSocketClient::candlestick(const std::string &pair, const CandleInterval interval,
+                                  const onCandlestick &cb) const {
+    std::string channel("kline");
+    channel.append(magic_enum::enum_name(interval));
+    const std::string streamName = composeStreamName(pair, channel);
+    m_p->subscribe(streamName, m_p->createEventHandler(streamName, cb));
+}
+
+void WebSocketClient::aggTrade(const std::string &pair, const onJSONMessage &cb) const {
+    const std::string streamName = composeStreamName(pair, "aggTrade");
+    m_p->subscribe(streamName, cb);
+}
+
+void WebSocketClient::aggTrade(const std::string &pair, const onAggregatedTrade &cb) const {
+    const std::string streamName = composeStreamName(pair, "aggTrade");
+    m_p->subscribe(streamName, m_p->createEventHandler(streamName, cb));
+}
+
+void WebSocketClient::aggTrade(const std::string &pair, const onPodAggregatedTrade &cb) const {
+    const std::string streamName = composeStreamName(pair, "aggTrade");
+    m_p->subscribe(streamName, m_p->createEventHandler(streamName, cb));
+}
+
+void WebSocketClient::partialBookDepthStream(const std::string &pair, int depth, const onJSONMessage &cb) const {
+    if (depth != 5 && depth != 10 && depth != 20) {
+        throw std::invalid_argument(fmt::format("invalid depth parameter, must be 5, 10 or 20, is {}", depth));
+    }
+
+    std::string channel("depth");
+    channel.append(std::to_string(depth));
+    const std::string streamName = composeStreamName(pair, channel);
+    m_p->subscribe(streamName, cb);
+}
+
+void WebSocketClient::partialBookDepthStream(const std::string &pair, const int depth, const onDepth &cb) const {
+    if (depth != 5 && depth != 10 && depth != 20) {
+        throw std::invalid_argument(fmt::format("invalid depth parameter, must be 5, 10 or 20, is {}", depth));
+    }
+
+    std::string channel("depth");
+    channel.append(std::to_string(depth));
+    const std::string streamName = composeStreamName(pair, channel);
+    m_p->subscribe(streamName, m_p->createEventHandler(streamName, cb));
+}
+
+void WebSocketClient::diffBookDepthStream(const std::string &pair, const onDepthUpdate &cb) const {
+    const std::string streamName = composeStreamName(pair, "depth@100ms");
+    m_p->subscribe(streamName, m_p->createEventHandler(streamName, cb));
+}
+
+void WebSocketClient::allBookTickers(const onBookTicker &cb) const {
+    const std::string streamName = composeStreamName("", ALL_BOOK_TICKERS_STREAM);
+    m_p->subscribe(streamName, m_p->createEventHandler(streamName, cb));
+}
+
+void WebSocketClient::allMarkPrices(const onMarkPrice &cb) const {
+    const std::string streamName = composeStreamName("", ALL_MARK_PRICES_STREAM);
+    m_p->subscribe(streamName, m_p->createEventsHandler(streamName, cb));
+}
+
+void WebSocketClient::allMiniTickers(const onMiniTicker &cb) const {
+    const std::string streamName = composeStreamName("", ALL_MINI_TICKERS_STREAM);
+    m_p->subscribe(streamName, m_p->createEventsHandler(streamName, cb));
+}
+
+void WebSocketClient::userDataStream(const std::string &listenKey, const onUserData &cb) const {
+    const std::string streamName = composeStreamName("", listenKey);
+
+    /// Events of one transaction share the event time, rollover deduplication would drop them
+    m_p->createStreamSession(streamName, false)->run(m_p->host, m_p->port, streamName,
+                                                     [p = m_p.get(), cb](const nlohmann::json &json) {
+                                                         try {
+                                                             EventUserData event;
+                                                             event.fromJson(json);
+                                                             cb(event);
+                                                         } catch (const std::exception &e) {
+                                                             if (p->logMessageCB) {
+                                                                 p->logMessageCB(LogSeverity::Warning,
+                                                                                 fmt::format("{}: {}", MAKE_FILELINE,
+                                                                                             e.what()));
+                                                             }
+                                                         }
+                                                     });
+}
+}
@@ -7,8 +7,10 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 */
 
 #include "stonky/binance/binance_futures_ws_session.h"
+#include "stonky/binance/binance_frame_reader.h"
 #include "stonky/utils/log_utils.h"
 #include "stonky/utils/json_utils.h"
+#include "stonky/utils/utils.h"
 #include <nlohmann/json.hpp>
 #include <boost/asio/buffers_iterator.hpp>
 #include <boost/asio/strand.hpp>
@@ -16,25 +18,86 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 #include <boost/beast/core.hpp>
 #include <boost/beast/ssl.hpp>
 #include <boost/beast/websocket.hpp>
+#include <atomic>
+#include <charconv>
+#include <deque>
+#include <map>
+#include <optional>
+#include <random>
+#include <utility>
 
 namespace stonky::binance::futures {
 static constexpr int PING_INTERVAL_IN_S = 10;
+static constexpr std::int64_t RECONNECT_MIN_DELAY_MS = 250;
+static constexpr std::int64_t RECONNECT_MAX_DELAY_MS = 30000;
+static constexpr int ROLLOVER_OVERLAP_IN_S = 10; /// both connections are read for this time after the replacement is established
+static constexpr int ROLLOVER_RETRY_IN_S = 60;
 
 struct WebSocketSession::P {
+    using Stream = boost::beast::websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream>>;
+
+    /**
+     * One TCP+TLS connection, replaced on reconnect and rollover. Handlers of pending operations keep it alive.
+     */
+    struct Connection {
+        Stream ws;
+        boost::beast::flat_buffer buffer;
+        /// Rollover replacement, becomes the active connection after its handshake
+        bool isReplacement{false};
+
+        Connection(const boost::asio::strand<boost::asio::io_context::executor_type> &strand, boost::asio::ssl::context &ctx) : ws(strand, ctx) {}
+    };
+
+    /// (event time, update id) of the last event of a stream and symbol, events are delivered in this order
+    /// during rollover
+    using EventKey = std::pair<std::int64_t, std::int64_t>;
+
+    /// All handlers of the session run on the strand
+    boost::asio::strand<boost::asio::io_context::executor_type> strand;
+    boost::asio::ssl::context &ctx;
     boost::asio::ip::tcp::resolver resolver;
-    boost::beast::websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream>> ws;
-    boost::beast::multi_buffer buffer;
+    /// Connection frames are written to, nullptr before the first connect
+    std::shared_ptr<Connection> connection;
+    /// Connection replaced by the rollover, read until the overlap ends
+    std::shared_ptr<Connection> retiringConnection;
     std::string host;
+    std::string port;
     std::string target;
     std::string streamName;
     onLogMessage logMessageCB;
     std::function<void(const nlohmann::json &msg)> onJsonMsg;
+    onRawMessage onRawMsg;
     boost::asio::steady_timer pingTimer;
     std::chrono::time_point<std::chrono::system_clock> lastPingTime{};
     std::chrono::time_point<std::chrono::system_clock> lastPongTime{};
+    struct OutgoingFrame {
+        std::string message;
+        /// Frame is dropped if it is set before the frame is written, may be null
+        std::shared_ptr<const std::atomic<bool> > cancelled;
+    };
+
+    /// Outgoing frames, accessed on the strand only
+    std::deque<OutgoingFrame> writeQueue;
+    bool isOpen{false};
+    bool isWriting{false};
+    bool autoReconnect{false};
+    bool isClosing{false};
+    onReconnected onReconnectedCB;
+    boost::asio::steady_timer reconnectTimer;
+    int reconnectAttempt{0};
+    /// Time of the first failure of the outage in ms, -1 when connected
+    std::int64_t disconnectTime{-1};
+    std::mt19937 random{std::random_device{}()};
+    /// Time of the handshake of the active connection in ms, -1 when not connected
+    std::atomic<std::int64_t> connectTime{-1};
+    std::optional<std::chrono::seconds> rolloverAge;
+    onRolledOver onRolledOverCB;
+    boost::asio::steady_timer rolloverTimer;
+    bool deduplicate{false};
+    std::map<std::string, EventKey, std::less<> > lastEventKeys;
 
     P(boost::asio::io_context &ioc, boost::asio::ssl::context &ctx, const onLogMessage &onLogMessageCB) :
-        resolver(make_strand(ioc)), ws(make_strand(ioc), ctx), logMessageCB(onLogMessageCB), pingTimer(ioc, boost::asio::chrono::seconds(PING_INTERVAL_IN_S)) {}
+        strand(make_strand(ioc)), ctx(ctx), resolver(strand), logMessageCB(onLogMessageCB), pingTimer(strand, boost::asio::chrono::seconds(PING_INTERVAL_IN_S)), reconnectTimer(strand), rolloverTimer(strand) {}
 
     static std::pair<int, std::string> constructError(const nlohmann::json &json) {
         int ec;
@@ -46,40 +109,239 @@ struct WebSocketSession::P {
 
     static bool isApiError(const nlohmann::json &json) { return json.contains("code") && json.contains("msg"); }
 
-    void onResolve(const std::shared_ptr<WebSocketSession> &self, const boost::beast::error_code &ec, const boost::asio::ip::tcp::resolver::results_type &results) {
+    /**
+     * Counterpart of isApiError() and constructError() for raw frames, the frame is scanned only if it contains "msg"
+     * @return true if the frame is an object with both code and msg fields
+     */
+    static bool readApiError(const std::string_view frame, std::int64_t &code, std::string_view &msg) {
+        if (frame.empty() || frame.front() != '{' || frame.find(R"("msg")") == std::string_view::npos) {
+            return false;
+        }
+
+        bool hasCode = false;
+        bool hasMsg = false;
+
+        try {
+            FrameReader reader(frame);
+
+            reader.readObject([&](const std::string_view field) {
+                if (field == "code") {
+                    reader.read(code);
+                    hasCode = true;
+                } else if (field == "msg") {
+                    msg = reader.readString();
+                    hasMsg = true;
+                } else {
+                    reader.skipValue();
+                }
+            });
+        } catch (const JsonParseError &) {
+            /// Not an error response, the handler reports malformed frames
+            return false;
+        }
+
+        return hasCode && hasMsg;
+    }
+
+    /**
+     * Read stream name, symbol and key of the event, the event is in "data" of combined stream frames. Array payloads
+     * of all-market streams, e.g. !markPrice@arr, are keyed by their first event and have no symbol.
+     * @param value frame, or "data" of the combined stream frame
+     * @return false if the frame carries no event, e.g. response to a request
+     */
+    static bool readEventKey(const std::string_view value, std::string_view &stream, std::string_view &symbol,
+                             EventKey &key) {
+        bool retVal = false;
+        FrameReader reader(value);
+
+        if (!value.empty() && value.front() == '[') {
+            bool isFirst = true;
+
+            reader.readArray([&] {
+                if (!isFirst) {
+                    return reader.skipValue();
+                }
+
+                isFirst = false;
+                retVal = readEventKey(reader.readRaw(), stream, symbol, key);
+            });
+
+            symbol = {};
+            return retVal;
+        }
+
+        reader.readObject([&](const std::string_view field) {
+            if (field == "stream") {
+                stream = reader.readString();
+            } else if (field == "data") {
+                retVal = readEventKey(reader.readRaw(), stream, symbol, key);
+            } else if (field == "E") {
+                reader.read(key.first);
+                retVal = true;
+            } else if (field == "u") {
+                reader.read(key.second);
+            } else if (field == "s") {
+                symbol = reader.readString();
+            } else if (field == "a") {
+                /// Aggregate trade id is a number, "a" of other events is a quoted price
+                if (const auto value = reader.readRaw(); !value.empty() && value.front() != '"') {
+                    std::from_chars(value.data(), value.data() + value.size(), key.second);
+                }
+            } else {
+                reader.skipValue();
+            }
+        });
+
+        return retVal;
+    }
+
+    /**
+     * During rollover both connections deliver the same events, only events newer than the last delivered one of the
+     * stream and symbol pass
+     */
+    bool isDuplicate(const std::string_view frame) {
+        std::string_view stream;
+        std::string_view symbol;
+        EventKey key{};
+
+        try {
+            if (!readEventKey(frame, stream, symbol, key)) {
+                return false;
+            }
+        } catch (const JsonParseError &) {
+            return false;
+        }
+
+        /// Update ids of all-market streams, e.g. !bookTicker, increase per symbol only
+        std::string streamKey(stream);
+        streamKey.append("|").append(symbol);
+        const auto it = lastEventKeys.find(streamKey);
+
+        if (it == lastEventKeys.end()) {
+            lastEventKeys.emplace(std::move(streamKey), key);
+            return false;
+        }
+
+        if (key <= it->second) {
+            return true;
+        }
+
+        it->second = key;
+        return false;
+    }
+
+    void connect(const std::shared_ptr<WebSocketSession> &self, const std::shared_ptr<Connection> &conn) {
+        resolver.async_resolve(
+                host, port, [this, self, conn](const boost::beast::error_code &ec, const boost::asio::ip::tcp::resolver::results_type &results) { onResolve(self, conn, ec, results); });
+    }
+
+    void connect(const std::shared_ptr<WebSocketSession> &self) {
+        connection = std::make_shared<Connection>(strand, ctx);
+        connect(self, connection);
+    }
+
+    /**
+     * Drop the connection whose handshake has not completed. The active connection is reconnected, failed rollover
+     * replacement is retried later while the active connection keeps running.
+     */
+    void onConnectFailed(const std::shared_ptr<WebSocketSession> &self, const std::shared_ptr<Connection> &conn) {
+        if (conn->isReplacement) {
+            deduplicate = false;
+            lastEventKeys.clear();
+            return scheduleRollover(self, std::chrono::seconds(ROLLOVER_RETRY_IN_S));
+        }
+
+        scheduleReconnect(self);
+    }
+
+    /**
+     * Schedule a new connection after exponential backoff with jitter, so sessions dropped together do not reconnect
+     * all at once
+     */
+    void scheduleReconnect(const std::shared_ptr<WebSocketSession> &self) {
+        isOpen = false;
+        connectTime = -1;
+        rolloverTimer.cancel();
+        deduplicate = false;
+        lastEventKeys.clear();
+
+        if (retiringConnection) {
+            boost::beast::error_code ec;
+            get_lowest_layer(retiringConnection->ws).socket().close(ec);
+            retiringConnection.reset();
+        }
+
+        if (!autoReconnect || isClosing) {
+            return;
+        }
+
+        if (disconnectTime < 0) {
+            disconnectTime = getMsTimestamp(currentTime()).count();
+        }
+
+        const auto maxDelay = std::min(RECONNECT_MAX_DELAY_MS, RECONNECT_MIN_DELAY_MS << std::min(reconnectAttempt, 16));
+        const auto delay = std::uniform_int_distribution<std::int64_t>(maxDelay / 2, maxDelay)(random);
+        reconnectAttempt++;
+
+        logMessageCB(LogSeverity::Warning, fmt::format("{}: {}: reconnecting in {} ms", MAKE_FILELINE, target, delay));
+
+        reconnectTimer.expires_after(std::chrono::milliseconds(delay));
+        reconnectTimer.async_wait([this, self](const boost::beast::error_code &e) {
+            if (!e && !isClosing) {
+                connect(self);
+            }
+        });
+    }
+
+    void scheduleRollover(const std::shared_ptr<WebSocketSession> &self, const std::chrono::seconds delay) {
+        rolloverTimer.expires_after(delay);
+        rolloverTimer.async_wait([this, self](const boost::beast::error_code &e) {
+            if (!e && !isClosing && isOpen && !retiringConnection) {
+                logMessageCB(LogSeverity::Info, fmt::format("{}: {}: connection rollover", MAKE_FILELINE, target));
+                deduplicate = true;
+                auto replacement = std::make_shared<Connection>(strand, ctx);
+                replacement->isReplacement = true;
+                connect(self, replacement);
+            }
+        });
+    }
+
+    void onResolve(const std::shared_ptr<WebSocketSession> &self, const std::shared_ptr<Connection> &conn, const boost::beast::error_code &ec, const boost::asio::ip::tcp::resolver::results_type &results) {
         if (ec) {
-            return logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            return onConnectFailed(self, conn);
         }
 
-        get_lowest_layer(ws).expires_after(std::chrono::seconds(30));
+        get_lowest_layer(conn->ws).expires_after(std::chrono::seconds(30));
 
-        get_lowest_layer(ws).async_connect(
-                results, [this, self](const boost::beast::error_code &e, const boost::asio::ip::tcp::resolver::results_type::endpoint_type &ep) { onConnect(self, e, ep); });
+        get_lowest_layer(conn->ws).async_connect(
+                results, [this, self, conn](const boost::beast::error_code &e, const boost::asio::ip::tcp::resolver::results_type::endpoint_type &ep) { onConnect(self, conn, e, ep); });
     }
 
-    void onConnect(const std::shared_ptr<WebSocketSession> &self, boost::beast::error_code ec, const boost::asio::ip::tcp::resolver::results_type::endpoint_type &ep) {
+    void onConnect(const std::shared_ptr<WebSocketSession> &self, const std::shared_ptr<Connection> &conn, boost::beast::error_code ec, const boost::asio::ip::tcp::resolver::results_type::endpoint_type &ep) {
         if (ec) {
-            return logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            return onConnectFailed(self, conn);
         }
 
-        get_lowest_layer(ws).expires_after(std::chrono::seconds(30));
+        get_lowest_layer(conn->ws).expires_after(std::chrono::seconds(30));
 
-        if (!SSL_set_tlsext_host_name(ws.next_layer().native_handle(), host.c_str())) {
+        if (!SSL_set_tlsext_host_name(conn->ws.next_layer().native_handle(), host.c_str())) {
             ec = boost::beast::error_code(static_cast<int>(ERR_get_error()), boost::asio::error::get_ssl_category());
-            return logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            return onConnectFailed(self, conn);
         }
 
-        host += ':' + std::to_string(ep.port());
-
-        ws.next_layer().async_handshake(boost::asio::ssl::stream_base::client, [this, self](const boost::beast::error_code &e) { onSSLHandshake(self, e); });
+        conn->ws.next_layer().async_handshake(boost::asio::ssl::stream_base::client, [this, self, conn, handshakeHost = host + ':' + std::to_string(ep.port())](const boost::beast::error_code &e) { onSSLHandshake(self, conn, handshakeHost, e); });
     }
 
-    void onSSLHandshake(const std::shared_ptr<WebSocketSession> &self, const boost::beast::error_code &ec) {
+    void onSSLHandshake(const std::shared_ptr<WebSocketSession> &self, const std::shared_ptr<Connection> &conn, const std::string &handshakeHost, const boost::beast::error_code &ec) {
         if (ec) {
-            return logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            return onConnectFailed(self, conn);
         }
 
-        ws.control_callback([this](boost::beast::websocket::frame_type kind, boost::beast::string_view payload) {
+        conn->ws.control_callback([this](boost::beast::websocket::frame_type kind, boost::beast::string_view payload) {
             boost::ignore_unused(kind, payload);
 
             if (kind == boost::beast::websocket::frame_type::pong) {
@@ -87,45 +349,161 @@ struct WebSocketSession::P {
             }
         });
 
-        get_lowest_layer(ws).expires_never();
+        get_lowest_layer(conn->ws).expires_never();
 
-        ws.set_option(boost::beast::websocket::stream_base::timeout::suggested(boost::beast::role_type::client));
+        conn->ws.set_option(boost::beast::websocket::stream_base::timeout::suggested(boost::beast::role_type::client));
 
-        ws.set_option(boost::beast::websocket::stream_base::decorator(
+        conn->ws.set_option(boost::beast::websocket::stream_base::decorator(
                 [](boost::beast::websocket::request_type &req) { req.set(boost::beast::http::field::user_agent, std::string(BOOST_BEAST_VERSION_STRING) + " binance-client"); }));
 
-        ws.async_handshake(host, target, [this, self](const boost::beast::error_code &e) { onHandshake(self, e); });
+        conn->ws.async_handshake(handshakeHost, target, [this, self, conn](const boost::beast::error_code &e) { onHandshake(self, conn, e); });
     }
 
-    void onHandshake(const std::shared_ptr<WebSocketSession> &self, const boost::beast::error_code &ec) {
+    void onHandshake(const std::shared_ptr<WebSocketSession> &self, const std::shared_ptr<Connection> &conn, const boost::beast::error_code &ec) {
         if (ec) {
-            return logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            return onConnectFailed(self, conn);
         }
 
-        ws.async_read(buffer, [this, self](const boost::beast::error_code &e, const std::size_t bytesTransferred) { onRead(self, e, bytesTransferred); });
-        pingTimer.async_wait([this, self](const boost::beast::error_code &e) { onPingTimer(self, e); });
+        conn->ws.async_read(conn->buffer, [this, self, conn](const boost::beast::error_code &e, const std::size_t bytesTransferred) { onRead(self, conn, e, bytesTransferred); });
+        connectTime = getMsTimestamp(currentTime()).count();
+
+        if (conn->isReplacement) {
+            /// Writes go to the replacement from now on, the old connection is read until the overlap ends
+            conn->isReplacement = false;
+            retiringConnection = std::exchange(connection, conn);
+
+            rolloverTimer.expires_after(std::chrono::seconds(ROLLOVER_OVERLAP_IN_S));
+            rolloverTimer.async_wait([this, self](const boost::beast::error_code &e) { onOverlapEnd(self, e); });
+
+            if (onRolledOverCB) {
+                onRolledOverCB();
+            }
+        } else {
+            if (rolloverAge) {
+                scheduleRollover(self, *rolloverAge);
+            }
+
+            pingTimer.expires_after(boost::asio::chrono::seconds(PING_INTERVAL_IN_S));
+            pingTimer.async_wait([this, self](const boost::beast::error_code &e) { onPingTimer(self, e); });
+
+            isOpen = true;
+            reconnectAttempt = 0;
+            lastPingTime = lastPongTime = std::chrono::system_clock::now();
+
+            /// Called before the first frame of the new connection is read, so requests sent from the callback go first
+            if (disconnectTime >= 0) {
+                const auto outageStart = disconnectTime;
+                disconnectTime = -1;
+
+                if (onReconnectedCB) {
+                    onReconnectedCB(outageStart, connectTime);
+                }
+            }
+        }
+
+        if (!writeQueue.empty() && !isWriting) {
+            write(self);
+        }
     }
 
-    void onRead(const std::shared_ptr<WebSocketSession> &self, const boost::beast::error_code &ec, std::size_t bytesTransferred) {
-        boost::ignore_unused(bytesTransferred);
+    /**
+     * Close the retired connection and schedule the next rollover
+     */
+    void onOverlapEnd(const std::shared_ptr<WebSocketSession> &self, const boost::beast::error_code &ec) {
+        if (ec) {
+            return;
+        }
+
+        deduplicate = false;
+        lastEventKeys.clear();
+
+        if (const auto retired = std::move(retiringConnection)) {
+            retired->ws.async_close(boost::beast::websocket::close_code::normal, [this, retired](const boost::beast::error_code &e) {
+                if (e) {
+                    logMessageCB(LogSeverity::Warning, fmt::format("{}: {}", MAKE_FILELINE, e.message()));
+                }
+            });
+        }
+
+        scheduleRollover(self, *rolloverAge - std::chrono::seconds(ROLLOVER_OVERLAP_IN_S));
+    }
+
+    void send(const std::shared_ptr<WebSocketSession> &self, std::string message,
+              std::shared_ptr<const std::atomic<bool> > cancelled) {
+        boost::asio::post(strand, [this, self, message = std::move(message), cancelled = std::move(cancelled)]() mutable {
+            writeQueue.push_back({std::move(message), std::move(cancelled)});
+
+            /// Only one write may be in progress, the next one is started from onWrite
+            if (isOpen && !isWriting) {
+                write(self);
+            }
+        });
+    }
+
+    void write(const std::shared_ptr<WebSocketSession> &self) {
+        while (!writeQueue.empty() && writeQueue.front().cancelled && *writeQueue.front().cancelled) {
+            writeQueue.pop_front();
+        }
+
+        if (writeQueue.empty()) {
+            return;
+        }
+
+        isWriting = true;
+        const auto conn = connection;
+        conn->ws.text(true);
+        conn->ws.async_write(boost::asio::buffer(writeQueue.front().message), [this, self, conn](const boost::beast::error_code &e, const std::size_t) { onWrite(self, e); });
+    }
+
+    void onWrite(const std::shared_ptr<WebSocketSession> &self, const boost::beast::error_code &ec) {
+        isWriting = false;
 
         if (ec) {
-            pingTimer.cancel();
+            writeQueue.clear();
             return logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
         }
 
-        try {
-            const auto size = buffer.size();
-            std::string strBuffer;
-            strBuffer.reserve(size);
+        writeQueue.pop_front();
+
+        if (!writeQueue.empty() && isOpen) {
+            write(self);
+        }
+    }
 
-            for (const auto &it: buffer.data()) {
-                strBuffer.append(static_cast<const char *>(it.data()), it.size());
+    void onRead(const std::shared_ptr<WebSocketSession> &self, const std::shared_ptr<Connection> &conn, const boost::beast::error_code &ec, std::size_t bytesTransferred) {
+        boost::ignore_unused(bytesTransferred);
+
+        if (ec) {
+            /// Retired or abandoned connection
+            if (conn != connection) {
+                return;
             }
 
-            buffer.consume(buffer.size());
+            pingTimer.cancel();
+            logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            return scheduleReconnect(self);
+        }
 
-            if (const nlohmann::json json = nlohmann::json::parse(strBuffer); json.is_object()) {
+        try {
+            /// flat_buffer keeps the frame contiguous and reuses its storage for the next frames
+            const auto data = conn->buffer.cdata();
+            const std::string_view frame(static_cast<const char *>(data.data()), data.size());
+
+            if (conn != connection && conn != retiringConnection) {
+                // connection is being closed after the overlap, its frames were already delivered
+            } else if (deduplicate && isDuplicate(frame)) {
+                // skip the frame
+            } else if (onRawMsg) {
+                std::int64_t errorCode{};
+                std::string_view errorMsg;
+
+                if (readApiError(frame, errorCode, errorMsg)) {
+                    logMessageCB(LogSeverity::Error, fmt::format("Binance API Error {}: {}", errorCode, errorMsg));
+                } else {
+                    onRawMsg(frame);
+                }
+            } else if (const nlohmann::json json = nlohmann::json::parse(frame); json.is_object()) {
                 if (isApiError(json)) {
                     auto [fst, snd] = constructError(json);
                     auto errorCode = fst;
@@ -136,21 +514,41 @@ struct WebSocketSession::P {
                 }
             }
 
-            ws.async_read(buffer, [this, self](const boost::beast::error_code &e, const std::size_t transferred) { onRead(self, e, transferred); });
+            conn->buffer.consume(conn->buffer.size());
+
+            conn->ws.async_read(conn->buffer, [this, self, conn](const boost::beast::error_code &e, const std::size_t transferred) { onRead(self, conn, e, transferred); });
         } catch (nlohmann::json::exception &exc) {
+            conn->buffer.consume(conn->buffer.size());
+            logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, exc.what()));
+            conn->ws.async_close(boost::beast::websocket::close_code::normal, [this, self, conn](const boost::beast::error_code &e) { onClose(conn == connection ? self : nullptr, e); });
+        } catch (std::exception &exc) {
+            /// Thrown by the message callback, the frame is dropped and the connection is read further
+            conn->buffer.consume(conn->buffer.size());
             logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, exc.what()));
-            ws.async_close(boost::beast::websocket::close_code::normal, [this](const boost::beast::error_code &e) { onClose(e); });
+            conn->ws.async_read(conn->buffer, [this, self, conn](const boost::beast::error_code &e, const std::size_t transferred) { onRead(self, conn, e, transferred); });
         }
     }
 
-    void ping() {
+    /**
+     * Half-open connection is not detected by the read, its socket is closed when the pong is overdue. The pending
+     * read then fails and the session is reconnected.
+     * @return false if the connection was closed
+     */
+    bool ping() {
         if (const std::chrono::duration<double> elapsed = lastPingTime - lastPongTime; elapsed.count() > PING_INTERVAL_IN_S) {
-            logMessageCB(LogSeverity::Warning, fmt::format("{}: {}", MAKE_FILELINE, "ping expired"));
+            logMessageCB(LogSeverity::Warning, fmt::format("{}: {}: {}", MAKE_FILELINE, target, "ping expired, closing connection"));
+
+            if (const auto conn = connection) {
+                boost::beast::error_code ec;
+                get_lowest_layer(conn->ws).socket().close(ec);
+            }
+
+            return false;
         }
 
-        if (ws.is_open()) {
+        if (const auto conn = connection; conn && conn->ws.is_open()) {
             const boost::beast::websocket::ping_data pingWebSocketFrame;
-            ws.async_ping(pingWebSocketFrame, [this](const boost::beast::error_code &ec) {
+            conn->ws.async_ping(pingWebSocketFrame, [this, conn](const boost::beast::error_code &ec) {
                 if (ec) {
                     logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
                 } else {
@@ -158,17 +556,36 @@ struct WebSocketSession::P {
                 }
             });
         }
+
+        return true;
     }
 
-    void closeWs() {
-        ws.async_close(boost::beast::websocket::close_code::normal, [this](const boost::beast::error_code &ec) { onClose(ec); });
+    void closeWs(const std::shared_ptr<const WebSocketSession> &self) {
+        boost::asio::post(strand, [this, self] {
+            isClosing = true;
+            reconnectTimer.cancel();
+            rolloverTimer.cancel();
+
+            for (const auto &conn: {connection, retiringConnection}) {
+                if (conn && conn->ws.is_open()) {
+                    conn->ws.async_close(boost::beast::websocket::close_code::normal, [this, self, conn](const boost::beast::error_code &ec) { onClose(nullptr, ec); });
+                }
+            }
+        });
     }
 
-    void onClose(const boost::beast::error_code &ec) {
+    /**
+     * @param self session to reconnect, nullptr when the session is closed on purpose
+     */
+    void onClose(const std::shared_ptr<WebSocketSession> &self, const boost::beast::error_code &ec) {
         pingTimer.cancel();
 
         if (ec) {
-            return logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+            logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
+        }
+
+        if (self) {
+            scheduleReconnect(self);
         }
     }
 
@@ -177,7 +594,10 @@ struct WebSocketSession::P {
             return logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, ec.message()));
         }
 
-        ping();
+        if (!ping()) {
+            return;
+        }
+
         pingTimer.expires_after(boost::asio::chrono::seconds(PING_INTERVAL_IN_S));
         pingTimer.async_wait([this, self](const boost::beast::error_code &e) { onPingTimer(self, e); });
     }
@@ -186,19 +606,47 @@ struct WebSocketSession::P {
 WebSocketSession::WebSocketSession(boost::asio::io_context &ioc, boost::asio::ssl::context &ctx, const onLogMessage &onLogMessageCB) :
     m_p(std::make_unique<P>(ioc, ctx, onLogMessageCB)) {}
 
-WebSocketSession::~WebSocketSession() { m_p->pingTimer.cancel(); }
+WebSocketSession::~WebSocketSession() {
+    m_p->pingTimer.cancel();
+    m_p->reconnectTimer.cancel();
+    m_p->rolloverTimer.cancel();
+}
 
 std::string WebSocketSession::target() const { return m_p->target; }
 
+std::chrono::milliseconds WebSocketSession::connectionAge() const {
+    const std::int64_t connectTime = m_p->connectTime;
+    return std::chrono::milliseconds(connectTime < 0 ? 0 : getMsTimestamp(currentTime()).count() - connectTime);
+}
+
+void WebSocketSession::setAutoReconnect(const onReconnected &onReconnectedCB) {
+    m_p->autoReconnect = true;
+    m_p->onReconnectedCB = onReconnectedCB;
+}
+
+void WebSocketSession::setRollover(const onRolledOver &onRolledOverCB, const std::chrono::seconds age) {
+    m_p->rolloverAge = age;
+    m_p->onRolledOverCB = onRolledOverCB;
+}
+
 void WebSocketSession::run(const std::string &host, const std::string &port, const std::string &target, const onJSONMessage &onJsonMsg) {
     m_p->host = host;
+    m_p->port = port;
     m_p->target = target;
     m_p->onJsonMsg = onJsonMsg;
+    m_p->connect(shared_from_this());
+}
+
+void WebSocketSession::runRaw(const std::string &host, const std::string &port, const std::string &target, const onRawMessage &onRawMsg) {
+    m_p->onRawMsg = onRawMsg;
+    run(host, port, target, nullptr);
+}
+
+void WebSocketSession::send(std::string message) { m_p->send(shared_from_this(), std::move(message), nullptr); }
 
-    auto self = shared_from_this();
-    m_p->resolver.async_resolve(
-            host, port, [this, self](const boost::beast::error_code &ec, const boost::asio::ip::tcp::resolver::results_type &results) { m_p->onResolve(self, ec, results); });
+void WebSocketSession::send(std::string message, std::shared_ptr<const std::atomic<bool> > cancelled) {
+    m_p->send(shared_from_this(), std::move(message), std::move(cancelled));
 }
 
-void WebSocketSession::close() const { m_p->closeWs(); }
+void WebSocketSession::close() const { m_p->closeWs(shared_from_this()); }
 } // namespace stonky::binance::futures
@@ -0,0 +1,339 @@
+/**
+Binance Futures WebSocket Trading API Client
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_futures_ws_trading_client.h"
+#include "stonky/binance/binance_futures_ws_session.h"
+#include "stonky/utils/json_utils.h"
+#include "stonky/utils/utils.h"
+#include "stonky/utils/magic_enum_wrapper.hpp"
+#include <boost/asio/executor_work_guard.hpp>
+#include <nlohmann/json.hpp>
+#include <openssl/hmac.h>
+#include <atomic>
+#include <future>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace stonky::binance::futures {
+static auto BINANCE_FUTURES_WS_API_HOST = "ws-fapi.binance.com";
+static auto BINANCE_FUTURES_WS_API_PORT = "443";
+static auto BINANCE_FUTURES_WS_API_TARGET = "/ws-fapi/v1";
+static constexpr std::int64_t RECV_WINDOW = 60000;
+/// Orders arriving later than this after their timestamp are rejected by the server, bounds how late a request the
+/// client has given up on may still be executed
+static constexpr std::int64_t ORDER_RECV_WINDOW = 5000;
+
+struct WSTradingClient::P {
+    std::string apiKey;
+    std::string apiSecret;
+    const EVP_MD *evpMd;
+    boost::asio::io_context ioContext{1};
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> workGuard;
+    boost::asio::ssl::context ctx;
+    std::shared_ptr<WebSocketSession> session;
+    std::thread ioThread;
+    onLogMessage logMessageCB;
+    int timeout{10};
+    std::mutex locker;
+    std::int64_t lastRequestId{};
+
+    struct PendingRequest {
+        std::promise<nlohmann::json> promise;
+        std::int64_t sendTime{};
+        /// Set when the request fails or times out, keeps the session from sending a still queued frame
+        std::shared_ptr<std::atomic<bool> > cancelled{std::make_shared<std::atomic<bool> >(false)};
+    };
+
+    /// Requests waiting for their response, keyed by request id
+    std::map<std::int64_t, PendingRequest> pendingRequests;
+
+    P(const std::string &apiKey, const std::string &apiSecret) : apiKey(apiKey), apiSecret(apiSecret),
+                                                                 evpMd(EVP_sha256()),
+                                                                 workGuard(make_work_guard(ioContext)),
+                                                                 ctx(boost::asio::ssl::context::sslv23_client) {
+    }
+
+    void log(const LogSeverity severity, const std::string &msg) const {
+        if (logMessageCB) {
+            logMessageCB(severity, msg);
+        }
+    }
+
+    void connect() {
+        session = std::make_shared<WebSocketSession>(ioContext, ctx, [this](const LogSeverity severity,
+                                                                            const std::string &msg) {
+            log(severity, msg);
+        });
+        /// Requests sent during the outage are queued by the session and go out on the new connection, frames of the
+        /// failed requests are dropped
+        session->setAutoReconnect([this](const std::int64_t disconnectTime, const std::int64_t) {
+            failPendingRequests("WebSocket API connection lost, request outcome is unknown", disconnectTime);
+        });
+        session->setRollover(nullptr);
+        session->runRaw(BINANCE_FUTURES_WS_API_HOST, BINANCE_FUTURES_WS_API_PORT, BINANCE_FUTURES_WS_API_TARGET,
+                        [this](const std::string_view frame) {
+                            onResponse(frame);
+                        });
+        ioThread = std::thread([this] {
+            ioContext.run();
+        });
+    }
+
+    /**
+     * Value as it is signed - strings without quotes, numbers and booleans as JSON text
+     */
+    static std::string paramToString(const nlohmann::json &value) {
+        return value.is_string() ? value.get<std::string>() : value.dump();
+    }
+
+    /**
+     * Add apiKey, recvWindow, timestamp and signature. Signed payload is the query string of all parameters sorted by
+     * name, nlohmann::json keeps object keys sorted.
+     */
+    void sign(nlohmann::json &params, const std::int64_t recvWindow) const {
+        params["apiKey"] = apiKey;
+        params["recvWindow"] = recvWindow;
+        params["timestamp"] = getMsTimestamp(currentTime()).count();
+
+        std::string payload;
+
+        for (auto it = params.begin(); it != params.end(); ++it) {
+            if (!payload.empty()) {
+                payload.push_back('&');
+            }
+
+            payload.append(it.key());
+            payload.push_back('=');
+            payload.append(paramToString(*it));
+        }
+
+        unsigned char digest[SHA256_DIGEST_LENGTH];
+        unsigned int digestLength = SHA256_DIGEST_LENGTH;
+
+        HMAC(evpMd, apiSecret.data(), apiSecret.size(), reinterpret_cast<const unsigned char *>(payload.data()),
+             payload.length(), digest, &digestLength);
+
+        params["signature"] = stringToHex(digest, sizeof(digest));
+    }
+
+    /**
+     * Send signed request and wait for its result. A frame still queued when the request times out or fails is not
+     * sent, one already sent may still be executed by the server within recvWindow.
+     * @param recvWindow ms after the request timestamp the server still accepts it
+     * @return "result" of the response
+     * @throws std::runtime_error if the request fails or times out
+     */
+    nlohmann::json request(const std::string &method, nlohmann::json params,
+                           const std::int64_t recvWindow = RECV_WINDOW) {
+        sign(params, recvWindow);
+        std::future<nlohmann::json> response;
+        std::shared_ptr<std::atomic<bool> > cancelled;
+        std::int64_t id;
+        {
+            std::lock_guard lk(locker);
+            id = ++lastRequestId;
+            auto &pendingRequest = pendingRequests[id];
+            pendingRequest.sendTime = getMsTimestamp(currentTime()).count();
+            response = pendingRequest.promise.get_future();
+            cancelled = pendingRequest.cancelled;
+        }
+
+        const nlohmann::json request{{"id", id}, {"method", method}, {"params", std::move(params)}};
+        session->send(request.dump(), cancelled);
+
+        if (response.wait_for(std::chrono::seconds(timeout)) != std::future_status::ready) {
+            std::lock_guard lk(locker);
+            *cancelled = true;
+            pendingRequests.erase(id);
+            throw std::runtime_error(fmt::format("WebSocket API request {} timed out", method));
+        }
+
+        return response.get();
+    }
+
+    void onResponse(const std::string_view frame) {
+        try {
+            const auto json = nlohmann::json::parse(frame);
+            std::int64_t id{};
+            int status{};
+            readValue<std::int64_t>(json, "id", id);
+            readValue<int>(json, "status", status);
+
+            std::promise<nlohmann::json> promise;
+            {
+                std::lock_guard lk(locker);
+                const auto it = pendingRequests.find(id);
+
+                if (it == pendingRequests.end()) {
+                    /// Timed out already
+                    return;
+                }
+
+                promise = std::move(it->second.promise);
+                pendingRequests.erase(it);
+            }
+
+            if (const auto it = json.find("result"); status == 200 && it != json.end()) {
+                promise.set_value(*it);
+            } else {
+                int code{};
+                std::string msg;
+
+                if (const auto it = json.find("error"); it != json.end()) {
+                    readValue<int>(*it, "code", code);
+                    readValue<std::string>(*it, "msg", msg);
+                }
+
+                promise.set_exception(std::make_exception_ptr(std::runtime_error(
+                    fmt::format("Bad WebSocket API response: {}, API Code: {}, message: {}", status, code, msg))));
+            }
+        } catch (const std::exception &e) {
+            log(LogSeverity::Error, fmt::format("WebSocket API response: {}", e.what()));
+        }
+    }
+
+    /**
+     * @param sentUntil fail requests sent at this time in ms or earlier
+     */
+    void failPendingRequests(const std::string &msg,
+                             const std::int64_t sentUntil = std::numeric_limits<std::int64_t>::max()) {
+        std::lock_guard lk(locker);
+
+        for (auto it = pendingRequests.begin(); it != pendingRequests.end();) {
+            if (it->second.sendTime <= sentUntil) {
+                *it->second.cancelled = true;
+                it->second.promise.set_exception(std::make_exception_ptr(std::runtime_error(msg)));
+                it = pendingRequests.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    static nlohmann::json orderParams(const Order &order) {
+        nlohmann::json params;
+        params["symbol"] = order.symbol;
+        params["side"] = magic_enum::enum_name(order.side);
+        params["positionSide"] = magic_enum::enum_name(order.positionSide);
+        params["type"] = magic_enum::enum_name(order.type);
+
+        if (!order.closePosition) {
+            params["quantity"] = formatDouble(order.quantityPrecision, order.quantity);
+        }
+
+        switch (order.type) {
+            case OrderType::LIMIT:
+                params["timeInForce"] = magic_enum::enum_name(order.timeInForce);
+                params["price"] = formatDouble(order.pricePrecision, order.price);
+                break;
+            case OrderType::STOP:
+            case OrderType::TAKE_PROFIT:
+                params["price"] = formatDouble(order.pricePrecision, order.price);
+                params["stopPrice"] = formatDouble(order.pricePrecision, order.stopPrice);
+                break;
+            case OrderType::STOP_MARKET:
+            case OrderType::TAKE_PROFIT_MARKET:
+                params["stopPrice"] = formatDouble(order.pricePrecision, order.stopPrice);
+
+                if (order.closePosition) {
+                    params["closePosition"] = "true";
+                }
+                break;
+            case OrderType::TRAILING_STOP_MARKET:
+                params["callbackRate"] = std::to_string(order.callbackRate);
+                params["activationPrice"] = formatDouble(order.pricePrecision, order.activationPrice);
+                break;
+            default:
+                break;
+        }
+
+        if (order.positionSide == PositionSide::BOTH && !order.closePosition) {
+            params["reduceOnly"] = fmt::format("{}", order.reduceOnly);
+        }
+
+        if (!order.newClientOrderId.empty()) {
+            params["newClientOrderId"] = order.newClientOrderId;
+        }
+
+        params["newOrderRespType"] = magic_enum::enum_name(order.newOrderRespType);
+        return params;
+    }
+
+    static nlohmann::json orderIdParams(const std::string &symbol, const std::string &clientId,
+                                        const std::int64_t orderId) {
+        nlohmann::json params;
+        params["symbol"] = symbol;
+
+        if (!clientId.empty()) {
+            params["origClientOrderId"] = clientId;
+        }
+
+        if (orderId != 0) {
+            params["orderId"] = orderId;
+        }
+
+        return params;
+    }
+
+    static OrderResponse toOrderResponse(const nlohmann::json &result) {
+        OrderResponse retVal;
+        retVal.fromJson(result);
+        return retVal;
+    }
+};
+
+WSTradingClient::WSTradingClient(const std::string &apiKey, const std::string &apiSecret) : m_p(
+    std::make_unique<P>(apiKey, apiSecret)) {
+    m_p->connect();
+}
+
+WSTradingClient::~WSTradingClient() {
+    m_p->session->close();
+    m_p->workGuard.reset();
+    m_p->ioContext.stop();
+
+    if (m_p->ioThread.joinable()) {
+        m_p->ioThread.join();
+    }
+
+    m_p->failPendingRequests("WebSocket API client destroyed");
+}
+
+void WSTradingClient::setLoggerCallback(const onLogMessage &onLogMessageCB) const {
+    m_p->logMessageCB = onLogMessageCB;
+}
+
+void WSTradingClient::setTimeout(const int seconds) const {
+    m_p->timeout = seconds;
+}
+
+OrderResponse WSTradingClient::sendOrder(const Order &order) const {
+    return P::toOrderResponse(m_p->request("order.place", P::orderParams(order), ORDER_RECV_WINDOW));
+}
+
+OrderResponse WSTradingClient::modifyOrder(const Order &order) const {
+    auto params = P::orderIdParams(order.symbol, order.newClientOrderId, order.orderId);
+    params["side"] = magic_enum::enum_name(order.side);
+    params["quantity"] = formatDouble(order.quantityPrecision, order.quantity);
+    params["price"] = formatDouble(order.pricePrecision, order.price);
+    return P::toOrderResponse(m_p->request("order.modify", std::move(params), ORDER_RECV_WINDOW));
+}
+
+OrderResponse
+WSTradingClient::cancelOrder(const std::string &symbol, const std::string &clientId, const std::int64_t orderId) const {
+    return P::toOrderResponse(m_p->request("order.cancel", P::orderIdParams(symbol, clientId, orderId),
+                                              ORDER_RECV_WINDOW));
+}
+
+OrderResponse
+WSTradingClient::queryOrder(const std::string &symbol, const std::string &clientId, const std::int64_t orderId) const {
+    return P::toOrderResponse(m_p->request("order.status", P::orderIdParams(symbol, clientId, orderId)));
+}
+}
@@ -7,6 +7,7 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 */
 
 #include "stonky/binance/binance_http_session.h"
+#include "stonky/binance/binance_json_parser.h"
 #include "stonky/utils/utils.h"
 #include <boost/asio/ssl.hpp>
 #include <boost/beast/version.hpp>
@@ -217,6 +218,13 @@ http::response<http::string_body> HTTPSession::P::request(
     beast::flat_buffer buffer;
     http::response_parser<http::string_body> parser;
     parser.body_limit((std::numeric_limits<std::uint64_t>::max)());
+    http::read_header(stream, buffer, parser);
+
+    /// Spare capacity lets parseResponse() parse the body in place, the body reader keeps a larger reservation
+    if (const auto contentLength = parser.content_length(); contentLength.has_value()) {
+        parser.get().body().reserve(*contentLength + JSON_PAYLOAD_PADDING);
+    }
+
     http::read(stream, buffer, parser);
 
     std::string limiterName("X-MBX-USED-WEIGHT-1M");
@@ -249,7 +257,7 @@ http::response<http::string_body> HTTPSession::P::request(
         ec.assign(0, ec.category());
     }
 
-    return parser.get();
+    return parser.release();
 }
 
 void HTTPSession::P::addTimestampToTargetPath(std::string &target) const {
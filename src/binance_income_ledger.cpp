@@ -0,0 +1,187 @@
+/**
+Binance Futures Income Ledger
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_income_ledger.h"
+#include "stonky/binance/binance_futures_rest_client.h"
+#include "stonky/utils/utils.h"
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <spdlog/spdlog.h>
+
+namespace stonky::binance::futures {
+static constexpr std::int32_t INCOME_PAGE_LIMIT = 1000; /// max. limit of income endpoint
+
+struct IncomeLedger::P {
+    std::weak_ptr<RESTClient> restClient;
+    std::filesystem::path filePath;
+    mutable std::mutex syncLocker;
+    mutable std::mutex locker;
+    std::vector<Income> incomes;
+    std::set<std::pair<std::int64_t, IncomeType> > knownRecords;
+
+    P(const std::weak_ptr<RESTClient> &restClient, std::filesystem::path filePath) : restClient(restClient),
+        filePath(std::move(filePath)) {
+    }
+
+    /**
+     * Insert a record unless it is already known, keeps records ordered by time
+     * @return true if inserted
+     */
+    bool add(const Income &income) {
+        std::lock_guard lk(locker);
+
+        if (!knownRecords.emplace(income.tranId, income.incomeType).second) {
+            return false;
+        }
+
+        if (incomes.empty() || incomes.back().time <= income.time) {
+            incomes.push_back(income);
+        } else {
+            incomes.insert(std::ranges::upper_bound(incomes, income.time, {}, &Income::time), income);
+        }
+
+        return true;
+    }
+
+    void load() {
+        std::ifstream inFile(filePath);
+
+        if (!inFile.is_open()) {
+            return;
+        }
+
+        std::string row;
+
+        while (std::getline(inFile, row)) {
+            if (row.empty()) {
+                continue;
+            }
+
+            try {
+                Income income;
+                income.fromJson(nlohmann::json::parse(row));
+                add(income);
+            } catch (const nlohmann::json::exception &e) {
+                /// Most likely the last row written partially, it is downloaded again by the next sync
+                spdlog::warn(fmt::format("Skipping invalid income ledger row: {}", e.what()));
+            }
+        }
+    }
+
+    [[nodiscard]] std::pair<std::vector<Income>::const_iterator, std::vector<Income>::const_iterator>
+    range(const std::int64_t startTime, const std::int64_t endTime) const {
+        return {
+            std::ranges::lower_bound(incomes, startTime, {}, &Income::time),
+            std::ranges::upper_bound(incomes, endTime, {}, &Income::time)
+        };
+    }
+};
+
+IncomeLedger::IncomeLedger(const std::weak_ptr<RESTClient> &restClient, const std::filesystem::path &filePath) : m_p(
+    std::make_unique<P>(restClient, filePath)) {
+    m_p->load();
+}
+
+IncomeLedger::~IncomeLedger() = default;
+
+std::size_t IncomeLedger::sync(const std::int64_t startTime) const {
+    const auto client = m_p->restClient.lock();
+
+    if (!client) {
+        throw std::runtime_error("REST client is not available");
+    }
+
+    std::lock_guard lk(m_p->syncLocker);
+
+    std::int64_t fromTime = lastTime();
+
+    if (fromTime < 0) {
+        fromTime = startTime;
+    }
+
+    if (m_p->filePath.has_parent_path()) {
+        std::filesystem::create_directories(m_p->filePath.parent_path());
+    }
+
+    std::ofstream outFile(m_p->filePath, std::ios::app);
+    const auto nowTimestamp = getMsTimestamp(currentTime()).count();
+    std::size_t retVal = 0;
+
+    const auto store = [&](const std::vector<Income> &incomes) {
+        for (const auto &income: incomes) {
+            if (m_p->add(income)) {
+                outFile << income.toJson().dump() << '\n';
+                retVal++;
+            }
+        }
+
+        outFile.flush();
+    };
+
+    for (;;) {
+        /// startTime is inclusive, records of the last page boundary are received again and skipped
+        const auto incomes = client->getIncome("", fromTime, nowTimestamp, IncomeType::ALL, INCOME_PAGE_LIMIT);
+        store(incomes);
+
+        if (incomes.size() < INCOME_PAGE_LIMIT) {
+            break;
+        }
+
+        if (incomes.back().time != fromTime) {
+            fromTime = incomes.back().time;
+            continue;
+        }
+
+        /// The whole page has one timestamp, the window of the two ms is read page by page, endTime must be greater
+        /// than startTime. Paging by time continues only behind the fully read window, known records are skipped.
+        for (std::int32_t page = 1;; page++) {
+            const auto pageIncomes = client->getIncome("", fromTime, fromTime + 1, IncomeType::ALL, INCOME_PAGE_LIMIT,
+                                                       page);
+            store(pageIncomes);
+
+            if (pageIncomes.size() < INCOME_PAGE_LIMIT) {
+                break;
+            }
+        }
+
+        fromTime += 2;
+    }
+
+    return retVal;
+}
+
+std::vector<Income> IncomeLedger::getIncome(const std::int64_t startTime, const std::int64_t endTime) const {
+    std::lock_guard lk(m_p->locker);
+
+    if (const auto [first, last] = m_p->range(startTime, endTime); first < last) {
+        return {first, last};
+    }
+
+    return {};
+}
+
+std::map<std::string, std::map<IncomeType, double> >
+IncomeLedger::aggregate(const std::int64_t startTime, const std::int64_t endTime, const std::string &asset) const {
+    std::map<std::string, std::map<IncomeType, double> > retVal;
+    std::lock_guard lk(m_p->locker);
+
+    for (auto [it, last] = m_p->range(startTime, endTime); it < last; ++it) {
+        if (it->asset == asset) {
+            retVal[it->symbol][it->incomeType] += it->income;
+        }
+    }
+
+    return retVal;
+}
+
+std::int64_t IncomeLedger::lastTime() const {
+    std::lock_guard lk(m_p->locker);
+    return m_p->incomes.empty() ? -1 : m_p->incomes.back().time;
+}
+}
@@ -0,0 +1,570 @@
+/**
+Binance JSON Response Parser
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_json_parser.h"
+#include "stonky/binance/binance_enum_parser.h"
+#include "stonky/utils/json_utils.h"
+#include <charconv>
+
+#ifdef BINANCE_API_USE_SIMDJSON
+#include <simdjson.h>
+
+static_assert(stonky::binance::JSON_PAYLOAD_PADDING == simdjson::SIMDJSON_PADDING);
+#endif
+
+namespace stonky::binance {
+bool parseDouble(const std::string_view str, double &value) {
+    double number;
+
+    if (const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), number);
+        ec != std::errc() || ptr != str.data() + str.size()) {
+        return false;
+    }
+
+    value = number;
+    return true;
+}
+
+double readDecimal(const nlohmann::json &value) {
+    if (value.is_number()) {
+        return value.get<double>();
+    }
+
+    if (!value.is_string()) {
+        throw JsonParseError("Decimal value expected, got " + std::string(value.type_name()));
+    }
+
+    const auto &str = value.get_ref<const std::string &>();
+    double retVal = 0.0;
+
+    if (!str.empty() && !parseDouble(str, retVal)) {
+        throw JsonParseError("Invalid decimal value: " + str);
+    }
+
+    return retVal;
+}
+
+double readDecimal(const nlohmann::json &json, const std::string_view key, const double def) {
+    const auto it = json.find(key);
+
+    if (it == json.end() || it->is_null() || (it->is_string() && it->get_ref<const std::string &>().empty())) {
+        return def;
+    }
+
+    return readDecimal(*it);
+}
+
+void readOrderBookLevels(const nlohmann::json &json, const std::string_view key,
+                         std::vector<futures::OrderBookLevel> &levels) {
+    levels.clear();
+    const auto it = json.find(key);
+
+    if (it == json.end() || it->is_null()) {
+        return;
+    }
+
+    levels.reserve(it->size());
+
+    for (const auto &level: *it) {
+        if (!level.is_array() || level.size() < 2) {
+            throw JsonParseError("Price level expected, got " + level.dump());
+        }
+
+        levels.push_back({readDecimal(level[0]), readDecimal(level[1])});
+    }
+}
+
+#ifdef BINANCE_API_USE_SIMDJSON
+using OnDemandValue = simdjson::ondemand::value;
+
+/**
+ * Parse the payload by a per-thread parser, its internal buffers are reused by subsequent calls.
+ * The payload is parsed in place if its spare capacity covers SIMDJSON_PADDING, only otherwise it is copied.
+ * @param fn called with the root value
+ */
+template<typename Fn>
+static void parseOnDemand(const std::string &payload, Fn &&fn) {
+    thread_local simdjson::ondemand::parser parser;
+
+    try {
+        const auto parseDocument = [&](const simdjson::padded_string_view json) {
+            simdjson::ondemand::document document = parser.iterate(json);
+            OnDemandValue root = document.get_value();
+            fn(root);
+        };
+
+        if (payload.capacity() - payload.size() >= simdjson::SIMDJSON_PADDING) {
+            parseDocument(simdjson::padded_string_view(payload.data(), payload.size(), payload.capacity()));
+        } else {
+            const simdjson::padded_string json(payload);
+            parseDocument(json);
+        }
+    } catch (const simdjson::simdjson_error &e) {
+        throw JsonParseError(e.what());
+    }
+}
+
+template<typename Fn>
+static void forEachField(OnDemandValue &object, Fn &&fn) {
+    for (auto field: object.get_object()) {
+        const std::string_view key = field.unescaped_key();
+        OnDemandValue value = field.value();
+        fn(key, value);
+    }
+}
+
+template<typename Fn>
+static void forEachElement(OnDemandValue &array, Fn &&fn) {
+    for (OnDemandValue element: array.get_array()) {
+        fn(element);
+    }
+}
+
+/**
+ * Values of unexpected type (typically null) are skipped and the model keeps its default, same as with readValue()
+ */
+static bool checkError(const simdjson::error_code error) {
+    if (error == simdjson::INCORRECT_TYPE) {
+        return false;
+    }
+
+    if (error != simdjson::SUCCESS) {
+        throw simdjson::simdjson_error(error);
+    }
+
+    return true;
+}
+
+static void read(OnDemandValue &value, std::string &out) {
+    if (std::string_view str; checkError(value.get_string().get(str))) {
+        out = str;
+    }
+}
+
+static void read(OnDemandValue &value, bool &out) {
+    if (bool boolean; checkError(value.get_bool().get(boolean))) {
+        out = boolean;
+    }
+}
+
+template<typename T> requires std::is_integral_v<T>
+static void read(OnDemandValue &value, T &out) {
+    if (std::int64_t number; checkError(value.get_int64().get(number))) {
+        out = static_cast<T>(number);
+    }
+}
+
+/**
+ * Binance sends decimals as strings, numbers are accepted as well, counterpart of readDecimal()
+ */
+static void read(OnDemandValue &value, double &out) {
+    std::string_view str;
+
+    if (const auto error = value.get_string().get(str); error == simdjson::INCORRECT_TYPE) {
+        if (double number; checkError(value.get_double().get(number))) {
+            out = number;
+        }
+    } else if (checkError(error) && !str.empty()) {
+        if (!parseDouble(str, out)) {
+            throw JsonParseError("Invalid decimal value: " + std::string(str));
+        }
+    }
+}
+
+/**
+ * Counterpart of readEnum()
+ */
+template<typename T> requires std::is_enum_v<T>
+static void read(OnDemandValue &value, T &out) {
+    if (std::string_view str; checkError(value.get_string().get(str))) {
+        if (const auto enumValue = parseEnum<T>(str); enumValue.has_value()) {
+            out = enumValue.value();
+        }
+    }
+}
+
+static void read(OnDemandValue &value, Candle &candle) {
+    std::size_t index = 0;
+
+    forEachElement(value, [&](OnDemandValue &element) {
+        switch (index++) {
+            case 0:
+                read(element, candle.openTime);
+                break;
+            case 1:
+                read(element, candle.open);
+                break;
+            case 2:
+                read(element, candle.high);
+                break;
+            case 3:
+                read(element, candle.low);
+                break;
+            case 4:
+                read(element, candle.close);
+                break;
+            case 5:
+                read(element, candle.volume);
+                break;
+            case 6:
+                read(element, candle.closeTime);
+                break;
+            case 7:
+                read(element, candle.quoteVolume);
+                break;
+            case 8:
+                read(element, candle.numberOfTrades);
+                break;
+            case 9:
+                read(element, candle.takerBuyVolume);
+                break;
+            case 10:
+                read(element, candle.takerQuoteVolume);
+                break;
+            case 11:
+                read(element, candle.ignore);
+                break;
+            default:
+                break;
+        }
+    });
+}
+
+static void read(OnDemandValue &value, RateLimit &rateLimit) {
+    forEachField(value, [&](const std::string_view key, OnDemandValue &field) {
+        if (key == "interval") {
+            read(field, rateLimit.interval);
+        } else if (key == "intervalNum") {
+            read(field, rateLimit.intervalNum);
+        } else if (key == "limit") {
+            read(field, rateLimit.limit);
+        } else if (key == "rateLimitType") {
+            read(field, rateLimit.rateLimitType);
+        }
+    });
+}
+
+static void read(OnDemandValue &value, futures::MarkPrice &markPrice) {
+    forEachField(value, [&](const std::string_view key, OnDemandValue &field) {
+        if (key == "symbol") {
+            read(field, markPrice.symbol);
+        } else if (key == "markPrice") {
+            read(field, markPrice.markPrice);
+        } else if (key == "indexPrice") {
+            read(field, markPrice.indexPrice);
+        } else if (key == "estimatedSettlePrice") {
+            read(field, markPrice.estimatedSettlePrice);
+        } else if (key == "lastFundingRate") {
+            read(field, markPrice.lastFundingRate);
+        } else if (key == "interestRate") {
+            read(field, markPrice.interestRate);
+        } else if (key == "nextFundingTime") {
+            read(field, markPrice.nextFundingTime);
+        } else if (key == "time") {
+            read(field, markPrice.time);
+        }
+    });
+}
+
+static void read(OnDemandValue &value, futures::FundingRate &fundingRate) {
+    forEachField(value, [&](const std::string_view key, OnDemandValue &field) {
+        if (key == "symbol") {
+            read(field, fundingRate.symbol);
+        } else if (key == "fundingRate") {
+            read(field, fundingRate.fundingRate);
+        } else if (key == "fundingTime") {
+            read(field, fundingRate.fundingTime);
+        }
+    });
+}
+
+static void read(OnDemandValue &value, futures::Income &income) {
+    forEachField(value, [&](const std::string_view key, OnDemandValue &field) {
+        if (key == "symbol") {
+            read(field, income.symbol);
+        } else if (key == "incomeType") {
+            read(field, income.incomeType);
+        } else if (key == "income") {
+            read(field, income.income);
+        } else if (key == "asset") {
+            read(field, income.asset);
+        } else if (key == "info") {
+            read(field, income.info);
+        } else if (key == "time") {
+            read(field, income.time);
+        } else if (key == "tranId") {
+            read(field, income.tranId);
+        } else if (key == "tradeId") {
+            read(field, income.tradeId);
+        }
+    });
+}
+
+static void read(OnDemandValue &value, futures::Asset &asset) {
+    forEachField(value, [&](const std::string_view key, OnDemandValue &field) {
+        if (key == "asset") {
+            read(field, asset.asset);
+        } else if (key == "walletBalance") {
+            read(field, asset.walletBalance);
+        } else if (key == "unrealizedProfit") {
+            read(field, asset.unrealizedProfit);
+        } else if (key == "marginBalance") {
+            read(field, asset.marginBalance);
+        } else if (key == "maintMargin") {
+            read(field, asset.maintMargin);
+        } else if (key == "initialMargin") {
+            read(field, asset.initialMargin);
+        } else if (key == "positionInitialMargin") {
+            read(field, asset.positionInitialMargin);
+        } else if (key == "openOrderInitialMargin") {
+            read(field, asset.openOrderInitialMargin);
+        } else if (key == "crossWalletBalance") {
+            read(field, asset.crossWalletBalance);
+        } else if (key == "crossUnPnl") {
+            read(field, asset.crossUnPnl);
+        } else if (key == "availableBalance") {
+            read(field, asset.availableBalance);
+        } else if (key == "maxWithdrawAmount") {
+            read(field, asset.maxWithdrawAmount);
+        } else if (key == "marginAvailable") {
+            read(field, asset.marginAvailable);
+        } else if (key == "updateTime") {
+            read(field, asset.updateTime);
+        } else if (key == "autoAssetExchange") {
+            read(field, asset.autoAssetExchange);
+        }
+    });
+}
+
+/**
+ * Read the filter step into both the double and the exact decimal from a single string access
+ */
+static void readStep(OnDemandValue &value, double &out, Decimal &exactOut) {
+    std::string_view str;
+
+    if (const auto error = value.get_string().get(str); error == simdjson::INCORRECT_TYPE) {
+        if (double number; checkError(value.get_double().get(number))) {
+            out = number;
+            exactOut = Decimal::fromDouble(number, Decimal::BINANCE_SCALE);
+        }
+    } else if (checkError(error) && !str.empty()) {
+        if (!parseDouble(str, out)) {
+            throw JsonParseError("Invalid decimal value: " + std::string(str));
+        }
+
+        exactOut = Decimal::fromString(str);
+    }
+}
+
+static void read(OnDemandValue &value, futures::Filter &filter) {
+    forEachField(value, [&](const std::string_view key, OnDemandValue &field) {
+        if (key == "filterType") {
+            read(field, filter.filterType);
+        } else if (key == "maxPrice") {
+            read(field, filter.maxPrice);
+        } else if (key == "minPrice") {
+            read(field, filter.minPrice);
+        } else if (key == "tickSize") {
+            readStep(field, filter.tickSize, filter.exactTickSize);
+        } else if (key == "minQty") {
+            read(field, filter.minQty);
+        } else if (key == "maxQty") {
+            read(field, filter.maxQty);
+        } else if (key == "stepSize") {
+            readStep(field, filter.stepSize, filter.exactStepSize);
+        } else if (key == "limit") {
+            read(field, filter.limit);
+        } else if (key == "multiplierUp") {
+            read(field, filter.multiplierUp);
+        } else if (key == "multiplierDown") {
+            read(field, filter.multiplierDown);
+        } else if (key == "multiplierDecimal") {
+            read(field, filter.multiplierDecimal);
+        } else if (key == "notional") {
+            read(field, filter.notional);
+        }
+    });
+}
+
+static void read(OnDemandValue &value, futures::Symbol &symbol) {
+    forEachField(value, [&](const std::string_view key, OnDemandValue &field) {
+        if (key == "symbol") {
+            read(field, symbol.symbol);
+        } else if (key == "pair") {
+            read(field, symbol.pair);
+        } else if (key == "contractType") {
+            read(field, symbol.contractType);
+        } else if (key == "deliveryDate") {
+            read(field, symbol.deliveryDate);
+        } else if (key == "onboardDate") {
+            read(field, symbol.onboardDate);
+        } else if (key == "status") {
+            read(field, symbol.status);
+        } else if (key == "maintMarginPercent") {
+            read(field, symbol.maintMarginPercent);
+        } else if (key == "requiredMarginPercent") {
+            read(field, symbol.requiredMarginPercent);
+        } else if (key == "baseAsset") {
+            read(field, symbol.baseAsset);
+        } else if (key == "quoteAsset") {
+            read(field, symbol.quoteAsset);
+        } else if (key == "marginAsset") {
+            read(field, symbol.marginAsset);
+        } else if (key == "pricePrecision") {
+            read(field, symbol.pricePrecision);
+        } else if (key == "quantityPrecision") {
+            read(field, symbol.quantityPrecision);
+        } else if (key == "baseAssetPrecision") {
+            read(field, symbol.baseAssetPrecision);
+        } else if (key == "quotePrecision") {
+            read(field, symbol.quotePrecision);
+        } else if (key == "underlyingType") {
+            read(field, symbol.underlyingType);
+        } else if (key == "underlyingSubType") {
+            symbol.underlyingSubType.clear();
+            forEachElement(field, [&](OnDemandValue &element) {
+                read(element, symbol.underlyingSubType.emplace_back());
+            });
+        } else if (key == "filters") {
+            symbol.filters.clear();
+            forEachElement(field, [&](OnDemandValue &element) {
+                read(element, symbol.filters.emplace_back());
+            });
+        } else if (key == "settlePlan") {
+            read(field, symbol.settlePlan);
+        } else if (key == "triggerProtect") {
+            read(field, symbol.triggerProtect);
+        }
+    });
+}
+
+static void read(OnDemandValue &value, futures::Exchange &exchange) {
+    exchange.rateLimits.clear();
+    exchange.assets.clear();
+    exchange.symbols.clear();
+
+    forEachField(value, [&](const std::string_view key, OnDemandValue &field) {
+        if (key == "rateLimits") {
+            forEachElement(field, [&](OnDemandValue &element) {
+                read(element, exchange.rateLimits.emplace_back());
+            });
+        } else if (key == "assets") {
+            forEachElement(field, [&](OnDemandValue &element) {
+                read(element, exchange.assets.emplace_back());
+            });
+        } else if (key == "symbols") {
+            forEachElement(field, [&](OnDemandValue &element) {
+                read(element, exchange.symbols.emplace_back());
+            });
+        } else if (key == "serverTime") {
+            read(field, exchange.serverTime);
+        } else if (key == "timezone") {
+            read(field, exchange.timezone);
+        }
+    });
+}
+
+/**
+ * Parse top level array into a vector of models
+ */
+template<typename T>
+static void parseArrayOnDemand(const std::string &payload, std::vector<T> &out) {
+    out.clear();
+
+    parseOnDemand(payload, [&](OnDemandValue &root) {
+        forEachElement(root, [&](OnDemandValue &element) {
+            read(element, out.emplace_back());
+        });
+    });
+}
+#endif
+
+/**
+ * Dispatch to the selected backend
+ * @param model IJson model, filled by fromJson() with Nlohmann backend
+ * @param parseSimdjson called with Simdjson backend
+ */
+template<typename T, typename Fn>
+static void parse(const std::string &payload, T &model, const JsonBackend backend,
+                  [[maybe_unused]] Fn &&parseSimdjson) {
+    switch (backend) {
+        case JsonBackend::Nlohmann:
+            model.fromJson(nlohmann::json::parse(payload));
+            return;
+        case JsonBackend::Simdjson:
+#ifdef BINANCE_API_USE_SIMDJSON
+            parseSimdjson();
+            return;
+#else
+            break;
+#endif
+    }
+
+    throw std::runtime_error("JSON backend not available: " + std::string(magic_enum::enum_name(backend)));
+}
+
+JsonBackend defaultJsonBackend() {
+#ifdef BINANCE_API_USE_SIMDJSON
+    return JsonBackend::Simdjson;
+#else
+    return JsonBackend::Nlohmann;
+#endif
+}
+
+bool isJsonBackendAvailable(const JsonBackend backend) {
+#ifdef BINANCE_API_USE_SIMDJSON
+    return backend == JsonBackend::Nlohmann || backend == JsonBackend::Simdjson;
+#else
+    return backend == JsonBackend::Nlohmann;
+#endif
+}
+
+void parseResponse(const std::string &payload, CandlesResponse &candlesResponse, const JsonBackend backend) {
+    parse(payload, candlesResponse, backend, [&] {
+#ifdef BINANCE_API_USE_SIMDJSON
+        parseArrayOnDemand(payload, candlesResponse.candles);
+#endif
+    });
+}
+}
+
+namespace stonky::binance::futures {
+void parseResponse(const std::string &payload, MarkPrices &markPrices, const JsonBackend backend) {
+    parse(payload, markPrices, backend, [&] {
+#ifdef BINANCE_API_USE_SIMDJSON
+        parseArrayOnDemand(payload, markPrices.markPrices);
+#endif
+    });
+}
+
+void parseResponse(const std::string &payload, FundingRates &fundingRates, const JsonBackend backend) {
+    parse(payload, fundingRates, backend, [&] {
+#ifdef BINANCE_API_USE_SIMDJSON
+        parseArrayOnDemand(payload, fundingRates.fundingRates);
+#endif
+    });
+}
+
+void parseResponse(const std::string &payload, Exchange &exchange, const JsonBackend backend) {
+    parse(payload, exchange, backend, [&] {
+#ifdef BINANCE_API_USE_SIMDJSON
+        parseOnDemand(payload, [&](OnDemandValue &root) {
+            read(root, exchange);
+        });
+#endif
+    });
+}
+
+void parseResponse(const std::string &payload, Incomes &incomes, const JsonBackend backend) {
+    parse(payload, incomes, backend, [&] {
+#ifdef BINANCE_API_USE_SIMDJSON
+        parseArrayOnDemand(payload, incomes.incomes);
+#endif
+    });
+}
+}
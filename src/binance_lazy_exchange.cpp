@@ -0,0 +1,171 @@
+/**
+Binance Lazily Decoded Exchange Info
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_lazy_exchange.h"
+#include "stonky/binance/binance_frame_reader.h"
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <mutex>
+
+namespace stonky::binance::futures {
+static constexpr std::size_t NO_INDEX = std::numeric_limits<std::size_t>::max();
+
+struct LazyExchange::P {
+    /// Raw response, all string views below point into it
+    std::string payload;
+    std::int64_t serverTime{};
+    std::vector<std::string_view> names;
+    /// Raw JSON objects of the symbols
+    std::vector<std::string_view> symbolData;
+    /// Index into names by SymbolId
+    std::vector<std::size_t> indexById;
+    std::unique_ptr<std::atomic<const Symbol *>[]> decoded;
+    std::mutex locker;
+    /// Elements of std::deque do not move on emplace_back, returned references stay valid
+    std::deque<Symbol> decodedSymbols;
+    std::once_flag exchangeFlag;
+    Exchange fullExchange;
+    /// Set by the constructor from decoded Exchange, exchange() has nothing to decode then
+    bool fullExchangeDecoded{false};
+
+    void indexSymbols() {
+        const auto &registry = SymbolRegistry::instance();
+        std::vector<SymbolId> symbolIds;
+        symbolIds.reserve(names.size());
+
+        for (const auto &name: names) {
+            symbolIds.push_back(registry.intern(name));
+        }
+
+        indexById.assign(registry.size(), NO_INDEX);
+
+        for (std::size_t i = 0; i < symbolIds.size(); i++) {
+            indexById[symbolIds[i]] = i;
+        }
+
+        decoded = std::make_unique<std::atomic<const Symbol *>[]>(names.size());
+    }
+};
+
+LazyExchange::LazyExchange(std::string payload) : m_p(std::make_unique<P>()) {
+    m_p->payload = std::move(payload);
+    FrameReader reader(m_p->payload);
+
+    reader.readObject([&](const std::string_view key) {
+        if (key == "serverTime") {
+            reader.read(m_p->serverTime);
+        } else if (key == "symbols") {
+            reader.readArray([&] {
+                const auto data = reader.readRaw();
+                FrameReader symbolReader(data);
+                std::string_view name;
+
+                symbolReader.readObject([&](const std::string_view symbolKey) {
+                    if (symbolKey == "symbol") {
+                        name = symbolReader.readString();
+                    } else {
+                        symbolReader.skipValue();
+                    }
+                });
+
+                m_p->names.push_back(name);
+                m_p->symbolData.push_back(data);
+            });
+        } else {
+            reader.skipValue();
+        }
+    });
+
+    m_p->indexSymbols();
+}
+
+LazyExchange::LazyExchange(Exchange exchange) : m_p(std::make_unique<P>()) {
+    m_p->fullExchange = std::move(exchange);
+    m_p->serverTime = m_p->fullExchange.serverTime;
+
+    for (const auto &symbol: m_p->fullExchange.symbols) {
+        m_p->names.emplace_back(symbol.symbol);
+    }
+
+    m_p->indexSymbols();
+
+    for (std::size_t i = 0; i < m_p->fullExchange.symbols.size(); i++) {
+        m_p->decoded[i].store(&m_p->fullExchange.symbols[i]);
+    }
+
+    m_p->fullExchangeDecoded = true;
+}
+
+LazyExchange::~LazyExchange() = default;
+
+std::int64_t LazyExchange::serverTime() const {
+    return m_p->serverTime;
+}
+
+std::string_view LazyExchange::payload() const {
+    return m_p->payload;
+}
+
+std::size_t LazyExchange::size() const {
+    return m_p->names.size();
+}
+
+std::string_view LazyExchange::symbolName(const std::size_t index) const {
+    return m_p->names.at(index);
+}
+
+const Symbol &LazyExchange::symbol(const std::size_t index) const {
+    if (index >= m_p->names.size()) {
+        throw std::out_of_range("Symbol index out of range: " + std::to_string(index));
+    }
+
+    if (const auto *symbol = m_p->decoded[index].load(std::memory_order_acquire)) {
+        return *symbol;
+    }
+
+    std::lock_guard lk(m_p->locker);
+
+    if (const auto *symbol = m_p->decoded[index].load(std::memory_order_relaxed)) {
+        return *symbol;
+    }
+
+    Symbol decodedSymbol;
+    decodedSymbol.fromJson(nlohmann::json::parse(m_p->symbolData[index]));
+
+    const auto &symbol = m_p->decodedSymbols.emplace_back(std::move(decodedSymbol));
+    m_p->decoded[index].store(&symbol, std::memory_order_release);
+    return symbol;
+}
+
+const Symbol *LazyExchange::find(const SymbolId symbolId) const {
+    if (symbolId < m_p->indexById.size() && m_p->indexById[symbolId] != NO_INDEX) {
+        return &symbol(m_p->indexById[symbolId]);
+    }
+
+    return nullptr;
+}
+
+const Symbol *LazyExchange::find(const std::string_view symbol) const {
+    if (const auto symbolId = SymbolRegistry::instance().find(symbol)) {
+        return find(*symbolId);
+    }
+
+    return nullptr;
+}
+
+const Exchange &LazyExchange::exchange() const {
+    if (!m_p->fullExchangeDecoded) {
+        std::call_once(m_p->exchangeFlag, [&] {
+            parseResponse(m_p->payload, m_p->fullExchange);
+        });
+    }
+
+    return m_p->fullExchange;
+}
+}
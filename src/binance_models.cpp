@@ -9,6 +9,10 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 #include "stonky/binance/binance_models.h"
 #include "stonky/utils/utils.h"
 #include "stonky/utils/json_utils.h"
+#include "stonky/binance/binance_json_parser.h"
+#include "stonky/binance/binance_enum_parser.h"
+#include "stonky/binance/binance_model_fields.h"
+#include <boost/algorithm/string/predicate.hpp>
 
 namespace stonky::binance {
 nlohmann::json Candle::toJson() const {
@@ -30,16 +34,16 @@ nlohmann::json Candle::toJson() const {
 
 void Candle::fromJson(const nlohmann::json &json) {
     openTime = json[0];
-    open = stod(json[1].get<std::string>());
-    high = stod(json[2].get<std::string>());
-    low = stod(json[3].get<std::string>());
-    close = stod(json[4].get<std::string>());
-    volume = stod(json[5].get<std::string>());
+    open = readDecimal(json[1]);
+    high = readDecimal(json[2]);
+    low = readDecimal(json[3]);
+    close = readDecimal(json[4]);
+    volume = readDecimal(json[5]);
     closeTime = json[6];
-    quoteVolume = stod(json[7].get<std::string>());
+    quoteVolume = readDecimal(json[7]);
     numberOfTrades = json[8];
-    takerBuyVolume = stod(json[9].get<std::string>());
-    takerQuoteVolume = stod(json[10].get<std::string>());
+    takerBuyVolume = readDecimal(json[9]);
+    takerQuoteVolume = readDecimal(json[10]);
     ignore = json[11];
 }
 
@@ -71,10 +75,10 @@ nlohmann::json RateLimit::toJson() const {
 }
 
 void RateLimit::fromJson(const nlohmann::json &json) {
-    readMagicEnum<RateLimitInterval>(json, "interval", interval);
+    readEnum(json, "interval", interval);
     readValue<int32_t>(json, "intervalNum", intervalNum);
     readValue<int32_t>(json, "limit", limit);
-    readMagicEnum<RateLimitType>(json, "rateLimitType", rateLimitType);
+    readEnum(json, "rateLimitType", rateLimitType);
 }
 }
 
@@ -85,7 +89,7 @@ nlohmann::json Symbol::toJson() const {
 
 void Symbol::fromJson(const nlohmann::json &json) {
     readValue<std::string>(json, "symbol", symbol);
-    readMagicEnum<ContractStatus>(json, "status", status);
+    readEnum(json, "status", status);
     readValue<std::string>(json, "baseAsset", baseAsset);
     readValue<std::string>(json, "quoteAsset", quoteAsset);
 }
@@ -112,16 +116,128 @@ void Exchange::fromJson(const nlohmann::json &json) {
 }
 }
 
+namespace stonky::binance {
+template<>
+struct ModelFields<futures::FundingRate> {
+    static constexpr std::tuple FIELDS{
+        field("symbol", &futures::FundingRate::symbol),
+        field("fundingTime", &futures::FundingRate::fundingTime),
+        field("fundingRate", &futures::FundingRate::fundingRate)
+    };
+};
+
+template<>
+struct ModelFields<futures::TickerPrice> {
+    static constexpr std::tuple FIELDS{
+        field("symbol", &futures::TickerPrice::symbol),
+        field("price", &futures::TickerPrice::price),
+        field("time", &futures::TickerPrice::time)
+    };
+};
+
+template<>
+struct ModelFields<futures::BookTickerPrice> {
+    static constexpr std::tuple FIELDS{
+        field("symbol", &futures::BookTickerPrice::symbol),
+        field("bidPrice", &futures::BookTickerPrice::bidPrice),
+        field("askPrice", &futures::BookTickerPrice::askPrice),
+        field("bidQty", &futures::BookTickerPrice::bidQty),
+        field("askQty", &futures::BookTickerPrice::askQty),
+        field("time", &futures::BookTickerPrice::time)
+    };
+};
+
+template<>
+struct ModelFields<futures::MarkPrice> {
+    static constexpr std::tuple FIELDS{
+        field("symbol", &futures::MarkPrice::symbol),
+        field("nextFundingTime", &futures::MarkPrice::nextFundingTime),
+        field("time", &futures::MarkPrice::time),
+        field("markPrice", &futures::MarkPrice::markPrice),
+        field("indexPrice", &futures::MarkPrice::indexPrice),
+        field("estimatedSettlePrice", &futures::MarkPrice::estimatedSettlePrice),
+        field("lastFundingRate", &futures::MarkPrice::lastFundingRate),
+        field("interestRate", &futures::MarkPrice::interestRate)
+    };
+};
+
+template<>
+struct ModelFields<futures::Asset> {
+    static constexpr std::tuple FIELDS{
+        field("asset", &futures::Asset::asset),
+        field("walletBalance", &futures::Asset::walletBalance),
+        field("unrealizedProfit", &futures::Asset::unrealizedProfit),
+        field("marginBalance", &futures::Asset::marginBalance),
+        field("maintMargin", &futures::Asset::maintMargin),
+        field("initialMargin", &futures::Asset::initialMargin),
+        field("positionInitialMargin", &futures::Asset::positionInitialMargin),
+        field("openOrderInitialMargin", &futures::Asset::openOrderInitialMargin),
+        field("crossWalletBalance", &futures::Asset::crossWalletBalance),
+        field("crossUnPnl", &futures::Asset::crossUnPnl),
+        field("availableBalance", &futures::Asset::availableBalance),
+        field("maxWithdrawAmount", &futures::Asset::maxWithdrawAmount),
+        field("marginAvailable", &futures::Asset::marginAvailable),
+        field("updateTime", &futures::Asset::updateTime),
+        field("autoAssetExchange", &futures::Asset::autoAssetExchange)
+    };
+};
+
+template<>
+struct ModelFields<futures::AccountBalance> {
+    static constexpr std::tuple FIELDS{
+        field("accountAlias", &futures::AccountBalance::accountAlias),
+        field("asset", &futures::AccountBalance::asset),
+        field("balance", &futures::AccountBalance::balance),
+        field("crossWalletBalance", &futures::AccountBalance::crossWalletBalance),
+        field("crossUnPnl", &futures::AccountBalance::crossUnPnl),
+        field("availableBalance", &futures::AccountBalance::availableBalance),
+        field("maxWithdrawAmount", &futures::AccountBalance::maxWithdrawAmount),
+        field("marginAvailable", &futures::AccountBalance::marginAvailable),
+        field("updateTime", &futures::AccountBalance::updateTime)
+    };
+};
+
+template<>
+struct ModelFields<futures::Filter> {
+    static constexpr std::tuple FIELDS{
+        field("filterType", &futures::Filter::filterType),
+        field("maxPrice", &futures::Filter::maxPrice),
+        field("minPrice", &futures::Filter::minPrice),
+        field("tickSize", &futures::Filter::tickSize),
+        field("minQty", &futures::Filter::minQty),
+        field("maxQty", &futures::Filter::maxQty),
+        field("stepSize", &futures::Filter::stepSize),
+        field("limit", &futures::Filter::limit),
+        field("multiplierUp", &futures::Filter::multiplierUp),
+        field("multiplierDown", &futures::Filter::multiplierDown),
+        field("multiplierDecimal", &futures::Filter::multiplierDecimal),
+        field("notional", &futures::Filter::notional)
+    };
+};
+
+template<>
+struct ModelFields<futures::Income> {
+    static constexpr std::tuple FIELDS{
+        field("symbol", &futures::Income::symbol),
+        field("incomeType", &futures::Income::incomeType),
+        field("income", &futures::Income::income),
+        field("asset", &futures::Income::asset),
+        field("info", &futures::Income::info),
+        field("time", &futures::Income::time),
+        field("tranId", &futures::Income::tranId),
+        field("tradeId", &futures::Income::tradeId)
+    };
+};
+}
+
 namespace stonky::binance::futures {
 
 nlohmann::json FundingRate::toJson() const {
-    throw std::runtime_error("Unimplemented: FundingRate::toJson()");
+    return writeFields(*this);
 }
 
 void FundingRate::fromJson(const nlohmann::json &json) {
-    readValue<std::string>(json, "symbol", symbol);
-    readValue<std::int64_t>(json, "fundingTime", fundingTime);
-    fundingRate = readStringAsDouble(json, "fundingRate");
+    readFields(json, *this);
 }
 
 nlohmann::json FundingRates::toJson() const {
@@ -139,41 +255,57 @@ void FundingRates::fromJson(const nlohmann::json &json) {
 }
 
 nlohmann::json TickerPrice::toJson() const {
-    throw std::runtime_error("Unimplemented: TickerPrice::toJson()");
+    return writeFields(*this);
 }
 
 void TickerPrice::fromJson(const nlohmann::json &json) {
-    readValue<std::string>(json, "symbol", symbol);
-    price = readStringAsDouble(json, "price");
-    readValue<std::int64_t>(json, "time", time);
+    readFields(json, *this);
+}
+
+nlohmann::json TickerPrices::toJson() const {
+    throw std::runtime_error("Unimplemented: TickerPrices::toJson()");
+}
+
+void TickerPrices::fromJson(const nlohmann::json &json) {
+    tickerPrices.clear();
+    tickerPrices.reserve(json.size());
+
+    for (const auto &el: json) {
+        TickerPrice tickerPrice;
+        tickerPrice.fromJson(el);
+        tickerPrices.insert_or_assign(tickerPrice.symbol, std::move(tickerPrice));
+    }
 }
 
 nlohmann::json BookTickerPrice::toJson() const {
-    throw std::runtime_error("Unimplemented: BookTickerPrice::toJson()");
+    return writeFields(*this);
 }
 
 void BookTickerPrice::fromJson(const nlohmann::json &json) {
-    readValue<std::string>(json, "symbol", symbol);
-    bidPrice = readStringAsDouble(json, "bidPrice");
-    askPrice = readStringAsDouble(json, "askPrice");
-    bidQty = readStringAsDouble(json, "bidQty");
-    askQty = readStringAsDouble(json, "askQty");
-    readValue<std::int64_t>(json, "time", time);
+    readFields(json, *this);
+}
+
+nlohmann::json BookTickerPrices::toJson() const {
+    throw std::runtime_error("Unimplemented: BookTickerPrices::toJson()");
+}
+
+void BookTickerPrices::fromJson(const nlohmann::json &json) {
+    bookTickerPrices.clear();
+    bookTickerPrices.reserve(json.size());
+
+    for (const auto &el: json) {
+        BookTickerPrice bookTickerPrice;
+        bookTickerPrice.fromJson(el);
+        bookTickerPrices.insert_or_assign(bookTickerPrice.symbol, std::move(bookTickerPrice));
+    }
 }
 
 nlohmann::json MarkPrice::toJson() const {
-    throw std::runtime_error("Unimplemented: MarkPrice::toJson()");
+    return writeFields(*this);
 }
 
 void MarkPrice::fromJson(const nlohmann::json &json) {
-    readValue<std::string>(json, "symbol", symbol);
-    readValue<std::int64_t>(json, "nextFundingTime", nextFundingTime);
-    readValue<std::int64_t>(json, "time", time);
-    markPrice = readStringAsDouble(json, "markPrice");
-    indexPrice = readStringAsDouble(json, "indexPrice");
-    estimatedSettlePrice = readStringAsDouble(json, "estimatedSettlePrice");
-    lastFundingRate = readStringAsDouble(json, "lastFundingRate");
-    interestRate = readStringAsDouble(json, "interestRate");
+    readFields(json, *this);
 }
 
 nlohmann::json MarkPrices::toJson() const {
@@ -191,25 +323,11 @@ void MarkPrices::fromJson(const nlohmann::json &json) {
 }
 
 nlohmann::json Asset::toJson() const {
-    throw std::runtime_error("Unimplemented: Asset::toJson()");
+    return writeFields(*this);
 }
 
 void Asset::fromJson(const nlohmann::json &json) {
-    readValue<std::string>(json, "asset", asset);
-    walletBalance = readStringAsDouble(json, "walletBalance");
-    unrealizedProfit = readStringAsDouble(json, "unrealizedProfit");
-    marginBalance = readStringAsDouble(json, "marginBalance");
-    maintMargin = readStringAsDouble(json, "maintMargin");
-    initialMargin = readStringAsDouble(json, "initialMargin");
-    positionInitialMargin = readStringAsDouble(json, "positionInitialMargin");
-    openOrderInitialMargin = readStringAsDouble(json, "openOrderInitialMargin");
-    crossWalletBalance = readStringAsDouble(json, "crossWalletBalance");
-    crossUnPnl = readStringAsDouble(json, "crossUnPnl");
-    availableBalance = readStringAsDouble(json, "availableBalance");
-    maxWithdrawAmount = readStringAsDouble(json, "maxWithdrawAmount");
-    readValue<bool>(json, "marginAvailable", marginAvailable);
-    readValue<int64_t>(json, "updateTime", updateTime);
-    autoAssetExchange = readStringAsDouble(json, "autoAssetExchange");
+    readFields(json, *this);
 }
 
 nlohmann::json Account::toJson() const {
@@ -222,17 +340,17 @@ void Account::fromJson(const nlohmann::json &json) {
     readValue<bool>(json, "canDeposit", canDeposit);
     readValue<bool>(json, "canWithdraw", canWithdraw);
     readValue<int64_t>(json, "updateTime", updateTime);
-    totalInitialMargin = readStringAsDouble(json, "totalInitialMargin");
-    totalMaintMargin = readStringAsDouble(json, "totalMaintMargin");
-    totalWalletBalance = readStringAsDouble(json, "totalWalletBalance");
-    totalUnrealizedProfit = readStringAsDouble(json, "totalUnrealizedProfit");
-    totalMarginBalance = readStringAsDouble(json, "totalMarginBalance");
-    totalPositionInitialMargin = readStringAsDouble(json, "totalPositionInitialMargin");
-    totalOpenOrderInitialMargin = readStringAsDouble(json, "totalOpenOrderInitialMargin");
-    totalCrossWalletBalance = readStringAsDouble(json, "totalCrossWalletBalance");
-    totalCrossUnPnl = readStringAsDouble(json, "totalCrossUnPnl");
-    availableBalance = readStringAsDouble(json, "availableBalance");
-    maxWithdrawAmount = readStringAsDouble(json, "maxWithdrawAmount");
+    totalInitialMargin = readDecimal(json, "totalInitialMargin");
+    totalMaintMargin = readDecimal(json, "totalMaintMargin");
+    totalWalletBalance = readDecimal(json, "totalWalletBalance");
+    totalUnrealizedProfit = readDecimal(json, "totalUnrealizedProfit");
+    totalMarginBalance = readDecimal(json, "totalMarginBalance");
+    totalPositionInitialMargin = readDecimal(json, "totalPositionInitialMargin");
+    totalOpenOrderInitialMargin = readDecimal(json, "totalOpenOrderInitialMargin");
+    totalCrossWalletBalance = readDecimal(json, "totalCrossWalletBalance");
+    totalCrossUnPnl = readDecimal(json, "totalCrossUnPnl");
+    availableBalance = readDecimal(json, "availableBalance");
+    maxWithdrawAmount = readDecimal(json, "maxWithdrawAmount");
     readValue<int>(json, "tradeGroupId", tradeGroupId);
 
     assets.clear();
@@ -245,19 +363,11 @@ void Account::fromJson(const nlohmann::json &json) {
 }
 
 nlohmann::json AccountBalance::toJson() const {
-    throw std::runtime_error("Unimplemented: AccountBalance::toJson()");
+    return writeFields(*this);
 }
 
 void AccountBalance::fromJson(const nlohmann::json &json) {
-    readValue<std::string>(json, "accountAlias", accountAlias);
-    readValue<std::string>(json, "asset", asset);
-    balance = readStringAsDouble(json, "balance");
-    crossWalletBalance = readStringAsDouble(json, "crossWalletBalance");
-    crossUnPnl = readStringAsDouble(json, "crossUnPnl");
-    availableBalance = readStringAsDouble(json, "availableBalance");
-    maxWithdrawAmount = readStringAsDouble(json, "maxWithdrawAmount");
-    readValue<bool>(json, "marginAvailable", marginAvailable);
-    readValue<std::int64_t>(json, "updateTime", updateTime);
+    readFields(json, *this);
 }
 
 nlohmann::json Order::toJson() const {
@@ -280,23 +390,23 @@ nlohmann::json Order::toJson() const {
 
     if (type == OrderType::LIMIT) {
         json["timeInForce"] = magic_enum::enum_name(timeInForce);
-        json["quantity"] = formatDouble(quantityPrecision, quantity);
-        json["price"] = formatDouble(pricePrecision, price);
+        json["quantity"] = exactQuantity ? exactQuantity->toString() : formatDouble(quantityPrecision, quantity);
+        json["price"] = exactPrice ? exactPrice->toString() : formatDouble(pricePrecision, price);
     } else if (type == OrderType::MARKET) {
-        json["quantity"] = formatDouble(quantityPrecision, quantity);
+        json["quantity"] = exactQuantity ? exactQuantity->toString() : formatDouble(quantityPrecision, quantity);
     } else if (type == OrderType::STOP ||
                type == OrderType::TAKE_PROFIT) {
-        json["quantity"] = formatDouble(quantityPrecision, quantity);
-        json["price"] = formatDouble(pricePrecision, price);
+        json["quantity"] = exactQuantity ? exactQuantity->toString() : formatDouble(quantityPrecision, quantity);
+        json["price"] = exactPrice ? exactPrice->toString() : formatDouble(pricePrecision, price);
         json["stopPrice"] = formatDouble(pricePrecision, stopPrice);
     } else if (type == OrderType::STOP_MARKET ||
                type == OrderType::TAKE_PROFIT_MARKET) {
-        json["quantity"] = formatDouble(quantityPrecision, quantity);
+        json["quantity"] = exactQuantity ? exactQuantity->toString() : formatDouble(quantityPrecision, quantity);
         json["stopPrice"] = formatDouble(pricePrecision, stopPrice);
         json["priceProtect"] = fmt::format("{}", priceProtect);
         json["closePosition"] = fmt::format("{}", closePosition);
     } else if (type == OrderType::TRAILING_STOP_MARKET) {
-        json["quantity"] = formatDouble(quantityPrecision, quantity);
+        json["quantity"] = exactQuantity ? exactQuantity->toString() : formatDouble(quantityPrecision, quantity);
         json["callbackRate"] = std::to_string(callbackRate);
         json["activationPrice"] = formatDouble(pricePrecision, activationPrice);
     }
@@ -308,24 +418,24 @@ nlohmann::json Order::toJson() const {
 
 void Order::fromJson(const nlohmann::json &json) {
     readValue<std::string>(json, "symbol", symbol);
-    readMagicEnum<Side>(json, "side", side);
-    price = readStringAsDouble(json, "price");
-    readMagicEnum<PositionSide>(json, "positionSide", positionSide);
-    readMagicEnum<OrderType>(json, "type", type);
-    readMagicEnum<TimeInForce>(json, "timeInForce", timeInForce);
-    quantity = readStringAsDouble(json, "quantity");
+    readEnum(json, "side", side);
+    price = readDecimal(json, "price");
+    readEnum(json, "positionSide", positionSide);
+    readEnum(json, "type", type);
+    readEnum(json, "timeInForce", timeInForce);
+    quantity = readDecimal(json, "quantity");
     readValue<std::string>(json, "newClientOrderId", newClientOrderId);
-    stopPrice = readStringAsDouble(json, "stopPrice");
+    stopPrice = readDecimal(json, "stopPrice");
     readValue<int64_t>(json, "timestamp", timestamp);
     readValue<int64_t>(json, "orderId", orderId);
     readValue<bool>(json, "reduceOnly", reduceOnly);
     readValue<bool>(json, "closePosition", closePosition);
-    activationPrice = readStringAsDouble(json, "activationPrice");
-    callbackRate = readStringAsDouble(json, "callbackRate");
-    readMagicEnum<WorkingType>(json, "workingType", workingType);
+    activationPrice = readDecimal(json, "activationPrice");
+    callbackRate = readDecimal(json, "callbackRate");
+    readEnum(json, "workingType", workingType);
     readValue<bool>(json, "priceProtect", priceProtect);
-    readMagicEnum<OrderRespType>(json, "newOrderRespType", newOrderRespType);
-    readMagicEnum<SelfTradePreventionMode>(json, "selfTradePreventionMode", selfTradePreventionMode);
+    readEnum(json, "newOrderRespType", newOrderRespType);
+    readEnum(json, "selfTradePreventionMode", selfTradePreventionMode);
 }
 
 nlohmann::json OrderResponse::toJson() const {
@@ -348,13 +458,13 @@ void OrderResponse::fromJson(const nlohmann::json &json) {
 
     readValue<int64_t>(json, "orderId", orderId);
     readValue<std::string>(json, "clientOrderId", clientOrderId);
-    readMagicEnum<OrderStatus>(json, "status", orderStatus);
-    avgPrice = readStringAsDouble(json, "avgPrice");
-    origQty = readStringAsDouble(json, "origQty");
-    executedQty = readStringAsDouble(json, "executedQty");
-    cumQty = readStringAsDouble(json, "cumQty");
-    cumQuote = readStringAsDouble(json, "cumQuote");
-    readMagicEnum<OrderType>(json, "origType", origType);
+    readEnum(json, "status", orderStatus);
+    avgPrice = readDecimal(json, "avgPrice");
+    origQty = readDecimal(json, "origQty");
+    executedQty = readDecimal(json, "executedQty");
+    cumQty = readDecimal(json, "cumQty");
+    cumQuote = readDecimal(json, "cumQuote");
+    readEnum(json, "origType", origType);
     readValue<int>(json, "code", errCode);
     readValue<std::string>(json, "msg", errMsg);
 }
@@ -378,42 +488,51 @@ nlohmann::json Position::toJson() const {
 }
 
 void Position::fromJson(const nlohmann::json &json) {
-    entryPrice = readStringAsDouble(json, "entryPrice");
+    entryPrice = readDecimal(json, "entryPrice");
     readValue<std::string>(json, "marginType", marginType);
 
     std::string isAutoAddMarginStr;
     readValue<std::string>(json, "isAutoAddMargin", isAutoAddMarginStr);
     isAutoAddMargin = string2bool(isAutoAddMarginStr);
 
-    isolatedMargin = readStringAsDouble(json, "isolatedMargin");
-    leverage = readStringAsDouble(json, "leverage");
-    liquidationPrice = readStringAsDouble(json, "liquidationPrice");
-    markPrice = readStringAsDouble(json, "markPrice");
-    maxNotionalValue = readStringAsDouble(json, "maxNotionalValue");
-    positionAmt = readStringAsDouble(json, "positionAmt");
+    isolatedMargin = readDecimal(json, "isolatedMargin");
+    leverage = readDecimal(json, "leverage");
+    liquidationPrice = readDecimal(json, "liquidationPrice");
+    markPrice = readDecimal(json, "markPrice");
+    maxNotionalValue = readDecimal(json, "maxNotionalValue");
+    positionAmt = readDecimal(json, "positionAmt");
     readValue<std::string>(json, "symbol", symbol);
-    unRealizedProfit = readStringAsDouble(json, "unRealizedProfit");
-    readMagicEnum<PositionSide>(json, "positionSide", positionSide);
+    unRealizedProfit = readDecimal(json, "unRealizedProfit");
+    readEnum(json, "positionSide", positionSide);
     readValue<std::int64_t>(json, "updateTime", updateTime);
 }
 
 nlohmann::json Filter::toJson() const {
-    throw std::runtime_error("Unimplemented: Filter::toJson()");
+    return writeFields(*this);
+}
+
+static Decimal readExactDecimal(const nlohmann::json &json, const std::string &key) {
+    const auto it = json.find(key);
+
+    if (it == json.end()) {
+        return {};
+    }
+
+    if (it->is_string()) {
+        return Decimal::fromString(it->get_ref<const std::string &>());
+    }
+
+    if (it->is_number()) {
+        return Decimal::fromDouble(it->get<double>(), Decimal::BINANCE_SCALE);
+    }
+
+    return {};
 }
 
 void Filter::fromJson(const nlohmann::json &json) {
-    readMagicEnum<SymbolFilter>(json, "filterType", filterType);
-    maxPrice = readStringAsDouble(json, "maxPrice");
-    minPrice = readStringAsDouble(json, "minPrice");
-    tickSize = readStringAsDouble(json, "tickSize");
-    minQty = readStringAsDouble(json, "minQty");
-    maxQty = readStringAsDouble(json, "maxQty");
-    stepSize = readStringAsDouble(json, "stepSize");
-    readValue<int64_t>(json, "limit", limit);
-    multiplierUp = readStringAsDouble(json, "multiplierUp");
-    multiplierDown = readStringAsDouble(json, "multiplierDown");
-    multiplierDecimal = readStringAsDouble(json, "multiplierDecimal");
-    notional = readStringAsDouble(json, "notional");
+    readFields(json, *this);
+    exactTickSize = readExactDecimal(json, "tickSize");
+    exactStepSize = readExactDecimal(json, "stepSize");
 }
 
 nlohmann::json Symbol::toJson() const {
@@ -426,9 +545,9 @@ void Symbol::fromJson(const nlohmann::json &json) {
     readValue<std::string>(json, "contractType", contractType);
     readValue<int64_t>(json, "deliveryDate", deliveryDate);
     readValue<int64_t>(json, "onboardDate", onboardDate);
-    readMagicEnum<ContractStatus>(json, "status", status);
-    maintMarginPercent = readStringAsDouble(json, "maintMarginPercent");
-    requiredMarginPercent = readStringAsDouble(json, "requiredMarginPercent");
+    readEnum(json, "status", status);
+    maintMarginPercent = readDecimal(json, "maintMarginPercent");
+    requiredMarginPercent = readDecimal(json, "requiredMarginPercent");
     readValue<std::string>(json, "baseAsset", baseAsset);
     readValue<std::string>(json, "quoteAsset", quoteAsset);
     readValue<std::string>(json, "marginAsset", marginAsset);
@@ -451,7 +570,52 @@ void Symbol::fromJson(const nlohmann::json &json) {
     }
 
     readValue<int64_t>(json, "settlePlan", settlePlan);
-    triggerProtect = readStringAsDouble(json, "triggerProtect");
+    triggerProtect = readDecimal(json, "triggerProtect");
+}
+
+Decimal Symbol::toPrice(const std::string_view price) const {
+    return Decimal::fromString(price, pricePrecision);
+}
+
+Decimal Symbol::toPrice(const double price) const {
+    return Decimal::fromDouble(price, pricePrecision);
+}
+
+Decimal Symbol::toQuantity(const std::string_view quantity) const {
+    return Decimal::fromString(quantity, quantityPrecision);
+}
+
+Decimal Symbol::toQuantity(const double quantity) const {
+    return Decimal::fromDouble(quantity, quantityPrecision);
+}
+
+static Decimal filterStep(const Decimal &exactStep, const double step) {
+    if (exactStep.value() > 0) {
+        return exactStep;
+    }
+
+    return Decimal::fromDouble(step, Decimal::BINANCE_SCALE);
+}
+
+Decimal Symbol::roundPrice(const Decimal &price) const {
+    for (const auto &filter: filters) {
+        if (filter.filterType == SymbolFilter::PRICE_FILTER && filter.tickSize > 0.0) {
+            return price.roundToStep(filterStep(filter.exactTickSize, filter.tickSize)).rescale(pricePrecision);
+        }
+    }
+
+    return price.rescale(pricePrecision);
+}
+
+Decimal Symbol::truncateQuantity(const Decimal &quantity) const {
+    for (const auto &filter: filters) {
+        if (filter.filterType == SymbolFilter::LOT_SIZE && filter.stepSize > 0.0) {
+            return quantity.truncateToStep(filterStep(filter.exactStepSize, filter.stepSize)).rescale(
+                quantityPrecision);
+        }
+    }
+
+    return quantity.truncateToStep(Decimal(1, quantityPrecision));
 }
 
 nlohmann::json Exchange::toJson() const {
@@ -495,18 +659,11 @@ void DownloadId::fromJson(const nlohmann::json &json) {
 }
 
 nlohmann::json Income::toJson() const {
-    throw std::runtime_error("Unimplemented: Income::toJson()");
+    return writeFields(*this);
 }
 
 void Income::fromJson(const nlohmann::json &json) {
-    readValue<std::string>(json, "symbol", symbol);
-    readMagicEnum<IncomeType>(json, "incomeType", incomeType);
-    income = readStringAsDouble(json, "income");
-    readValue<std::string>(json, "asset", asset);
-    readValue<std::string>(json, "info", info);
-    readValue<int64_t>(json, "time", time);
-    readValue<int64_t>(json, "tranId", tranId);
-    readValue<std::string>(json, "tradeId", tradeId);
+    readFields(json, *this);
 }
 
 nlohmann::json Incomes::toJson() const {
@@ -545,25 +702,39 @@ nlohmann::json PositionRisk::toJson() const {
     return json;
 }
 
+/**
+ * positionRisk sends the margin type in lowercase, i.e. "cross" or "isolated", the value is unchanged when unknown
+ */
+static void readMarginType(const nlohmann::json &json, const std::string &key, MarginType &marginType) {
+    std::string value;
+    readValue<std::string>(json, key, value);
+
+    if (boost::algorithm::iequals(value, "cross") || boost::algorithm::iequals(value, "crossed")) {
+        marginType = MarginType::CROSS;
+    } else if (boost::algorithm::iequals(value, "isolated")) {
+        marginType = MarginType::ISOLATED;
+    }
+}
+
 void PositionRisk::fromJson(const nlohmann::json &json) {
     readValue<std::string>(json, "symbol", symbol);
-    entryPrice = readStringAsDouble(json, "entryPrice");
-    readMagicEnum<MarginType>(json, "marginType", marginType);
+    entryPrice = readDecimal(json, "entryPrice");
+    readMarginType(json, "marginType", marginType);
 
     std::string isAutoAddMarginStr;
     readValue<std::string>(json, "isAutoAddMargin", isAutoAddMarginStr);
     isAutoAddMargin = string2bool(isAutoAddMarginStr);
 
-    isolatedMargin = readStringAsDouble(json, "isolatedMargin");
+    isolatedMargin = readDecimal(json, "isolatedMargin");
     leverage = readStringAsInt(json, "leverage");
-    liquidationPrice = readStringAsDouble(json, "liquidationPrice");
-    markPrice = readStringAsDouble(json, "markPrice");
-    maxNotionalValue = readStringAsDouble(json, "maxNotionalValue");
-    positionAmt = readStringAsDouble(json, "positionAmt");
-    notional = readStringAsDouble(json, "notional");
-    isolatedWallet = readStringAsDouble(json, "isolatedWallet");
-    unRealizedProfit = readStringAsDouble(json, "unRealizedProfit");
-    readMagicEnum<PositionSide>(json, "positionSide", positionSide);
+    liquidationPrice = readDecimal(json, "liquidationPrice");
+    markPrice = readDecimal(json, "markPrice");
+    maxNotionalValue = readDecimal(json, "maxNotionalValue");
+    positionAmt = readDecimal(json, "positionAmt");
+    notional = readDecimal(json, "notional");
+    isolatedWallet = readDecimal(json, "isolatedWallet");
+    unRealizedProfit = readDecimal(json, "unRealizedProfit");
+    readEnum(json, "positionSide", positionSide);
     readValue<std::int64_t>(json, "updateTime", updateTime);
 }
 
@@ -573,19 +744,31 @@ nlohmann::json OpenInterest::toJson() const {
 
 void OpenInterest::fromJson(const nlohmann::json &json) {
     readValue<std::string>(json, "symbol", symbol);
-    openInterest = readStringAsDouble(json, "openInterest");
+    openInterest = readDecimal(json, "openInterest");
     readValue<std::int64_t>(json, "time", time);
 }
 
+nlohmann::json OrderBookSnapshot::toJson() const {
+    throw std::runtime_error("Unimplemented: OrderBookSnapshot::toJson()");
+}
+
+void OrderBookSnapshot::fromJson(const nlohmann::json &json) {
+    readValue<std::int64_t>(json, "lastUpdateId", lastUpdateId);
+    readValue<std::int64_t>(json, "E", E);
+    readValue<std::int64_t>(json, "T", T);
+    readOrderBookLevels(json, "bids", bids);
+    readOrderBookLevels(json, "asks", asks);
+}
+
 nlohmann::json LongShortRatio::toJson() const {
     throw std::runtime_error("Unimplemented: LongShortRatio::toJson()");
 }
 
 void LongShortRatio::fromJson(const nlohmann::json &json) {
     readValue<std::string>(json, "symbol", symbol);
-    longShortRatio = readStringAsDouble(json, "longShortRatio");
-    longAccount = readStringAsDouble(json, "longAccount");
-    shortAccount = readStringAsDouble(json, "shortAccount");
+    longShortRatio = readDecimal(json, "longShortRatio");
+    longAccount = readDecimal(json, "longAccount");
+    shortAccount = readDecimal(json, "shortAccount");
     readValue<std::int64_t>(json, "timestamp", timestamp);
 }
 
@@ -595,8 +778,8 @@ nlohmann::json OpenInterestStatistics::toJson() const {
 
 void OpenInterestStatistics::fromJson(const nlohmann::json &json) {
     readValue<std::string>(json, "symbol", symbol);
-    sumOpenInterest = readStringAsDouble(json, "sumOpenInterest");
-    sumOpenInterestValue = readStringAsDouble(json, "sumOpenInterestValue");
+    sumOpenInterest = readDecimal(json, "sumOpenInterest");
+    sumOpenInterestValue = readDecimal(json, "sumOpenInterestValue");
     readValue<std::int64_t>(json, "timestamp", timestamp);
 }
 
@@ -605,9 +788,49 @@ nlohmann::json BuySellVolume::toJson() const {
 }
 
 void BuySellVolume::fromJson(const nlohmann::json &json) {
-    buySellRatio = readStringAsDouble(json, "buySellRatio");
-    buyVol = readStringAsDouble(json, "buyVol");
-    sellVol = readStringAsDouble(json, "sellVol");
+    buySellRatio = readDecimal(json, "buySellRatio");
+    buyVol = readDecimal(json, "buyVol");
+    sellVol = readDecimal(json, "sellVol");
     readValue<std::int64_t>(json, "timestamp", timestamp);
 }
+
+void OpenInterestStatisticsSeries::reserve(const std::size_t size) {
+    timestamp.reserve(size);
+    sumOpenInterest.reserve(size);
+    sumOpenInterestValue.reserve(size);
+}
+
+void OpenInterestStatisticsSeries::push_back(const OpenInterestStatistics &statistics) {
+    timestamp.push_back(statistics.timestamp);
+    sumOpenInterest.push_back(statistics.sumOpenInterest);
+    sumOpenInterestValue.push_back(statistics.sumOpenInterestValue);
+}
+
+void LongShortRatioSeries::reserve(const std::size_t size) {
+    timestamp.reserve(size);
+    longShortRatio.reserve(size);
+    longAccount.reserve(size);
+    shortAccount.reserve(size);
+}
+
+void LongShortRatioSeries::push_back(const LongShortRatio &ratio) {
+    timestamp.push_back(ratio.timestamp);
+    longShortRatio.push_back(ratio.longShortRatio);
+    longAccount.push_back(ratio.longAccount);
+    shortAccount.push_back(ratio.shortAccount);
+}
+
+void BuySellVolumeSeries::reserve(const std::size_t size) {
+    timestamp.reserve(size);
+    buySellRatio.reserve(size);
+    buyVol.reserve(size);
+    sellVol.reserve(size);
+}
+
+void BuySellVolumeSeries::push_back(const BuySellVolume &volume) {
+    timestamp.push_back(volume.timestamp);
+    buySellRatio.push_back(volume.buySellRatio);
+    buyVol.push_back(volume.buyVol);
+    sellVol.push_back(volume.sellVol);
+}
 }
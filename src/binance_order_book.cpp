@@ -0,0 +1,173 @@
+/**
+Binance Futures Local Order Book
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_order_book.h"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace stonky::binance::futures {
+/**
+ * @param compare order of the side, the best price is the last one
+ * @return first level not before the price
+ */
+template<typename Levels, typename Compare>
+static auto findLevel(Levels &levels, const double price, Compare compare) {
+    return std::lower_bound(levels.begin(), levels.end(), price, [&](const OrderBookLevel &level, const double p) {
+        return compare(level.price, p);
+    });
+}
+
+template<typename Compare>
+static void updateLevels(std::vector<OrderBookLevel> &levels, const std::vector<OrderBookLevel> &changes,
+                         Compare compare) {
+    for (const auto &change: changes) {
+        const auto it = findLevel(levels, change.price, compare);
+        const bool found = it != levels.end() && it->price == change.price;
+
+        if (change.quantity == 0.0) {
+            /// Removal of an unknown level is normal, the level may be deeper than the snapshot
+            if (found) {
+                levels.erase(it);
+            }
+        } else if (found) {
+            it->quantity = change.quantity;
+        } else {
+            levels.insert(it, change);
+        }
+    }
+}
+
+template<typename Compare>
+static double levelQuantity(const std::vector<OrderBookLevel> &levels, const double price, Compare compare) {
+    const auto it = findLevel(levels, price, compare);
+    return it != levels.end() && it->price == price ? it->quantity : 0.0;
+}
+
+static const OrderBookLevel &levelFromTop(const std::vector<OrderBookLevel> &levels, const std::size_t level) {
+    if (level >= levels.size()) {
+        throw std::out_of_range("Order book level out of range: " + std::to_string(level));
+    }
+
+    return levels[levels.size() - 1 - level];
+}
+
+static std::vector<OrderBookLevel> topLevels(const std::vector<OrderBookLevel> &levels, const std::size_t depth) {
+    const auto count = depth == 0 ? levels.size() : std::min(depth, levels.size());
+    return {levels.rbegin(), levels.rbegin() + static_cast<std::ptrdiff_t>(count)};
+}
+
+OrderBook::OrderBook(std::string symbol) : m_symbol(std::move(symbol)) {
+}
+
+bool OrderBook::applyEvent(const EventDepthUpdate &event) {
+    if (m_awaitingFirstEvent) {
+        if (event.u < m_lastUpdateId) {
+            /// Already contained in the snapshot
+            return true;
+        }
+
+        if (event.U > m_lastUpdateId) {
+            return false;
+        }
+    } else if (event.u <= m_lastUpdateId) {
+        /// Repeated event
+        return true;
+    } else if (event.pu != m_lastUpdateId) {
+        return false;
+    }
+
+    updateLevels(m_bids, event.b, std::less<>());
+    updateLevels(m_asks, event.a, std::greater<>());
+    m_lastUpdateId = event.u;
+    m_updateTime = event.E;
+    m_transactionTime = event.T;
+    m_awaitingFirstEvent = false;
+    return true;
+}
+
+void OrderBook::unsync() {
+    m_bids.clear();
+    m_asks.clear();
+    m_lastUpdateId = -1;
+    m_synced = false;
+    m_awaitingFirstEvent = false;
+}
+
+bool OrderBook::applySnapshot(const OrderBookSnapshot &snapshot) {
+    /// Snapshot levels are ordered from the best price, the book keeps the best one last
+    m_bids.assign(snapshot.bids.rbegin(), snapshot.bids.rend());
+    m_asks.assign(snapshot.asks.rbegin(), snapshot.asks.rend());
+    m_lastUpdateId = snapshot.lastUpdateId;
+    m_updateTime = snapshot.E;
+    m_transactionTime = snapshot.T;
+    m_synced = true;
+    m_awaitingFirstEvent = true;
+
+    while (!m_buffer.empty()) {
+        if (!applyEvent(m_buffer.front())) {
+            /// Events from the failed one on wait for the next snapshot
+            unsync();
+            return false;
+        }
+
+        m_buffer.pop_front();
+    }
+
+    return true;
+}
+
+bool OrderBook::applyUpdate(const EventDepthUpdate &event) {
+    if (m_synced && applyEvent(event)) {
+        return true;
+    }
+
+    if (m_synced) {
+        unsync();
+    }
+
+    m_buffer.push_back(event);
+
+    if (m_buffer.size() > MAX_BUFFERED_EVENTS) {
+        m_buffer.pop_front();
+    }
+
+    return m_buffer.size() > 1;
+}
+
+void OrderBook::reset() {
+    unsync();
+    m_buffer.clear();
+}
+
+const OrderBookLevel &OrderBook::bid(const std::size_t level) const {
+    return levelFromTop(m_bids, level);
+}
+
+const OrderBookLevel &OrderBook::ask(const std::size_t level) const {
+    return levelFromTop(m_asks, level);
+}
+
+double OrderBook::bidQuantity(const double price) const {
+    return levelQuantity(m_bids, price, std::less<>());
+}
+
+double OrderBook::askQuantity(const double price) const {
+    return levelQuantity(m_asks, price, std::greater<>());
+}
+
+OrderBookSnapshot OrderBook::snapshot(const std::size_t depth) const {
+    OrderBookSnapshot retVal;
+    retVal.lastUpdateId = m_lastUpdateId;
+    retVal.E = m_updateTime;
+    retVal.T = m_transactionTime;
+    retVal.bids = topLevels(m_bids, depth);
+    retVal.asks = topLevels(m_asks, depth);
+    return retVal;
+}
+}
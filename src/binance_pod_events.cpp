@@ -0,0 +1,126 @@
+/**
+Binance Compact Market Data Events
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_pod_events.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace stonky::binance::futures {
+FixedSymbol::FixedSymbol(const std::string_view symbol) {
+    if (symbol.size() > CAPACITY) {
+        throw std::invalid_argument("Symbol too long: " + std::string(symbol));
+    }
+
+    std::ranges::copy(symbol, chars.begin());
+}
+
+std::string_view FixedSymbol::view() const {
+    return {chars.data(), static_cast<std::size_t>(std::ranges::find(chars, '\0') - chars.begin())};
+}
+
+PodEventTickPrice toPod(const EventTickPrice &event) {
+    PodEventTickPrice retVal;
+    retVal.s = FixedSymbol(event.s);
+    retVal.E = event.E;
+    retVal.T = event.T;
+    retVal.u = event.u;
+    retVal.b = event.b;
+    retVal.B = event.B;
+    retVal.a = event.a;
+    retVal.A = event.A;
+    return retVal;
+}
+
+PodEventAggregatedTrade toPod(const EventAggregatedTrade &event) {
+    PodEventAggregatedTrade retVal;
+    retVal.s = FixedSymbol(event.s);
+    retVal.E = event.E;
+    retVal.T = event.T;
+    retVal.a = event.a;
+    retVal.f = event.f;
+    retVal.l = event.l;
+    retVal.p = event.p;
+    retVal.q = event.q;
+    retVal.m = event.m;
+    return retVal;
+}
+
+PodEventCandlestick toPod(const EventCandlestick &event) {
+    PodEventCandlestick retVal;
+    retVal.s = FixedSymbol(event.s);
+    retVal.E = event.E;
+    retVal.t = event.k.t;
+    retVal.T = event.k.T;
+    retVal.f = event.k.f;
+    retVal.L = event.k.L;
+    retVal.n = event.k.n;
+    retVal.o = event.k.o;
+    retVal.h = event.k.h;
+    retVal.l = event.k.l;
+    retVal.c = event.k.c;
+    retVal.v = event.k.v;
+    retVal.q = event.k.q;
+    retVal.V = event.k.V;
+    retVal.Q = event.k.Q;
+    retVal.i = event.k.i;
+    retVal.x = event.k.x;
+    return retVal;
+}
+
+EventTickPrice fromPod(const PodEventTickPrice &event) {
+    EventTickPrice retVal;
+    retVal.s = event.s.view();
+    retVal.E = event.E;
+    retVal.T = event.T;
+    retVal.u = event.u;
+    retVal.b = event.b;
+    retVal.B = event.B;
+    retVal.a = event.a;
+    retVal.A = event.A;
+    return retVal;
+}
+
+EventAggregatedTrade fromPod(const PodEventAggregatedTrade &event) {
+    EventAggregatedTrade retVal;
+    retVal.e = EventType::aggTrade;
+    retVal.s = event.s.view();
+    retVal.E = event.E;
+    retVal.T = event.T;
+    retVal.a = event.a;
+    retVal.f = event.f;
+    retVal.l = event.l;
+    retVal.p = event.p;
+    retVal.q = event.q;
+    retVal.m = event.m;
+    return retVal;
+}
+
+EventCandlestick fromPod(const PodEventCandlestick &event) {
+    EventCandlestick retVal;
+    retVal.e = EventType::kline;
+    retVal.s = event.s.view();
+    retVal.E = event.E;
+    retVal.k.s = retVal.s;
+    retVal.k.t = event.t;
+    retVal.k.T = event.T;
+    retVal.k.f = event.f;
+    retVal.k.L = event.L;
+    retVal.k.n = event.n;
+    retVal.k.o = event.o;
+    retVal.k.h = event.h;
+    retVal.k.l = event.l;
+    retVal.k.c = event.c;
+    retVal.k.v = event.v;
+    retVal.k.q = event.q;
+    retVal.k.V = event.V;
+    retVal.k.Q = event.Q;
+    retVal.k.i = event.i;
+    retVal.k.x = event.x;
+    return retVal;
+}
+}
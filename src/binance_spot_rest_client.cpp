@@ -8,6 +8,7 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 
 #include "stonky/binance/binance_spot_rest_client.h"
 #include "stonky/binance/binance_http_session.h"
+#include "stonky/binance/binance_json_parser.h"
 #include "stonky/utils/json_utils.h"
 #include "stonky/utils/utils.h"
 #include <mutex>
@@ -51,7 +52,7 @@ public:
     }
 };
 
-http::response<http::string_body> checkResponse(const http::response<http::string_body> &response) {
+http::response<http::string_body> checkResponse(http::response<http::string_body> response) {
     if (response.result() != http::status::ok) {
         ErrorResponse errorResponse;
         errorResponse.fromJson(nlohmann::json::parse(response.body()));
@@ -100,7 +101,7 @@ RESTClient::P::getHistoricalPrices(const std::string &symbol, const CandleInterv
 
     auto response = checkResponse(httpSession->get(path, true));
     CandlesResponse candlesResponse;
-    candlesResponse.fromJson(nlohmann::json::parse(response.body()));
+    parseResponse(response.body(), candlesResponse);
 
     return candlesResponse.candles;
 }
@@ -151,7 +152,7 @@ RESTClient::getHistoricalPricesSingle(const std::string &symbol, const CandleInt
 
     auto response = checkResponse(m_p->httpSession->get(path, true));
     CandlesResponse candlesResponse;
-    candlesResponse.fromJson(nlohmann::json::parse(response.body()));
+    parseResponse(response.body(), candlesResponse);
 
     return candlesResponse.candles;
 }
@@ -0,0 +1,92 @@
+/**
+Binance Symbol Registry
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_symbol_registry.h"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace stonky::binance {
+/**
+ * Enables std::string_view lookups in std::string keyed maps without a temporary string
+ */
+struct SymbolHash {
+    using is_transparent = void;
+
+    std::size_t operator()(const std::string_view symbol) const {
+        return std::hash<std::string_view>{}(symbol);
+    }
+};
+
+struct SymbolRegistry::P {
+    mutable std::shared_mutex locker;
+    std::unordered_map<std::string, SymbolId, SymbolHash, std::equal_to<> > ids;
+    /// Elements of std::deque do not move on push_back, returned names stay valid
+    std::deque<std::string> names;
+
+    SymbolId insert(const std::string_view symbol) {
+        if (const auto it = ids.find(symbol); it != ids.end()) {
+            return it->second;
+        }
+
+        const auto symbolId = static_cast<SymbolId>(names.size());
+        names.emplace_back(symbol);
+        ids.emplace(names.back(), symbolId);
+        return symbolId;
+    }
+};
+
+SymbolRegistry::SymbolRegistry() : m_p(std::make_unique<P>()) {
+}
+
+SymbolRegistry::~SymbolRegistry() = default;
+
+SymbolRegistry &SymbolRegistry::instance() {
+    static SymbolRegistry registry;
+    return registry;
+}
+
+SymbolId SymbolRegistry::intern(const std::string_view symbol) const {
+    if (const auto symbolId = find(symbol)) {
+        return *symbolId;
+    }
+
+    std::unique_lock lk(m_p->locker);
+    return m_p->insert(symbol);
+}
+
+void SymbolRegistry::intern(const futures::Exchange &exchange) const {
+    std::unique_lock lk(m_p->locker);
+
+    for (const auto &symbol: exchange.symbols) {
+        m_p->insert(symbol.symbol);
+    }
+}
+
+std::optional<SymbolId> SymbolRegistry::find(const std::string_view symbol) const {
+    std::shared_lock lk(m_p->locker);
+
+    if (const auto it = m_p->ids.find(symbol); it != m_p->ids.end()) {
+        return it->second;
+    }
+
+    return std::nullopt;
+}
+
+std::string_view SymbolRegistry::name(const SymbolId symbolId) const {
+    std::shared_lock lk(m_p->locker);
+    return m_p->names.at(symbolId);
+}
+
+std::size_t SymbolRegistry::size() const {
+    std::shared_lock lk(m_p->locker);
+    return m_p->names.size();
+}
+}
@@ -0,0 +1,172 @@
+/**
+Binance Futures Aggregated Trade Buffer
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_trade_buffer.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+
+namespace stonky::binance::futures {
+/// Contents of a slot, copied word by word so that a concurrent read is not a data race
+struct TradeRecord {
+    PodEventAggregatedTrade trade{};
+    double cumulativeVolume{};
+    double cumulativeQuoteVolume{};
+};
+
+static_assert(std::is_trivially_copyable_v<TradeRecord> && sizeof(TradeRecord) % sizeof(std::uint64_t) == 0);
+
+static constexpr std::size_t RECORD_WORDS = sizeof(TradeRecord) / sizeof(std::uint64_t);
+
+/// Slots of consecutive trades do not share a cache line
+struct alignas(64) TradeSlot {
+    /// 2 * index + 1 while the trade of index is written, 2 * index + 2 once written, 0 if never written
+    std::atomic<std::uint64_t> sequence{0};
+    std::array<std::atomic<std::uint64_t>, RECORD_WORDS> words{};
+};
+
+struct TradeBuffer::P {
+    std::size_t capacity;
+    std::size_t mask;
+    std::unique_ptr<TradeSlot[]> slots;
+    std::atomic<std::uint64_t> head{0};
+    /// Writer only
+    double cumulativeVolume{};
+    double cumulativeQuoteVolume{};
+
+    explicit P(const std::size_t requestedCapacity) : capacity(std::bit_ceil(requestedCapacity)), mask(capacity - 1),
+                                                      slots(std::make_unique<TradeSlot[]>(capacity)) {
+    }
+
+    void write(const std::uint64_t index, const TradeRecord &record) {
+        auto &slot = slots[index & mask];
+        const auto words = std::bit_cast<std::array<std::uint64_t, RECORD_WORDS> >(record);
+
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < RECORD_WORDS; i++) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        slot.sequence.store(2 * index + 2, std::memory_order_release);
+    }
+
+    /**
+     * @return false if the trade of index is not written yet or was overwritten meanwhile
+     */
+    bool read(const std::uint64_t index, TradeRecord &record) const {
+        const auto &slot = slots[index & mask];
+        const auto expected = 2 * index + 2;
+
+        if (slot.sequence.load(std::memory_order_acquire) != expected) {
+            return false;
+        }
+
+        std::array<std::uint64_t, RECORD_WORDS> words{};
+
+        for (std::size_t i = 0; i < RECORD_WORDS; i++) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+            return false;
+        }
+
+        record = std::bit_cast<TradeRecord>(words);
+        return true;
+    }
+
+    /**
+     * @return index of the oldest trade still kept when head trades were pushed
+     */
+    [[nodiscard]] std::uint64_t oldest(const std::uint64_t head) const {
+        return head > capacity ? head - capacity : 0;
+    }
+};
+
+TradeBuffer::TradeBuffer(const std::size_t capacity) : m_p(std::make_unique<P>(capacity)) {
+}
+
+TradeBuffer::~TradeBuffer() = default;
+
+std::size_t TradeBuffer::capacity() const {
+    return m_p->capacity;
+}
+
+void TradeBuffer::push(const PodEventAggregatedTrade &trade) const {
+    const auto index = m_p->head.load(std::memory_order_relaxed);
+    m_p->cumulativeVolume += trade.q;
+    m_p->cumulativeQuoteVolume += trade.p * trade.q;
+    m_p->write(index, {trade, m_p->cumulativeVolume, m_p->cumulativeQuoteVolume});
+    m_p->head.store(index + 1, std::memory_order_release);
+}
+
+std::uint64_t TradeBuffer::size() const {
+    return m_p->head.load(std::memory_order_acquire);
+}
+
+std::size_t TradeBuffer::latest(const std::span<PodEventAggregatedTrade> trades) const {
+    const auto head = m_p->head.load(std::memory_order_acquire);
+    const auto available = static_cast<std::size_t>(head - m_p->oldest(head));
+    const auto count = std::min(trades.size(), available);
+    std::size_t retVal = 0;
+    TradeRecord record;
+
+    /// From the newest, a failed read means the writer has lapped the older trades too
+    while (retVal < count && m_p->read(head - 1 - retVal, record)) {
+        trades[retVal++] = record.trade;
+    }
+
+    std::reverse(trades.begin(), trades.begin() + static_cast<std::ptrdiff_t>(retVal));
+    return retVal;
+}
+
+std::vector<PodEventAggregatedTrade> TradeBuffer::latest(const std::size_t count) const {
+    std::vector<PodEventAggregatedTrade> retVal(std::min<std::size_t>(count, m_p->capacity));
+    retVal.resize(latest(std::span(retVal)));
+    return retVal;
+}
+
+TradeStatistics TradeBuffer::statistics(const std::int64_t startTime) const {
+    TradeStatistics retVal;
+    const auto head = m_p->head.load(std::memory_order_acquire);
+    TradeRecord last;
+
+    if (head == 0 || !m_p->read(head - 1, last) || last.trade.T < startTime) {
+        return retVal;
+    }
+
+    /// First kept trade not older than startTime, overwritten trades count as older
+    auto low = m_p->oldest(head);
+    auto high = head - 1;
+    TradeRecord first = last;
+
+    while (low < high) {
+        const auto middle = low + (high - low) / 2;
+        TradeRecord record;
+
+        if (m_p->read(middle, record) && record.trade.T >= startTime) {
+            high = middle;
+            first = record;
+        } else {
+            low = middle + 1;
+        }
+    }
+
+    retVal.count = static_cast<std::int64_t>(head - low);
+    retVal.volume = last.cumulativeVolume - first.cumulativeVolume + first.trade.q;
+    retVal.quoteVolume = last.cumulativeQuoteVolume - first.cumulativeQuoteVolume + first.trade.p * first.trade.q;
+    retVal.vwap = retVal.volume > 0.0 ? retVal.quoteVolume / retVal.volume : 0.0;
+    retVal.complete = low != m_p->oldest(head) || low == 0;
+    return retVal;
+}
+}
@@ -9,6 +9,12 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 #include <stonky/binance/binance_futures_rest_client.h>
 #include "stonky/binance/binance_ws_stream_manager.h"
 #include "stonky/binance/binance_futures_ws_client.h"
+#include "stonky/binance/binance_symbol_registry.h"
+#include "stonky/binance/binance_enum_parser.h"
+#include "stonky/utils/utils.h"
+#include <boost/algorithm/string/case_conv.hpp>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <thread>
 #include "stonky/utils/magic_enum_wrapper.hpp"
@@ -17,35 +23,504 @@ Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
 using namespace std::chrono_literals;
 
 namespace stonky::binance::futures {
+static constexpr std::size_t MAX_STORED_GAPS = 1000;
+/// listenKey expires 60 minutes after the last keepalive
+static constexpr auto LISTEN_KEY_KEEPALIVE_INTERVAL = 30min;
+static constexpr auto LISTEN_KEY_RETRY_INTERVAL = 1min;
+/// Levels of each side requested for an order book snapshot
+static constexpr int ORDER_BOOK_SNAPSHOT_LIMIT = 1000;
+static constexpr auto ORDER_BOOK_RETRY_INTERVAL = 1s;
+/// Depths of Partial Book Depth Streams
+static constexpr std::array<int, 3> PARTIAL_DEPTHS{5, 10, 20};
+
+/**
+ * Convert the streamed event to the REST model, interestRate is not streamed
+ */
+static MarkPrice toMarkPrice(const EventMarkPrice &event) {
+    MarkPrice retVal;
+    retVal.symbol = event.s;
+    retVal.markPrice = event.p;
+    retVal.indexPrice = event.i;
+    retVal.estimatedSettlePrice = event.P;
+    retVal.lastFundingRate = event.r;
+    retVal.nextFundingTime = event.T;
+    retVal.time = event.E;
+    return retVal;
+}
+
 struct WSStreamManager::P {
     std::unique_ptr<WebSocketClient> wsClient;
+    /// WebSocketClient subscriptions are not thread-safe, the keepalive thread reconnects the User Data Stream
+    std::mutex wsClientLocker;
     int timeout{5};
+    /// User Data Stream state, guarded by userDataLocker
+    std::mutex userDataLocker;
+    std::condition_variable userDataCV;
     std::string listenKey;
+    onUserData userDataCB;
+    bool renewListenKey{false};
+    bool stopKeepAlive{false};
+    std::thread keepAliveThread;
     mutable std::recursive_mutex tickerLocker;
     mutable std::recursive_mutex candlestickLocker;
-    std::map<std::string, EventTickPrice> tickPrices;
-    std::map<std::string, std::map<CandleInterval, EventCandlestick> > candlesticks;
-    std::map<std::string, std::map<CandleInterval, EventCandlestick> > candlesticksHistoric;
+    /// Indexed by SymbolId
+    std::vector<std::optional<EventTickPrice> > tickPrices;
+    /// Update id of the newest book ticker, kept when the event is consumed, indexed by SymbolId
+    std::vector<std::int64_t> lastTickUpdateIds;
+    std::vector<std::map<CandleInterval, EventCandlestick> > candlesticks;
+    std::vector<std::map<CandleInterval, EventCandlestick> > candlesticksHistoric;
+    /// Gaps of Book Ticker Streams waiting for the first event after reconnect, indexed by SymbolId
+    std::vector<std::optional<EventStreamGap> > tickPriceGaps;
+    mutable std::mutex tradeLocker;
+    /// Trade buffers indexed by SymbolId, only the stream writes into them
+    std::vector<std::shared_ptr<TradeBuffer> > tradeBuffers;
+    mutable std::mutex depthLocker;
+    /// Partial Book Depth Stream events indexed by SymbolId and by the index of the depth in PARTIAL_DEPTHS
+    std::vector<std::array<std::optional<EventDepth>, PARTIAL_DEPTHS.size()> > depths;
+    /// Local order books indexed by SymbolId and their snapshot requests, guarded by orderBookLocker
+    mutable std::mutex orderBookLocker;
+    std::condition_variable orderBookCV;
+    std::vector<std::optional<OrderBook> > orderBooks;
+    std::deque<SymbolId> snapshotRequests;
+    bool stopOrderBooks{false};
+    std::thread orderBookThread;
+    /// All Market Mark Price and Mini Tickers Stream events indexed by SymbolId
+    mutable std::mutex markPriceLocker;
+    std::vector<std::optional<EventMarkPrice> > markPrices;
+    mutable std::mutex miniTickerLocker;
+    std::vector<std::optional<EventMiniTicker> > miniTickers;
+    mutable std::mutex gapLocker;
+    std::deque<EventStreamGap> gaps;
+    onStreamGap streamGapCB;
     std::weak_ptr<RESTClient> restClient;
     onLogMessage logMessageCB;
 
-    explicit P(const std::weak_ptr<RESTClient> &restClient) {
-        wsClient = std::make_unique<WebSocketClient>();
+    P(const std::weak_ptr<RESTClient> &restClient, const std::size_t numIoThreads) {
+        wsClient = std::make_unique<WebSocketClient>(numIoThreads);
+        wsClient->setCombinedStreams();
+        wsClient->setStreamGapCallback([this](const EventStreamGap &gap) {
+            onGap(gap);
+        });
         this->restClient = restClient;
     }
+
+    /**
+     * Get listenKey and connect the User Data Stream, the previous connection is closed
+     * @throws nlohmann::json::exception, std::exception
+     */
+    void connectUserDataStream() {
+        const auto client = restClient.lock();
+
+        if (!client) {
+            throw std::runtime_error("REST client is not available");
+        }
+
+        auto key = client->startUserDataStream();
+        std::string previousKey;
+        {
+            std::lock_guard lk(userDataLocker);
+            previousKey = std::exchange(listenKey, key);
+        }
+
+        std::lock_guard lk(wsClientLocker);
+
+        if (!previousKey.empty()) {
+            wsClient->unsubscribe(WebSocketClient::composeStreamName("", previousKey));
+        }
+
+        wsClient->userDataStream(key, [this](const EventUserData &event) {
+            onUserDataEvent(event);
+        });
+        wsClient->run();
+    }
+
+    void onUserDataEvent(const EventUserData &event) {
+        onUserData cb;
+        {
+            std::lock_guard lk(userDataLocker);
+
+            if (const auto *ev = std::get_if<Event>(&event.eventData); ev && ev->e == EventType::listenKeyExpired) {
+                renewListenKey = true;
+                userDataCV.notify_all();
+            }
+
+            cb = userDataCB;
+        }
+
+        if (cb) {
+            cb(event);
+        }
+    }
+
+    /**
+     * Keep the listenKey alive, replace it when it expires or the keepalive is rejected
+     */
+    void keepAliveUserDataStream() {
+        std::unique_lock lk(userDataLocker);
+        bool retry = false;
+
+        while (!stopKeepAlive) {
+            userDataCV.wait_for(lk, retry ? LISTEN_KEY_RETRY_INTERVAL : LISTEN_KEY_KEEPALIVE_INTERVAL, [this] {
+                return stopKeepAlive || renewListenKey;
+            });
+
+            if (stopKeepAlive) {
+                break;
+            }
+
+            bool renew = std::exchange(renewListenKey, false) || std::exchange(retry, false);
+            lk.unlock();
+
+            if (!renew) {
+                try {
+                    if (const auto client = restClient.lock()) {
+                        client->keepAliveUserDataStream();
+                    }
+                } catch (const std::exception &e) {
+                    log(LogSeverity::Warning, fmt::format("listenKey keepalive failed: {}", e.what()));
+                    renew = true;
+                }
+            }
+
+            if (renew) {
+                const auto disconnectTime = getMsTimestamp(currentTime()).count();
+
+                try {
+                    connectUserDataStream();
+                    EventStreamGap gap;
+                    gap.stream = USER_DATA_STREAM;
+                    gap.disconnectTime = disconnectTime;
+                    gap.reconnectTime = getMsTimestamp(currentTime()).count();
+                    publishGap(gap);
+                } catch (const std::exception &e) {
+                    log(LogSeverity::Error, fmt::format("User Data Stream reconnect failed: {}", e.what()));
+                    retry = true;
+                }
+            }
+
+            lk.lock();
+        }
+    }
+
+    void stopUserDataStream() {
+        {
+            std::lock_guard lk(userDataLocker);
+            stopKeepAlive = true;
+            userDataCV.notify_all();
+        }
+
+        if (keepAliveThread.joinable()) {
+            keepAliveThread.join();
+        }
+    }
+
+    /**
+     * Store book ticker of the symbol received from its own or from the all-market stream
+     */
+    void onTickPrice(const EventTickPrice &event) {
+        const auto symbolId = SymbolRegistry::instance().intern(event.s);
+        std::optional<EventStreamGap> gap;
+        std::unique_lock lk(tickerLocker);
+        auto &lastUpdateId = symbolSlot(lastTickUpdateIds, symbolId);
+
+        /// Both streams deliver the symbol until its own stream is unsubscribed
+        if (event.u <= lastUpdateId) {
+            return;
+        }
+
+        lastUpdateId = event.u;
+        auto &tickPrice = symbolSlot(tickPrices, symbolId);
+
+        if (auto *pendingGap = findSymbolSlot(tickPriceGaps, symbolId); pendingGap && *pendingGap) {
+            gap = std::move(*pendingGap);
+            gap->firstUpdateId = event.u;
+            pendingGap->reset();
+        }
+
+        if (tickPrice) {
+            tickPrice->a = event.a;
+            tickPrice->b = event.b;
+            tickPrice->u = event.u;
+            tickPrice->T = event.T;
+            tickPrice->E = event.E;
+            tickPrice->e = event.e;
+
+            /// Accumulate volume between read outs, otherwise the volume information would be lost!
+            tickPrice->A += event.A;
+            tickPrice->B += event.B;
+        } else {
+            tickPrice = event;
+        }
+
+        lk.unlock();
+
+        if (gap) {
+            publishGap(*gap);
+        }
+    }
+
+    /**
+     * @return index of the depth in PARTIAL_DEPTHS
+     * @throws std::invalid_argument if the depth is not 5, 10 or 20
+     */
+    static std::size_t depthIndex(const int depth) {
+        const auto it = std::find(PARTIAL_DEPTHS.begin(), PARTIAL_DEPTHS.end(), depth);
+
+        if (it == PARTIAL_DEPTHS.end()) {
+            throw std::invalid_argument(fmt::format("invalid depth parameter, must be 5, 10 or 20, is {}", depth));
+        }
+
+        return static_cast<std::size_t>(it - PARTIAL_DEPTHS.begin());
+    }
+
+    void onDepthUpdate(const EventDepthUpdate &event) {
+        const auto symbolId = SymbolRegistry::instance().intern(event.s);
+        std::lock_guard lk(orderBookLocker);
+        auto &orderBook = symbolSlot(orderBooks, symbolId);
+
+        if (!orderBook) {
+            orderBook.emplace(event.s);
+        }
+
+        const auto lastUpdateId = orderBook->lastUpdateId();
+        const auto wasSynced = orderBook->synced();
+
+        if (!orderBook->applyUpdate(event)) {
+            if (wasSynced) {
+                log(LogSeverity::Warning, fmt::format("order book of {} out of sequence, pu: {}, expected: {}", event.s,
+                                                      event.pu, lastUpdateId));
+            }
+
+            requestSnapshot(symbolId);
+        }
+    }
+
+    /**
+     * Has to be called with orderBookLocker locked
+     */
+    void requestSnapshot(const SymbolId symbolId) {
+        if (std::find(snapshotRequests.begin(), snapshotRequests.end(), symbolId) == snapshotRequests.end()) {
+            snapshotRequests.push_back(symbolId);
+            orderBookCV.notify_all();
+        }
+    }
+
+    /**
+     * Download requested snapshots and load them into the order books
+     */
+    void syncOrderBooks() {
+        std::unique_lock lk(orderBookLocker);
+
+        while (!stopOrderBooks) {
+            orderBookCV.wait(lk, [this] {
+                return stopOrderBooks || !snapshotRequests.empty();
+            });
+
+            if (stopOrderBooks) {
+                break;
+            }
+
+            const auto symbolId = snapshotRequests.front();
+            snapshotRequests.pop_front();
+            lk.unlock();
+
+            const std::string symbol(SymbolRegistry::instance().name(symbolId));
+            std::optional<OrderBookSnapshot> snapshot;
+
+            try {
+                const auto client = restClient.lock();
+
+                if (!client) {
+                    throw std::runtime_error("REST client is not available");
+                }
+
+                snapshot = client->getOrderBook(symbol, ORDER_BOOK_SNAPSHOT_LIMIT);
+            } catch (const std::exception &e) {
+                log(LogSeverity::Warning, fmt::format("order book snapshot of {} failed: {}", symbol, e.what()));
+            }
+
+            lk.lock();
+            auto *orderBook = findSymbolSlot(orderBooks, symbolId);
+
+            if (stopOrderBooks || !orderBook || !*orderBook) {
+                continue;
+            }
+
+            /// Failed request or a snapshot older than the buffered events, try again later
+            if (!snapshot || !(*orderBook)->applySnapshot(*snapshot)) {
+                orderBookCV.wait_for(lk, ORDER_BOOK_RETRY_INTERVAL, [this] {
+                    return stopOrderBooks;
+                });
+                requestSnapshot(symbolId);
+            }
+        }
+    }
+
+    void stopOrderBookSync() {
+        {
+            std::lock_guard lk(orderBookLocker);
+            stopOrderBooks = true;
+            orderBookCV.notify_all();
+        }
+
+        if (orderBookThread.joinable()) {
+            orderBookThread.join();
+        }
+    }
+
+    void log(const LogSeverity severity, const std::string &msg) const {
+        if (logMessageCB) {
+            logMessageCB(severity, msg);
+        }
+    }
+
+    void publishGap(const EventStreamGap &gap) {
+        {
+            std::lock_guard lk(gapLocker);
+            gaps.push_back(gap);
+
+            if (gaps.size() > MAX_STORED_GAPS) {
+                gaps.pop_front();
+            }
+        }
+
+        if (streamGapCB) {
+            streamGapCB(gap);
+        }
+    }
+
+    /**
+     * Drop data of the interrupted stream, they are stale
+     */
+    void onGap(const EventStreamGap &gap) {
+        {
+            std::unique_lock lk(userDataLocker);
+
+            if (!listenKey.empty() && gap.stream == listenKey) {
+                lk.unlock();
+                auto userDataGap = gap;
+                userDataGap.stream = USER_DATA_STREAM;
+                return publishGap(userDataGap);
+            }
+        }
+
+        if (gap.stream == ALL_BOOK_TICKERS_STREAM) {
+            {
+                std::lock_guard lk(tickerLocker);
+
+                for (auto &tickPrice: tickPrices) {
+                    tickPrice.reset();
+                }
+            }
+
+            return publishGap(gap);
+        }
+
+        if (gap.stream == ALL_MARK_PRICES_STREAM) {
+            {
+                std::lock_guard lk(markPriceLocker);
+                markPrices.clear();
+            }
+
+            return publishGap(gap);
+        }
+
+        if (gap.stream == ALL_MINI_TICKERS_STREAM) {
+            {
+                std::lock_guard lk(miniTickerLocker);
+                miniTickers.clear();
+            }
+
+            return publishGap(gap);
+        }
+
+        const auto separator = gap.stream.find('@');
+        const auto symbolId = SymbolRegistry::instance().intern(
+            boost::algorithm::to_upper_copy(gap.stream.substr(0, separator)));
+        const auto channel = std::string_view(gap.stream).substr(separator + 1);
+
+        if (channel == "bookTicker") {
+            std::lock_guard lk(tickerLocker);
+            auto pendingGap = gap;
+
+            if (const auto *lastUpdateId = findSymbolSlot(lastTickUpdateIds, symbolId); lastUpdateId && *lastUpdateId) {
+                pendingGap.lastUpdateId = *lastUpdateId;
+            }
+
+            symbolSlot(tickPrices, symbolId).reset();
+            symbolSlot(tickPriceGaps, symbolId) = pendingGap;
+            return;
+        }
+
+        if (channel.starts_with("kline")) {
+            std::lock_guard lk(candlestickLocker);
+
+            if (const auto interval = parseEnum<CandleInterval>(channel.substr(std::string_view("kline").size()))) {
+                if (auto *candles = findSymbolSlot(candlesticks, symbolId)) {
+                    candles->erase(*interval);
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < PARTIAL_DEPTHS.size(); i++) {
+            if (channel == fmt::format("depth{}", PARTIAL_DEPTHS[i])) {
+                std::lock_guard lk(depthLocker);
+
+                if (auto *depth = findSymbolSlot(depths, symbolId)) {
+                    (*depth)[i].reset();
+                }
+            }
+        }
+
+        if (channel == "depth@100ms") {
+            std::lock_guard lk(orderBookLocker);
+
+            if (auto *orderBook = findSymbolSlot(orderBooks, symbolId); orderBook && *orderBook) {
+                /// The next event requests a new snapshot
+                (*orderBook)->reset();
+            }
+        }
+
+        publishGap(gap);
+    }
+
+    /**
+     * @return element of the symbol, the vector is extended when needed
+     */
+    template<typename T>
+    static T &symbolSlot(std::vector<T> &values, const SymbolId symbolId) {
+        if (symbolId >= values.size()) {
+            values.resize(symbolId + 1);
+        }
+
+        return values[symbolId];
+    }
+
+    /**
+     * @return element of the symbol, nullptr if there is none
+     */
+    template<typename T>
+    static T *findSymbolSlot(std::vector<T> &values, const SymbolId symbolId) {
+        return symbolId < values.size() ? &values[symbolId] : nullptr;
+    }
 };
 
-WSStreamManager::WSStreamManager(const std::weak_ptr<RESTClient> &restClient) : m_p(
-    std::make_unique<P>(restClient)) {
+WSStreamManager::WSStreamManager(const std::weak_ptr<RESTClient> &restClient, const std::size_t numIoThreads) : m_p(
+    std::make_unique<P>(restClient, numIoThreads)) {
 }
 
 WSStreamManager::~WSStreamManager() {
+    unsubscribeUserDataStream();
+    m_p->stopOrderBookSync();
     m_p->wsClient.reset();
     m_p->timeout = 0;
 }
 
 void WSStreamManager::subscribeBookTickerStream(const std::string &pair, bool) const {
-    if (m_p->wsClient->findStream(WebSocketClient::composeStreamName(pair, "bookTicker"))) {
+    std::lock_guard wsLk(m_p->wsClientLocker);
+
+    if (m_p->wsClient->findStream(WebSocketClient::composeStreamName(pair, "bookTicker")) ||
+        m_p->wsClient->findStream(WebSocketClient::composeStreamName("", ALL_BOOK_TICKERS_STREAM))) {
         return;
     }
 
@@ -54,29 +529,10 @@ void WSStreamManager::subscribeBookTickerStream(const std::string &pair, bool) c
         m_p->logMessageCB(LogSeverity::Info, msgString);
     }
 
-    m_p->wsClient->bookTicker(pair, [&](const nlohmann::json &msg) {
-        std::lock_guard lk(m_p->tickerLocker);
-        EventTickPrice eventMsg;
-        eventMsg.fromJson(msg);
-
-        try {
-            if (const auto it = m_p->tickPrices.find(eventMsg.s); it != m_p->tickPrices.end()) {
-                it->second.a = eventMsg.a;
-                it->second.b = eventMsg.b;
-                it->second.u = eventMsg.u;
-                it->second.T = eventMsg.T;
-                it->second.E = eventMsg.E;
-                it->second.e = eventMsg.e;
-
-                /// Accumulate volume between read outs, otherwise the volume information would be lost!
-                it->second.A += eventMsg.A;
-                it->second.B += eventMsg.B;
-            } else {
-                m_p->tickPrices.insert({eventMsg.s, eventMsg});
-            }
-        } catch (nlohmann::json::exception &e) {
-            m_p->logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, e.what()));
-        }
+    /// Readers look the pair up without registering it, they wait for the first event of a subscribed pair
+    SymbolRegistry::instance().intern(pair);
+    m_p->wsClient->bookTicker(pair, [p = m_p.get()](const EventTickPrice &eventMsg) {
+        p->onTickPrice(eventMsg);
     });
 
     m_p->wsClient->run();
@@ -85,6 +541,7 @@ void WSStreamManager::subscribeBookTickerStream(const std::string &pair, bool) c
 void WSStreamManager::subscribeCandlestickStream(const std::string &pair, const CandleInterval interval, bool) const {
     std::string channel("kline");
     channel.append(magic_enum::enum_name(interval));
+    std::lock_guard wsLk(m_p->wsClientLocker);
 
     if (m_p->wsClient->findStream(WebSocketClient::composeStreamName(pair, channel))) {
         return;
@@ -95,53 +552,233 @@ void WSStreamManager::subscribeCandlestickStream(const std::string &pair, const
         m_p->logMessageCB(LogSeverity::Info, msgString);
     }
 
-    m_p->wsClient->candlestick(pair, interval, [&](const nlohmann::json &msg) {
+    SymbolRegistry::instance().intern(pair);
+    m_p->wsClient->candlestick(pair, interval, [&](const EventCandlestick &eventMsg) {
+        const auto symbolId = SymbolRegistry::instance().intern(eventMsg.s);
         std::lock_guard lk(m_p->candlestickLocker);
-        EventCandlestick eventMsg;
-        eventMsg.fromJson(msg);
+        std::optional<EventCandlestick> previousCandle;
+        /// Insert new candle
+        {
+            auto &candles = P::symbolSlot(m_p->candlesticks, symbolId);
 
-        try {
-            std::optional<EventCandlestick> previousCandle;
-            /// Insert new candle
-            {
-                auto it = m_p->candlesticks.find(eventMsg.s);
+            if (const auto itInterval = candles.find(eventMsg.k.i);
+                itInterval != candles.end() && itInterval->second.k.t != eventMsg.k.t) {
+                previousCandle = itInterval->second;
+            }
 
-                if (it == m_p->candlesticks.end()) {
-                    m_p->candlesticks.insert({eventMsg.s, {}});
-                }
+            candles.insert_or_assign(eventMsg.k.i, eventMsg);
+        }
 
-                it = m_p->candlesticks.find(eventMsg.s);
+        /// Update historic candle
+        {
+            if (previousCandle) {
+                P::symbolSlot(m_p->candlesticksHistoric, symbolId).insert_or_assign(previousCandle->k.i,
+                                                                                    *previousCandle);
+            }
+        }
+    });
 
-                if (const auto itInterval = it->second.find(eventMsg.k.i);
-                    itInterval != it->second.end() && itInterval->second.k.t != eventMsg.k.t) {
-                    previousCandle = itInterval->second;
-                }
+    m_p->wsClient->run();
+}
 
-                it->second.insert_or_assign(eventMsg.k.i, eventMsg);
-            }
+void WSStreamManager::subscribeAggTradeStream(const std::string &pair, const std::size_t capacity) const {
+    std::lock_guard wsLk(m_p->wsClientLocker);
 
-            /// Update historic candle
-            {
-                if (previousCandle) {
-                    auto it = m_p->candlesticksHistoric.find(eventMsg.s);
+    if (m_p->wsClient->findStream(WebSocketClient::composeStreamName(pair, "aggTrade"))) {
+        return;
+    }
 
-                    if (it == m_p->candlesticksHistoric.end()) {
-                        m_p->candlesticksHistoric.insert({eventMsg.s, {}});
-                    }
+    if (m_p->logMessageCB) {
+        const auto msgString = fmt::format("subscribing: {}", WebSocketClient::composeStreamName(pair, "aggTrade"));
+        m_p->logMessageCB(LogSeverity::Info, msgString);
+    }
 
-                    it = m_p->candlesticksHistoric.find(eventMsg.s);
-                    it->second.insert_or_assign(previousCandle->k.i,
-                                                *previousCandle);
-                }
-            }
-        } catch (nlohmann::json::exception &e) {
-            m_p->logMessageCB(LogSeverity::Error, fmt::format("{}: {}", MAKE_FILELINE, e.what()));
+    const auto buffer = std::make_shared<TradeBuffer>(capacity);
+    {
+        std::lock_guard lk(m_p->tradeLocker);
+        P::symbolSlot(m_p->tradeBuffers, SymbolRegistry::instance().intern(pair)) = buffer;
+    }
+
+    /// The stream is the single writer of the buffer
+    m_p->wsClient->aggTrade(pair, [buffer](const PodEventAggregatedTrade &eventMsg) {
+        buffer->push(eventMsg);
+    });
+
+    m_p->wsClient->run();
+}
+
+void WSStreamManager::subscribeDepthStream(const std::string &pair, const int depth) const {
+    const auto index = P::depthIndex(depth);
+    const auto channel = fmt::format("depth{}", depth);
+    std::lock_guard wsLk(m_p->wsClientLocker);
+
+    if (m_p->wsClient->findStream(WebSocketClient::composeStreamName(pair, channel))) {
+        return;
+    }
+
+    if (m_p->logMessageCB) {
+        const auto msgString = fmt::format("subscribing: {}", WebSocketClient::composeStreamName(pair, channel));
+        m_p->logMessageCB(LogSeverity::Info, msgString);
+    }
+
+    SymbolRegistry::instance().intern(pair);
+    m_p->wsClient->partialBookDepthStream(pair, depth, [p = m_p.get(), index](const EventDepth &eventMsg) {
+        const auto symbolId = SymbolRegistry::instance().intern(eventMsg.s);
+        std::lock_guard lk(p->depthLocker);
+        P::symbolSlot(p->depths, symbolId)[index] = eventMsg;
+    });
+
+    m_p->wsClient->run();
+}
+
+void WSStreamManager::subscribeOrderBook(const std::string &pair) const {
+    std::lock_guard wsLk(m_p->wsClientLocker);
+
+    if (m_p->wsClient->findStream(WebSocketClient::composeStreamName(pair, "depth@100ms"))) {
+        return;
+    }
+
+    if (m_p->logMessageCB) {
+        const auto msgString = fmt::format("subscribing: {}", WebSocketClient::composeStreamName(pair, "depth@100ms"));
+        m_p->logMessageCB(LogSeverity::Info, msgString);
+    }
+
+    {
+        std::lock_guard lk(m_p->orderBookLocker);
+
+        if (!m_p->orderBookThread.joinable()) {
+            m_p->orderBookThread = std::thread([p = m_p.get()] {
+                p->syncOrderBooks();
+            });
         }
+    }
+
+    SymbolRegistry::instance().intern(pair);
+    m_p->wsClient->diffBookDepthStream(pair, [p = m_p.get()](const EventDepthUpdate &event) {
+        p->onDepthUpdate(event);
+    });
+
+    m_p->wsClient->run();
+}
+
+void WSStreamManager::subscribeAllBookTickers() const {
+    const auto streamName = WebSocketClient::composeStreamName("", ALL_BOOK_TICKERS_STREAM);
+    std::lock_guard wsLk(m_p->wsClientLocker);
+
+    if (m_p->wsClient->findStream(streamName)) {
+        return;
+    }
+
+    if (m_p->logMessageCB) {
+        m_p->logMessageCB(LogSeverity::Info, fmt::format("subscribing: {}", streamName));
+    }
+
+    m_p->wsClient->allBookTickers([p = m_p.get()](const EventTickPrice &eventMsg) {
+        p->onTickPrice(eventMsg);
+    });
+
+    /// Tickers of single pairs come from the all-market stream now
+    const auto &registry = SymbolRegistry::instance();
+
+    for (SymbolId symbolId = 0; symbolId < registry.size(); symbolId++) {
+        m_p->wsClient->unsubscribe(WebSocketClient::composeStreamName(std::string(registry.name(symbolId)),
+                                                                      "bookTicker"));
+    }
+
+    m_p->wsClient->run();
+}
+
+void WSStreamManager::subscribeAllMarkPrices() const {
+    const auto streamName = WebSocketClient::composeStreamName("", ALL_MARK_PRICES_STREAM);
+    std::lock_guard wsLk(m_p->wsClientLocker);
+
+    if (m_p->wsClient->findStream(streamName)) {
+        return;
+    }
+
+    if (m_p->logMessageCB) {
+        m_p->logMessageCB(LogSeverity::Info, fmt::format("subscribing: {}", streamName));
+    }
+
+    m_p->wsClient->allMarkPrices([p = m_p.get()](const EventMarkPrice &eventMsg) {
+        const auto symbolId = SymbolRegistry::instance().intern(eventMsg.s);
+        std::lock_guard lk(p->markPriceLocker);
+        P::symbolSlot(p->markPrices, symbolId) = eventMsg;
     });
 
     m_p->wsClient->run();
 }
 
+void WSStreamManager::subscribeAllMiniTickers() const {
+    const auto streamName = WebSocketClient::composeStreamName("", ALL_MINI_TICKERS_STREAM);
+    std::lock_guard wsLk(m_p->wsClientLocker);
+
+    if (m_p->wsClient->findStream(streamName)) {
+        return;
+    }
+
+    if (m_p->logMessageCB) {
+        m_p->logMessageCB(LogSeverity::Info, fmt::format("subscribing: {}", streamName));
+    }
+
+    m_p->wsClient->allMiniTickers([p = m_p.get()](const EventMiniTicker &eventMsg) {
+        const auto symbolId = SymbolRegistry::instance().intern(eventMsg.s);
+        std::lock_guard lk(p->miniTickerLocker);
+        P::symbolSlot(p->miniTickers, symbolId) = eventMsg;
+    });
+
+    m_p->wsClient->run();
+}
+
+void WSStreamManager::subscribeUserDataStream(const onUserData &onUserDataCB) const {
+    {
+        std::lock_guard lk(m_p->userDataLocker);
+        m_p->userDataCB = onUserDataCB;
+
+        if (!m_p->listenKey.empty()) {
+            return;
+        }
+    }
+
+    m_p->connectUserDataStream();
+
+    std::lock_guard lk(m_p->userDataLocker);
+    m_p->stopKeepAlive = false;
+
+    if (!m_p->keepAliveThread.joinable()) {
+        m_p->keepAliveThread = std::thread([p = m_p.get()] {
+            p->keepAliveUserDataStream();
+        });
+    }
+}
+
+void WSStreamManager::unsubscribeUserDataStream() const {
+    m_p->stopUserDataStream();
+
+    std::string key;
+    {
+        std::lock_guard lk(m_p->userDataLocker);
+        key = std::exchange(m_p->listenKey, {});
+    }
+
+    if (key.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard lk(m_p->wsClientLocker);
+        m_p->wsClient->unsubscribe(WebSocketClient::composeStreamName("", key));
+    }
+
+    try {
+        if (const auto client = m_p->restClient.lock()) {
+            client->closeUserDataStream();
+        }
+    } catch (const std::exception &e) {
+        m_p->log(LogSeverity::Warning, fmt::format("listenKey close failed: {}", e.what()));
+    }
+}
+
 void WSStreamManager::setTimeout(const int seconds) const {
     m_p->timeout = seconds;
 }
@@ -155,8 +792,28 @@ void WSStreamManager::setLoggerCallback(const onLogMessage &onLogMessageCB) cons
     m_p->wsClient->setLoggerCallback(onLogMessageCB);
 }
 
+void WSStreamManager::setStreamGapCallback(const onStreamGap &onStreamGapCB) const {
+    m_p->streamGapCB = onStreamGapCB;
+}
+
+std::vector<EventStreamGap> WSStreamManager::readStreamGaps() const {
+    std::lock_guard lk(m_p->gapLocker);
+    std::vector<EventStreamGap> retVal(m_p->gaps.begin(), m_p->gaps.end());
+    m_p->gaps.clear();
+    return retVal;
+}
+
 std::optional<EventTickPrice> WSStreamManager::readEventTickPrice(const std::string &pair,
                                                                   const bool consumeEvent) const {
+    if (const auto symbolId = SymbolRegistry::instance().find(pair)) {
+        return readEventTickPrice(*symbolId, consumeEvent);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<EventTickPrice> WSStreamManager::readEventTickPrice(const SymbolId symbolId,
+                                                                  const bool consumeEvent) const {
     int numTries = 0;
     const int maxNumTries = static_cast<int>(m_p->timeout / 0.01);
 
@@ -168,14 +825,14 @@ std::optional<EventTickPrice> WSStreamManager::readEventTickPrice(const std::str
 
         m_p->tickerLocker.lock();
 
-        if (const auto it = m_p->tickPrices.find(pair); it != m_p->tickPrices.end()) {
-            auto retVal = it->second;
+        if (auto *tickPrice = P::findSymbolSlot(m_p->tickPrices, symbolId); tickPrice && *tickPrice) {
+            auto retVal = **tickPrice;
             /// Zero volume counters - prepare for accumulating
-            it->second.A = 0.0;
-            it->second.B = 0.0;
+            (*tickPrice)->A = 0.0;
+            (*tickPrice)->B = 0.0;
 
             if (consumeEvent) {
-                m_p->tickPrices.erase(it);
+                tickPrice->reset();
             }
 
             m_p->tickerLocker.unlock();
@@ -192,6 +849,16 @@ std::optional<EventTickPrice> WSStreamManager::readEventTickPrice(const std::str
 std::optional<EventCandlestick>
 WSStreamManager::readEventCandlestick(const std::string &pair, const CandleInterval interval,
                                       const bool previous) const {
+    if (const auto symbolId = SymbolRegistry::instance().find(pair)) {
+        return readEventCandlestick(*symbolId, interval, previous);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<EventCandlestick>
+WSStreamManager::readEventCandlestick(const SymbolId symbolId, const CandleInterval interval,
+                                      const bool previous) const {
     int numTries = 0;
     const int maxNumTries = static_cast<int>(m_p->timeout / 0.01);
 
@@ -204,8 +871,8 @@ WSStreamManager::readEventCandlestick(const std::string &pair, const CandleInter
         if (previous) {
             m_p->candlestickLocker.lock();
 
-            if (const auto it = m_p->candlesticksHistoric.find(pair); it != m_p->candlesticksHistoric.end()) {
-                if (const auto itCandle = it->second.find(interval); itCandle != it->second.end()) {
+            if (const auto *candles = P::findSymbolSlot(m_p->candlesticksHistoric, symbolId)) {
+                if (const auto itCandle = candles->find(interval); itCandle != candles->end()) {
                     auto retVal = itCandle->second;
                     m_p->candlestickLocker.unlock();
                     return retVal;
@@ -215,8 +882,8 @@ WSStreamManager::readEventCandlestick(const std::string &pair, const CandleInter
         } else {
             m_p->candlestickLocker.lock();
 
-            if (const auto it = m_p->candlesticks.find(pair); it != m_p->candlesticks.end()) {
-                if (const auto itCandle = it->second.find(interval); itCandle != it->second.end()) {
+            if (const auto *candles = P::findSymbolSlot(m_p->candlesticks, symbolId)) {
+                if (const auto itCandle = candles->find(interval); itCandle != candles->end()) {
                     auto retVal = itCandle->second;
                     m_p->candlestickLocker.unlock();
                     return retVal;
@@ -230,4 +897,226 @@ WSStreamManager::readEventCandlestick(const std::string &pair, const CandleInter
 
     return {};
 }
+
+std::shared_ptr<const TradeBuffer> WSStreamManager::aggTradeBuffer(const std::string &pair) const {
+    if (const auto symbolId = SymbolRegistry::instance().find(pair)) {
+        return aggTradeBuffer(*symbolId);
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<const TradeBuffer> WSStreamManager::aggTradeBuffer(const SymbolId symbolId) const {
+    std::lock_guard lk(m_p->tradeLocker);
+
+    if (const auto *buffer = P::findSymbolSlot(m_p->tradeBuffers, symbolId)) {
+        return *buffer;
+    }
+
+    return nullptr;
+}
+
+std::vector<PodEventAggregatedTrade> WSStreamManager::readAggregatedTrades(const std::string &pair,
+                                                                           const std::size_t count) const {
+    if (const auto buffer = aggTradeBuffer(pair)) {
+        return buffer->latest(count);
+    }
+
+    return {};
+}
+
+std::optional<TradeStatistics> WSStreamManager::readTradeStatistics(const std::string &pair,
+                                                                    const std::chrono::milliseconds window) const {
+    if (const auto buffer = aggTradeBuffer(pair)) {
+        return buffer->statistics((getMsTimestamp(currentTime()) - window).count());
+    }
+
+    return {};
+}
+
+std::optional<EventDepth> WSStreamManager::readEventDepth(const std::string &pair, const int depth) const {
+    if (const auto symbolId = SymbolRegistry::instance().find(pair)) {
+        return readEventDepth(*symbolId, depth);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<EventDepth> WSStreamManager::readEventDepth(const SymbolId symbolId, const int depth) const {
+    const auto index = P::depthIndex(depth);
+    int numTries = 0;
+    const int maxNumTries = static_cast<int>(m_p->timeout / 0.01);
+
+    while (numTries <= maxNumTries) {
+        if (m_p->timeout == 0) {
+            /// No need to wait when destroying object
+            break;
+        }
+
+        {
+            std::lock_guard lk(m_p->depthLocker);
+
+            if (const auto *depths = P::findSymbolSlot(m_p->depths, symbolId); depths && (*depths)[index]) {
+                return (*depths)[index];
+            }
+        }
+
+        numTries++;
+        std::this_thread::sleep_for(3ms);
+    }
+
+    return {};
+}
+
+std::optional<OrderBookSnapshot> WSStreamManager::readOrderBook(const std::string &pair, const std::size_t depth) const {
+    if (const auto symbolId = SymbolRegistry::instance().find(pair)) {
+        return readOrderBook(*symbolId, depth);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<OrderBookSnapshot> WSStreamManager::readOrderBook(const SymbolId symbolId, const std::size_t depth) const {
+    int numTries = 0;
+    const int maxNumTries = static_cast<int>(m_p->timeout / 0.01);
+
+    while (numTries <= maxNumTries) {
+        if (m_p->timeout == 0) {
+            /// No need to wait when destroying object
+            break;
+        }
+
+        {
+            std::lock_guard lk(m_p->orderBookLocker);
+
+            if (const auto *orderBook = P::findSymbolSlot(m_p->orderBooks, symbolId);
+                orderBook && *orderBook && (*orderBook)->synced()) {
+                return (*orderBook)->snapshot(depth);
+            }
+        }
+
+        numTries++;
+        std::this_thread::sleep_for(3ms);
+    }
+
+    return {};
+}
+
+std::optional<EventMarkPrice> WSStreamManager::readEventMarkPrice(const std::string &pair) const {
+    if (const auto symbolId = SymbolRegistry::instance().find(pair)) {
+        return readEventMarkPrice(*symbolId);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<EventMarkPrice> WSStreamManager::readEventMarkPrice(const SymbolId symbolId) const {
+    int numTries = 0;
+    const int maxNumTries = static_cast<int>(m_p->timeout / 0.01);
+
+    while (numTries <= maxNumTries) {
+        if (m_p->timeout == 0) {
+            /// No need to wait when destroying object
+            break;
+        }
+
+        {
+            std::lock_guard lk(m_p->markPriceLocker);
+
+            if (const auto *markPrice = P::findSymbolSlot(m_p->markPrices, symbolId); markPrice && *markPrice) {
+                return *markPrice;
+            }
+        }
+
+        numTries++;
+        std::this_thread::sleep_for(3ms);
+    }
+
+    return {};
+}
+
+std::vector<MarkPrice> WSStreamManager::readMarkPrices() const {
+    int numTries = 0;
+    const int maxNumTries = static_cast<int>(m_p->timeout / 0.01);
+
+    while (numTries <= maxNumTries) {
+        if (m_p->timeout == 0) {
+            /// No need to wait when destroying object
+            break;
+        }
+
+        {
+            std::lock_guard lk(m_p->markPriceLocker);
+            std::vector<MarkPrice> retVal;
+
+            for (const auto &markPrice: m_p->markPrices) {
+                if (markPrice) {
+                    retVal.push_back(toMarkPrice(*markPrice));
+                }
+            }
+
+            if (!retVal.empty()) {
+                return retVal;
+            }
+        }
+
+        numTries++;
+        std::this_thread::sleep_for(3ms);
+    }
+
+    return {};
+}
+
+std::vector<MarkPrice> WSStreamManager::readMarkPrices(const std::chrono::milliseconds maxAge) const {
+    const auto minTime = (getMsTimestamp(currentTime()) - maxAge).count();
+    std::vector<MarkPrice> retVal;
+    std::lock_guard lk(m_p->markPriceLocker);
+
+    for (auto &markPrice: m_p->markPrices) {
+        if (!markPrice) {
+            continue;
+        }
+
+        if (markPrice->E < minTime) {
+            markPrice.reset();
+        } else {
+            retVal.push_back(toMarkPrice(*markPrice));
+        }
+    }
+
+    return retVal;
+}
+
+std::optional<EventMiniTicker> WSStreamManager::readEventMiniTicker(const std::string &pair) const {
+    if (const auto symbolId = SymbolRegistry::instance().find(pair)) {
+        return readEventMiniTicker(*symbolId);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<EventMiniTicker> WSStreamManager::readEventMiniTicker(const SymbolId symbolId) const {
+    int numTries = 0;
+    const int maxNumTries = static_cast<int>(m_p->timeout / 0.01);
+
+    while (numTries <= maxNumTries) {
+        if (m_p->timeout == 0) {
+            /// No need to wait when destroying object
+            break;
+        }
+
+        {
+            std::lock_guard lk(m_p->miniTickerLocker);
+
+            if (const auto *miniTicker = P::findSymbolSlot(m_p->miniTickers, symbolId); miniTicker && *miniTicker) {
+                return *miniTicker;
+            }
+        }
+
+        numTries++;
+        std::this_thread::sleep_for(3ms);
+    }
+
+    return {};
+}
 }
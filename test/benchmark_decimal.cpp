@@ -0,0 +1,154 @@
+/**
+Benchmark of decimal string parsing
+
+Usage: benchmark_decimal [count]
+
+Compares the former stod / readStringAsDouble conversions with the allocation-free parseDouble / readDecimal on
+Binance-like decimal strings, e.g. "37012.45000000". Edge cases of the fixed-point Decimal are checked first.
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_decimal.h"
+#include "stonky/binance/binance_json_parser.h"
+#include "stonky/utils/json_utils.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <spdlog/spdlog.h>
+
+using namespace stonky;
+using namespace stonky::binance;
+
+template<typename Fn>
+void benchmark(const std::string &name, const std::size_t count, Fn &&fn) {
+    double sum = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < count; i++) {
+        sum += fn(i);
+    }
+
+    const auto elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << fmt::format("{:<40} {:>8.1f} ns/value {:>10.2f} M values/s (checksum {:.4f})", name,
+                             elapsedNs / static_cast<double>(count), static_cast<double>(count) * 1000.0 / elapsedNs,
+                             sum) << std::endl;
+}
+
+/**
+ * @return true if fn throws std::out_of_range
+ */
+template<typename Fn>
+bool throwsOutOfRange(Fn &&fn) {
+    try {
+        [[maybe_unused]] const auto result = fn();
+    } catch (const std::out_of_range &) {
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @return false if any Decimal edge case fails, failures are written to stderr
+ */
+bool checkDecimal() {
+    bool retVal = true;
+    const auto check = [&](const bool condition, const std::string &name) {
+        if (!condition) {
+            std::cerr << "Decimal check failed: " << name << std::endl;
+            retVal = false;
+        }
+    };
+
+    const auto price = Decimal::fromString("37012.45", 2);
+    const auto quantity = Decimal::fromString("0.001", 3);
+    check((price * quantity).toString() == "37.01245", "price * quantity");
+    check((price + quantity).toString() == "37012.451", "mixed scale sum");
+
+    /// Scale sum above MAX_SCALE is capped and rounded
+    check((Decimal::fromString("1", 10) * Decimal::fromString("2", 10)).toString() == "2.000000000000000000",
+          "1 * 2 with scales 10");
+    check((Decimal(15, 10) * Decimal(10, 10)) == Decimal(2, 18), "1.5e-9 * 1e-9 rounds half away from zero");
+    check((Decimal(-15, 10) * Decimal(10, 10)) == Decimal(-2, 18), "negative product rounds half away from zero");
+    check((Decimal(14, 10) * Decimal(10, 10)) == Decimal(1, 18), "1.4e-9 * 1e-9 rounds down");
+
+    /// Large mantissas
+    check((Decimal(3037000499LL, 0) * Decimal(3037000499LL, 0)).value() == 9223372030926249001LL,
+          "largest square fitting int64");
+    check(throwsOutOfRange([] { return Decimal(3037000500LL, 0) * Decimal(3037000500LL, 0); }), "square overflow");
+    check(throwsOutOfRange([] { return Decimal(std::numeric_limits<std::int64_t>::max(), 0) * 2; }),
+          "multiplier overflow");
+    check(throwsOutOfRange([] { return Decimal(std::numeric_limits<std::int64_t>::max(), 0) + Decimal(1, 0); }),
+          "sum overflow");
+    check(throwsOutOfRange([] { return Decimal(std::numeric_limits<std::int64_t>::min(), 0) - Decimal(1, 0); }),
+          "difference overflow");
+    check(throwsOutOfRange([] { return Decimal(1000000000000LL, 0) + Decimal(1, 8); }), "scale alignment overflow");
+    check(throwsOutOfRange([] { return Decimal(1000000000000LL, 0).rescale(Decimal::MAX_SCALE); }),
+          "rescale overflow");
+
+    try {
+        [[maybe_unused]] const Decimal invalid(1, Decimal::MAX_SCALE + 1);
+        check(false, "scale above MAX_SCALE");
+    } catch (const std::invalid_argument &) {
+    }
+
+    return retVal;
+}
+
+int main(int argc, char **argv) {
+    if (!checkDecimal()) {
+        return 1;
+    }
+
+    const std::size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    /// Prices, quantities and rates as Binance sends them - fixed 8 decimal places
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution distribution(0.0, 100000.0);
+    std::vector<std::string> values;
+    std::vector<nlohmann::json> objects;
+    values.reserve(count);
+    objects.reserve(count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        values.push_back(fmt::format("{:.8f}", distribution(generator)));
+        objects.push_back({{"price", values.back()}});
+    }
+
+    try {
+        benchmark("stod(std::string)", count, [&](const std::size_t i) {
+            return std::stod(values[i]);
+        });
+
+        benchmark("parseDouble(std::string_view)", count, [&](const std::size_t i) {
+            double value = 0.0;
+            parseDouble(values[i], value);
+            return value;
+        });
+
+        benchmark("stod(json.get<std::string>())", count, [&](const std::size_t i) {
+            return std::stod(objects[i]["price"].get<std::string>());
+        });
+
+        benchmark("readDecimal(json[key])", count, [&](const std::size_t i) {
+            return readDecimal(objects[i]["price"]);
+        });
+
+        benchmark("readStringAsDouble(json, key)", count, [&](const std::size_t i) {
+            return readStringAsDouble(objects[i], "price");
+        });
+
+        benchmark("readDecimal(json, key)", count, [&](const std::size_t i) {
+            return readDecimal(objects[i], "price");
+        });
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
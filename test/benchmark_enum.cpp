@@ -0,0 +1,87 @@
+/**
+Benchmark of enum name parsing
+
+Usage: benchmark_enum [count]
+
+Compares magic_enum::enum_cast with the perfect-hash parseEnum on enum names as they come in ORDER_TRADE_UPDATE
+events and exchangeInfo symbols.
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_enum_parser.h"
+#include "stonky/binance/binance_event_models.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <spdlog/spdlog.h>
+
+using namespace stonky::binance;
+using namespace stonky::binance::futures;
+
+template<typename Fn>
+void benchmark(const std::string &name, const std::size_t count, Fn &&fn) {
+    std::int64_t sum = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < count; i++) {
+        sum += fn(i);
+    }
+
+    const auto elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << fmt::format("{:<40} {:>8.1f} ns/value {:>10.2f} M values/s (checksum {})", name,
+                             elapsedNs / static_cast<double>(count), static_cast<double>(count) * 1000.0 / elapsedNs,
+                             sum) << std::endl;
+}
+
+/**
+ * Random names of all values of the enum
+ */
+template<typename T>
+std::vector<std::string> generateNames(const std::size_t count) {
+    constexpr auto names = magic_enum::enum_names<T>();
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<std::size_t> distribution(0, names.size() - 1);
+    std::vector<std::string> retVal;
+    retVal.reserve(count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        retVal.emplace_back(names[distribution(generator)]);
+    }
+
+    return retVal;
+}
+
+template<typename T>
+void benchmarkEnum(const std::string &enumName, const std::size_t count) {
+    const auto names = generateNames<T>(count);
+
+    benchmark(enumName + " magic_enum::enum_cast", count, [&](const std::size_t i) {
+        return magic_enum::enum_integer(magic_enum::enum_cast<T>(names[i]).value_or(T{}));
+    });
+
+    benchmark(enumName + " parseEnum", count, [&](const std::size_t i) {
+        return magic_enum::enum_integer(parseEnum<T>(names[i]).value_or(T{}));
+    });
+}
+
+int main(int argc, char **argv) {
+    const std::size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    try {
+        benchmarkEnum<OrderType>("OrderType", count);
+        benchmarkEnum<OrderStatus>("OrderStatus", count);
+        benchmarkEnum<ExecutionType>("ExecutionType", count);
+        benchmarkEnum<EventType>("EventType", count);
+        benchmarkEnum<SymbolFilter>("SymbolFilter", count);
+        benchmarkEnum<TimeInForce>("TimeInForce", count);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
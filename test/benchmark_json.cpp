@@ -0,0 +1,97 @@
+/**
+Benchmark of JSON parsing backends on recorded REST responses
+
+Usage: benchmark_json <directory> [iterations]
+
+The directory contains response bodies recorded e.g. by
+    curl -o klines.json "https://fapi.binance.com/fapi/v1/klines?symbol=BTCUSDT&interval=1m&limit=1500"
+    curl -o premiumIndex.json "https://fapi.binance.com/fapi/v1/premiumIndex"
+    curl -o fundingRate.json "https://fapi.binance.com/fapi/v1/fundingRate?symbol=BTCUSDT&limit=1000"
+    curl -o exchangeInfo.json "https://fapi.binance.com/fapi/v1/exchangeInfo"
+and income.json with the body of signed /fapi/v1/income?limit=1000 request. Missing files are skipped.
+Simdjson backend is measured only when the library is built with BINANCE_API_USE_SIMDJSON.
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Vitezslav Kot <vitezslav.kot@stonky.cz>, Stonky s.r.o.
+*/
+
+#include "stonky/binance/binance_json_parser.h"
+#include "stonky/utils/json_utils.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <spdlog/spdlog.h>
+
+using namespace stonky::binance;
+
+std::string readFile(const std::filesystem::path &path) {
+    std::ifstream ifs(path, std::ios::binary);
+
+    if (!ifs.is_open()) {
+        return {};
+    }
+
+    std::stringstream buffer;
+    buffer << ifs.rdbuf();
+    return buffer.str();
+}
+
+template<typename T>
+void benchmark(const std::filesystem::path &directory, const std::string &fileName, const int iterations) {
+    const auto payload = readFile(directory / fileName);
+
+    if (payload.empty()) {
+        std::cout << fmt::format("{:<20} skipped, file not found", fileName) << std::endl;
+        return;
+    }
+
+    for (const auto backend: magic_enum::enum_values<JsonBackend>()) {
+        if (!isJsonBackendAvailable(backend)) {
+            continue;
+        }
+
+        T model;
+
+        /// warm up, allocates parser buffers
+        parseResponse(payload, model, backend);
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < iterations; i++) {
+            parseResponse(payload, model, backend);
+        }
+
+        const auto elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).
+                               count() / iterations;
+
+        std::cout << fmt::format("{:<20} {:<10} {:>12.1f} us {:>10.1f} MB/s", fileName,
+                                 magic_enum::enum_name(backend), elapsedUs,
+                                 static_cast<double>(payload.size()) / elapsedUs) << std::endl;
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: benchmark_json <directory> [iterations]" << std::endl;
+        return 1;
+    }
+
+    const std::filesystem::path directory{argv[1]};
+    const int iterations = argc > 2 ? std::max(std::stoi(argv[2]), 1) : 100;
+
+    try {
+        benchmark<CandlesResponse>(directory, "klines.json", iterations);
+        benchmark<futures::MarkPrices>(directory, "premiumIndex.json", iterations);
+        benchmark<futures::FundingRates>(directory, "fundingRate.json", iterations);
+        benchmark<futures::Exchange>(directory, "exchangeInfo.json", iterations);
+        benchmark<futures::Incomes>(directory, "income.json", iterations);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
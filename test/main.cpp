@@ -3,7 +3,13 @@
 #include "stonky/utils/json_utils.h"
 #include "stonky/utils/utils.h"
 #include "stonky/binance/binance_futures_ws_client.h"
+#include "stonky/binance/binance_futures_ws_session.h"
 #include "stonky/binance/binance_ws_stream_manager.h"
+#include "stonky/binance/binance_income_ledger.h"
+#include "stonky/binance/binance_order_book.h"
+#include "stonky/binance/binance_trade_buffer.h"
+#include <cmath>
+#include <map>
 #include <memory>
 #include <filesystem>
 #include <iostream>
@@ -400,13 +406,205 @@ void testFRMulti() {
     spdlog::info("FR number", retVal.size());
 }
 
+void testTickerPrices() {
+    const auto restClient = std::make_shared<futures::RESTClient>("", "");
+
+    try {
+        const auto tickerPrices = restClient->getTickerPrices();
+        const auto bookTickerPrices = restClient->getBookTickerPrices();
+
+        if (const auto it = bookTickerPrices.find("BTCUSDT"); it != bookTickerPrices.end()) {
+            logFunction(stonky::LogSeverity::Info, fmt::format("BTCUSDT bid: {}, ask: {}", it->second.bidPrice, it->second.askPrice));
+        }
+
+        logFunction(stonky::LogSeverity::Info, fmt::format("Tickers: {}, book tickers: {}", tickerPrices.size(), bookTickerPrices.size()));
+    } catch (std::exception &e) {
+        logFunction(stonky::LogSeverity::Info, fmt::format("Exception: {}", e.what()));
+    }
+}
+
+void testIncomeLedger() {
+    const auto [fst, snd] = readCredentials();
+    const auto restClient = std::make_shared<futures::RESTClient>(fst, snd);
+
+    try {
+        const auto nowTimestamp = std::chrono::seconds(std::time(nullptr)).count() * 1000;
+        const futures::IncomeLedger ledger(restClient, "income_ledger.jsonl");
+        const auto numNewRecords = ledger.sync(nowTimestamp - 30LL * HISTORY_LENGTH_IN_MS);
+        logFunction(stonky::LogSeverity::Info, fmt::format("New income records: {}", numNewRecords));
+
+        for (const auto &[symbol, incomes]: ledger.aggregate(nowTimestamp - HISTORY_LENGTH_IN_MS, nowTimestamp)) {
+            for (const auto &[incomeType, income]: incomes) {
+                logFunction(stonky::LogSeverity::Info, fmt::format("{} {}: {}", symbol, magic_enum::enum_name(incomeType), income));
+            }
+        }
+    } catch (std::exception &e) {
+        logFunction(stonky::LogSeverity::Info, fmt::format("Exception: {}", e.what()));
+    }
+}
+
+/**
+ * Roll the connection over every 30 s, frames of the array stream received by both connections must be delivered once
+ */
+void testRolloverArrayStream() {
+    boost::asio::io_context ioContext;
+    boost::asio::ssl::context ctx(boost::asio::ssl::context::sslv23_client);
+    const auto session = std::make_shared<futures::WebSocketSession>(ioContext, ctx, logFunction);
+    std::map<std::int64_t, int> numFrames;
+
+    session->setRollover(nullptr, 30s);
+    session->run("fstream.binance.com", "443", "/stream?streams=!markPrice@arr@1s", [&](const nlohmann::json &msg) {
+        numFrames[msg["data"].front()["E"].get<std::int64_t>()]++;
+    });
+
+    std::thread ioThread([&ioContext] {
+        ioContext.run();
+    });
+
+    std::this_thread::sleep_for(75s);
+    session->close();
+    std::this_thread::sleep_for(1s);
+    ioContext.stop();
+    ioThread.join();
+
+    for (const auto &[eventTime, count]: numFrames) {
+        if (count > 1) {
+            logFunction(stonky::LogSeverity::Error, fmt::format("Event time {} delivered {} times", eventTime, count));
+        }
+    }
+
+    logFunction(stonky::LogSeverity::Info, fmt::format("Array frames received: {}", numFrames.size()));
+}
+
+void checkResult(const bool result, const std::string &what) {
+    logFunction(result ? stonky::LogSeverity::Info : stonky::LogSeverity::Error,
+                fmt::format("{}: {}", what, result ? "OK" : "FAILED"));
+}
+
+futures::EventDepthUpdate depthUpdate(const std::int64_t U, const std::int64_t u, const std::int64_t pu,
+                                      std::vector<futures::OrderBookLevel> b, std::vector<futures::OrderBookLevel> a) {
+    futures::EventDepthUpdate retVal;
+    retVal.s = "BTCUSDT";
+    retVal.E = u;
+    retVal.U = U;
+    retVal.u = u;
+    retVal.pu = pu;
+    retVal.b = std::move(b);
+    retVal.a = std::move(a);
+    return retVal;
+}
+
+/**
+ * Offline test of the U/u/pu sequencing of the local order book on synthetic snapshots and diff events
+ */
+void testOrderBook() {
+    futures::OrderBook book("BTCUSDT");
+
+    /// Events of the stream buffered before the snapshot, the first one is older than the snapshot
+    checkResult(!book.applyUpdate(depthUpdate(95, 99, 94, {{100.0, 5.0}}, {})), "First event requests a snapshot");
+    checkResult(book.applyUpdate(depthUpdate(100, 105, 99, {{100.0, 0.0}, {99.5, 4.0}}, {{101.0, 2.0}})),
+                "Next event is buffered");
+    checkResult(book.applyUpdate(depthUpdate(106, 110, 105, {}, {{100.5, 1.0}})), "Next event is buffered");
+    checkResult(!book.synced(), "Book is not synced without a snapshot");
+
+    futures::OrderBookSnapshot snapshot;
+    snapshot.lastUpdateId = 102;
+    snapshot.bids = {{100.0, 1.0}, {99.0, 2.0}};
+    snapshot.asks = {{101.0, 1.0}, {102.0, 3.0}};
+
+    /// The event older than the snapshot is dropped, the next one spans lastUpdateId
+    checkResult(book.applySnapshot(snapshot), "Snapshot connects to the buffered events");
+    checkResult(book.synced() && book.lastUpdateId() == 110, "Buffered events are applied");
+    checkResult(book.bestBid() && *book.bestBid() == futures::OrderBookLevel{99.5, 4.0}, "Best bid after buffered events");
+    checkResult(book.bestAsk() && *book.bestAsk() == futures::OrderBookLevel{100.5, 1.0}, "Best ask after buffered events");
+    checkResult(book.askQuantity(101.0) == 2.0 && book.bidQuantity(100.0) == 0.0, "Levels updated and removed");
+
+    checkResult(book.applyUpdate(depthUpdate(111, 115, 110, {{99.8, 1.0}}, {})), "Continuing event is applied");
+    checkResult(book.bestBid() && *book.bestBid() == futures::OrderBookLevel{99.8, 1.0}, "Best bid after live event");
+    checkResult(book.applyUpdate(depthUpdate(111, 115, 110, {{99.8, 7.0}}, {})), "Repeated event is ignored");
+    checkResult(book.bidQuantity(99.8) == 1.0, "Repeated event does not change the book");
+
+    /// Event of u 120 is lost, pu of the next one breaks the sequence
+    checkResult(!book.applyUpdate(depthUpdate(121, 125, 120, {{99.0, 5.0}}, {})), "Gap requests a snapshot");
+    checkResult(!book.synced() && !book.bestBid() && !book.bestAsk(), "Gap unsyncs the book");
+    checkResult(book.applyUpdate(depthUpdate(126, 130, 125, {}, {{101.0, 0.0}, {102.0, 2.0}})),
+                "Event after the gap is buffered");
+
+    snapshot.lastUpdateId = 123;
+    snapshot.bids = {{99.0, 1.0}};
+    snapshot.asks = {{101.0, 1.0}};
+
+    checkResult(book.applySnapshot(snapshot), "Resync by a new snapshot");
+    checkResult(book.synced() && book.lastUpdateId() == 130, "Events after the gap are applied");
+    checkResult(book.bestBid() && *book.bestBid() == futures::OrderBookLevel{99.0, 5.0}, "Best bid after resync");
+    checkResult(book.bestAsk() && *book.bestAsk() == futures::OrderBookLevel{102.0, 2.0}, "Best ask after resync");
+
+    /// The first buffered event starts after the snapshot, the snapshot is too old
+    book.reset();
+    checkResult(!book.applyUpdate(depthUpdate(131, 135, 130, {{99.0, 1.0}}, {})), "Reset book requests a snapshot");
+    snapshot.lastUpdateId = 128;
+    checkResult(!book.applySnapshot(snapshot) && !book.synced(), "Snapshot older than the first event is rejected");
+}
+
+/**
+ * Offline test of the trade ring buffer: wraparound, latest trades and window statistics against a recomputation
+ */
+void testTradeBuffer() {
+    const futures::TradeBuffer buffer(10);
+    std::vector<futures::PodEventAggregatedTrade> trades;
+
+    for (int i = 0; i < 40; i++) {
+        futures::PodEventAggregatedTrade trade;
+        trade.T = 1000 + i * 10;
+        trade.a = i;
+        trade.p = 100.0 + i % 7;
+        trade.q = 1.0 + (i % 3) * 0.5;
+        trades.push_back(trade);
+        buffer.push(trade);
+    }
+
+    checkResult(buffer.capacity() == 16, "Capacity is rounded up to a power of two");
+    checkResult(buffer.size() == trades.size(), "Pushed trades are counted");
+
+    const auto latest = buffer.latest(5);
+    checkResult(latest.size() == 5 && latest.front().a == 35 && latest.back().a == 39, "Latest trades, the oldest first");
+    checkResult(buffer.latest(100).size() == buffer.capacity(), "Only capacity trades are kept");
+
+    for (const auto firstTrade: {39, 30, 25}) {
+        double volume = 0.0;
+        double quoteVolume = 0.0;
+
+        for (std::size_t i = firstTrade; i < trades.size(); i++) {
+            volume += trades[i].q;
+            quoteVolume += trades[i].p * trades[i].q;
+        }
+
+        const auto statistics = buffer.statistics(trades[firstTrade].T);
+        checkResult(statistics.count == static_cast<std::int64_t>(trades.size()) - firstTrade
+                    && std::abs(statistics.volume - volume) < 1e-9
+                    && std::abs(statistics.vwap - quoteVolume / volume) < 1e-9
+                    && statistics.complete, fmt::format("Statistics of the window from trade {}", firstTrade));
+    }
+
+    /// The window starts before the oldest kept trade
+    const auto statistics = buffer.statistics(trades.front().T);
+    checkResult(!statistics.complete && statistics.count == static_cast<std::int64_t>(buffer.capacity()),
+                "Window with overwritten trades is incomplete");
+    checkResult(buffer.statistics(trades.back().T + 1).count == 0, "Window after the latest trade is empty");
+}
+
 int main() {
+    testOrderBook();
+    testTradeBuffer();
     testBinance();
+    // testRolloverArrayStream();
     // testWsManagerCandles();
     // testCandlesLimits();
     // testRisk();
     // measureRestResponses();
     // testFRMulti();
     //testAccountBalance();
+    // testTickerPrices();
+    // testIncomeLedger();
     return getchar();
 }